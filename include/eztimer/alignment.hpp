@@ -0,0 +1,202 @@
+#ifndef EZTIMER_ALIGNMENT_HPP
+#define EZTIMER_ALIGNMENT_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <functional>
+
+#include "eztimer.hpp"
+
+/**
+ * @file alignment.hpp
+ * @brief Sweep over the alignment of input buffers.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Options for `time_alignments()`.
+ */
+struct AlignmentOptions {
+    /**
+     * Byte offsets at which to place each buffer, relative to the start of a page.
+     * Small offsets probe misalignment within a cache line, while offsets near `page_size` cause each buffer to straddle a page boundary.
+     */
+    std::vector<std::size_t> offsets { 0, 8, 16, 32, 64, 2048, 4064 };
+
+    /**
+     * Size of a page in bytes.
+     * This should be a power of two.
+     */
+    std::size_t page_size = 4096;
+
+    /**
+     * Further options to pass to `time()`.
+     */
+    Options timing;
+};
+
+/**
+ * @brief Timings for each function at each alignment.
+ */
+struct AlignmentTimings {
+    /**
+     * Byte offsets that were tested, copied from `AlignmentOptions::offsets`.
+     */
+    std::vector<std::size_t> offsets;
+
+    /**
+     * Timings for each offset (outer vector, same length as `offsets`) and each function (inner vector).
+     */
+    std::vector<std::vector<Timings> > timings;
+
+    /**
+     * For each function, the index of the entry of `offsets` with the lowest mean runtime.
+     */
+    std::vector<std::size_t> best;
+
+    /**
+     * For each function, the index of the entry of `offsets` with the highest mean runtime.
+     */
+    std::vector<std::size_t> worst;
+
+    /**
+     * For each function, the ratio of the mean runtime at the `worst` offset to that at the `best` offset.
+     * Values well above 1 indicate that the function is sensitive to the alignment of its inputs.
+     */
+    std::vector<double> sensitivity;
+};
+
+/**
+ * Time functions on copies of the input buffers that are placed at different byte offsets relative to page (and thus cache line) boundaries.
+ * All combinations of offsets and functions are timed in a single call to `time()`, so each offset is subject to the same randomized execution order.
+ *
+ * @param buffers Vector of buffers to be used as inputs.
+ * Each entry contains a pointer to the start of the buffer and its size in bytes.
+ * The contents of each buffer are copied into the re-placed buffers before any timing is performed.
+ * @param funs Vector of functions to be timed.
+ * Each function accepts a vector of pointers to the re-placed buffers, in the same order as `buffers`.
+ * Functions may modify the contents of the re-placed buffers, though they are not restored between iterations.
+ * @param check Function that accepts a `Result_` and an index of `funs`, see `time()` for details.
+ * @param opt Further options.
+ *
+ * @return Timings for each function at each offset.
+ *
+ * @tparam Result_ Result of each function call.
+ */
+template<typename Result_>
+AlignmentTimings time_alignments(
+    const std::vector<std::pair<const void*, std::size_t> >& buffers,
+    const std::vector<std::function<Result_(const std::vector<void*>&)> >& funs,
+    const std::function<void(const Result_&, std::size_t)>& check,
+    const AlignmentOptions& opt
+) {
+    const auto nfun = funs.size();
+    const auto noff = opt.offsets.size();
+    const auto page = opt.page_size;
+
+    // Each buffer starts on its own page, so the offset is the only thing
+    // that differs between the copies of the same buffer.
+    std::size_t max_offset = 0;
+    for (auto o : opt.offsets) {
+        max_offset = std::max(max_offset, o);
+    }
+    std::vector<std::size_t> starts;
+    starts.reserve(buffers.size());
+    std::size_t per_offset = 0;
+    for (const auto& buf : buffers) {
+        starts.push_back(per_offset);
+        const std::size_t required = buf.second + max_offset;
+        per_offset += (required + page - 1) / page * page;
+    }
+
+    std::vector<std::vector<unsigned char> > storage(noff);
+    std::vector<std::vector<void*> > placed(noff);
+    for (std::size_t o = 0; o < noff; ++o) {
+        auto& store = storage[o];
+        store.resize(per_offset + page);
+        const auto raw = reinterpret_cast<std::uintptr_t>(store.data());
+        const auto aligned = (raw + page - 1) / page * page;
+        auto base = store.data() + (aligned - raw);
+
+        auto& curplaced = placed[o];
+        curplaced.reserve(buffers.size());
+        for (std::size_t b = 0; b < buffers.size(); ++b) {
+            auto ptr = base + starts[b] + opt.offsets[o];
+            if (buffers[b].second) {
+                std::memcpy(ptr, buffers[b].first, buffers[b].second);
+            }
+            curplaced.push_back(ptr);
+        }
+    }
+
+    std::vector<std::function<Result_()> > wrapped;
+    wrapped.reserve(noff * nfun);
+    for (std::size_t o = 0; o < noff; ++o) {
+        const auto& curplaced = placed[o];
+        for (std::size_t f = 0; f < nfun; ++f) {
+            const auto& curfun = funs[f];
+            wrapped.emplace_back([&curfun, &curplaced]() -> Result_ { return curfun(curplaced); });
+        }
+    }
+
+    auto timings = time<Result_>(
+        wrapped,
+        [&](const Result_& res, std::size_t i) -> void { check(res, i % nfun); },
+        opt.timing
+    );
+
+    AlignmentTimings output;
+    output.offsets = opt.offsets;
+    output.timings.resize(noff);
+    auto tIt = timings.begin();
+    for (std::size_t o = 0; o < noff; ++o) {
+        auto& current = output.timings[o];
+        current.insert(current.end(), std::make_move_iterator(tIt), std::make_move_iterator(tIt + nfun));
+        tIt += nfun;
+    }
+
+    output.best.resize(nfun);
+    output.worst.resize(nfun);
+    output.sensitivity.resize(nfun, 1);
+    for (std::size_t f = 0; f < nfun; ++f) {
+        bool found = false;
+        for (std::size_t o = 0; o < noff; ++o) {
+            const auto& current = output.timings[o][f];
+            if (current.times.empty()) {
+                continue;
+            }
+            if (!found) {
+                output.best[f] = o;
+                output.worst[f] = o;
+                found = true;
+                continue;
+            }
+            if (current.mean < output.timings[output.best[f]][f].mean) {
+                output.best[f] = o;
+            }
+            if (current.mean > output.timings[output.worst[f]][f].mean) {
+                output.worst[f] = o;
+            }
+        }
+
+        if (found) {
+            const auto& best = output.timings[output.best[f]][f].mean;
+            const auto& worst = output.timings[output.worst[f]][f].mean;
+            if (best.count() > 0) {
+                output.sensitivity[f] = worst / best;
+            }
+        }
+    }
+
+    return output;
+}
+
+}
+
+#endif
@@ -0,0 +1,189 @@
+#ifndef EZTIMER_ALLOCATORS_HPP
+#define EZTIMER_ALLOCATORS_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <algorithm>
+
+#include "eztimer.hpp"
+#include "process.hpp"
+#include "compare.hpp"
+
+/**
+ * @file allocators.hpp
+ * @brief Compare memory allocators by preloading them into child processes.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Options for `compare_allocators()`.
+ */
+struct AllocatorOptions {
+    /**
+     * Name of the environment variable used to preload each allocator library.
+     */
+#ifdef __APPLE__
+    std::string preload_variable = "DYLD_INSERT_LIBRARIES";
+#else
+    std::string preload_variable = "LD_PRELOAD";
+#endif
+
+    /**
+     * Further options to pass to `time_processes()`.
+     * Each iteration runs the command once with each allocator, in random order.
+     */
+    ProcessOptions process;
+
+    /**
+     * Further options to pass to `compare_paired()`.
+     */
+    CompareOptions compare;
+};
+
+/**
+ * @brief Comparison of timings and memory usage across allocators.
+ *
+ * In all vectors indexed by allocator, the first entry corresponds to the default allocator (i.e., without any preloading),
+ * and the subsequent entries correspond to the allocators in the same order as supplied to `compare_allocators()`.
+ */
+struct AllocatorComparison {
+    /**
+     * Path to each allocator library.
+     * The first entry is an empty string for the default allocator.
+     */
+    std::vector<std::string> allocators;
+
+    /**
+     * Output of `time_processes()`, where each command corresponds to an allocator.
+     */
+    ProcessTimings processes;
+
+    /**
+     * Names of the functions reported by the child processes with `report_to_parent()`, in order of first appearance.
+     */
+    std::vector<std::string> functions;
+
+    /**
+     * Timings for each allocator (outer vector) and each function in `functions` (inner vector).
+     */
+    std::vector<std::vector<Timings> > timings;
+
+    /**
+     * Comparison of each allocator (outer vector) against the default for each function in `functions` (inner vector).
+     * The first inner vector compares the default allocator against itself and is included for convenience.
+     */
+    std::vector<std::vector<Comparison> > comparisons;
+
+    /**
+     * Speedup of each allocator (outer vector) over the default for each function in `functions` (inner vector).
+     * This is the reciprocal of `Comparison::ratio` in `comparisons`, so values above 1 indicate that the allocator is faster.
+     */
+    std::vector<std::vector<double> > speedups;
+
+    /**
+     * Comparison of the total time of each child process under each allocator against the default.
+     */
+    std::vector<Comparison> overall;
+
+    /**
+     * Mean of the maximum resident set size (in kilobytes) across runs for each allocator.
+     */
+    std::vector<double> max_rss;
+
+    /**
+     * Mean number of minor page faults per run for each allocator.
+     */
+    std::vector<double> minor_faults;
+};
+
+/**
+ * Compare memory allocators by running a benchmark executable with each allocator library preloaded.
+ * All runs are interleaved in random order within each iteration, as described in `time_processes()`.
+ * Per-function results are only available if the executable reports its timings with `report_to_parent()`.
+ *
+ * @param command Command to run the benchmark executable.
+ * @param allocators Paths to the allocator libraries, e.g., jemalloc or mimalloc.
+ * Each library replaces any existing value of `AllocatorOptions::preload_variable` in the environment.
+ * For the default allocator, this variable is set to an empty string, ignoring any value in `command` or the parent's environment.
+ * @param opt Further options.
+ *
+ * @return Timings and memory usage for each allocator.
+ */
+inline AllocatorComparison compare_allocators(const Command& command, const std::vector<std::string>& allocators, const AllocatorOptions& opt) {
+    AllocatorComparison output;
+    output.allocators.reserve(allocators.size() + 1);
+    output.allocators.emplace_back();
+    output.allocators.insert(output.allocators.end(), allocators.begin(), allocators.end());
+    const auto nalloc = output.allocators.size();
+
+    // The default allocator explicitly sets an empty preload variable, so
+    // that it is not affected by any value inherited from the parent.
+    std::vector<Command> commands(nalloc, command);
+    for (std::size_t a = 0; a < nalloc; ++a) {
+        auto& env = commands[a].environment;
+        env.erase(
+            std::remove_if(env.begin(), env.end(), [&](const auto& x) -> bool { return x.first == opt.preload_variable; }),
+            env.end()
+        );
+        env.emplace_back(opt.preload_variable, output.allocators[a]);
+    }
+
+    output.processes = time_processes(commands, opt.process);
+
+    for (const auto& curruns : output.processes.runs) {
+        for (const auto& run : curruns) {
+            for (const auto& rep : run.reported) {
+                if (std::find(output.functions.begin(), output.functions.end(), rep.first) == output.functions.end()) {
+                    output.functions.push_back(rep.first);
+                }
+            }
+        }
+    }
+    const auto nfun = output.functions.size();
+
+    output.timings.resize(nalloc);
+    output.comparisons.resize(nalloc);
+    output.speedups.resize(nalloc);
+    output.overall.reserve(nalloc);
+    output.max_rss.resize(nalloc);
+    output.minor_faults.resize(nalloc);
+
+    for (std::size_t a = 0; a < nalloc; ++a) {
+        auto& curtimings = output.timings[a];
+        curtimings.reserve(nfun);
+        for (const auto& fun : output.functions) {
+            curtimings.push_back(reported_timings(output.processes, a, fun));
+        }
+
+        const auto& curruns = output.processes.runs[a];
+        if (!curruns.empty()) {
+            double rss = 0, faults = 0;
+            for (const auto& run : curruns) {
+                rss += run.max_rss;
+                faults += run.minor_faults;
+            }
+            output.max_rss[a] = rss / curruns.size();
+            output.minor_faults[a] = faults / curruns.size();
+        }
+    }
+
+    for (std::size_t a = 0; a < nalloc; ++a) {
+        auto& curcomp = output.comparisons[a];
+        auto& curspeed = output.speedups[a];
+        curcomp.reserve(nfun);
+        curspeed.reserve(nfun);
+        for (std::size_t f = 0; f < nfun; ++f) {
+            curcomp.push_back(compare_paired(output.timings[0][f], output.timings[a][f], opt.compare));
+            curspeed.push_back(1 / curcomp.back().ratio);
+        }
+        output.overall.push_back(compare_paired(output.processes.timings[0], output.processes.timings[a], opt.compare));
+    }
+
+    return output;
+}
+
+}
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef EZTIMER_ATTRIBUTION_HPP
+#define EZTIMER_ATTRIBUTION_HPP
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include "eztimer.hpp"
+
+/**
+ * @file attribution.hpp
+ * @brief Attribute variance in timings to event counters.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Attribution of the variance in a function's timings to its event counters.
+ *
+ * All vectors are parallel to `Timings::counters`.
+ * Entries are set to NaN for counters that are unavailable, constant across calls, or collinear with other counters.
+ */
+struct CounterAttribution {
+    /**
+     * Number of calls used in the regression.
+     */
+    std::size_t samples = 0;
+
+    /**
+     * Marginal cost of each event in seconds, i.e., the coefficient for each counter in a multiple regression of the per-call time on all counters.
+     * For example, if the counter is `Counter::CACHE_MISSES`, this is the time per LLC miss after accounting for the other counters.
+     */
+    std::vector<double> marginal_cost;
+
+    /**
+     * Proportion of variance in the per-call time that is explained by each counter on its own, i.e., the squared correlation.
+     */
+    std::vector<double> r_squared;
+
+    /**
+     * Intercept of the multiple regression, i.e., the predicted time of a call with no events, in seconds.
+     */
+    double intercept = std::numeric_limits<double>::quiet_NaN();
+
+    /**
+     * Proportion of variance in the per-call time that is explained by all counters in the multiple regression.
+     */
+    double total_r_squared = std::numeric_limits<double>::quiet_NaN();
+};
+
+/**
+ * Regress the time of each call on the event counts for the same call, to determine which events explain the variance in the timings.
+ * This requires `Options::counters` to be set when calling `time()`.
+ * The multiple regression is fitted by ordinary least squares with a QR decomposition, skipping any counter that is linearly dependent on the preceding counters.
+ *
+ * @param timings Timings for a function, typically from `time()`.
+ *
+ * @return Attribution of the variance to each counter.
+ */
+inline CounterAttribution attribute_counters(const Timings& timings) {
+    const auto ncounters = timings.counters.size();
+    const auto n = timings.times.size();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    CounterAttribution output;
+    output.samples = n;
+    output.marginal_cost.resize(ncounters, nan);
+    output.r_squared.resize(ncounters, nan);
+    if (n < 2) {
+        return output;
+    }
+
+    std::vector<double> y;
+    y.reserve(n);
+    double ymean = 0;
+    for (auto t : timings.times) {
+        y.push_back(t.count());
+        ymean += t.count();
+    }
+    ymean /= n;
+    double yss = 0;
+    for (auto& val : y) {
+        val -= ymean;
+        yss += val * val;
+    }
+
+    // Centering each counter, which removes the need for an explicit intercept column.
+    std::vector<std::size_t> usable;
+    std::vector<std::vector<double> > columns;
+    std::vector<double> means;
+    for (std::size_t c = 0; c < ncounters; ++c) {
+        const auto& current = timings.counters[c];
+        if (current.size() != n) {
+            continue;
+        }
+
+        std::vector<double> col(current.begin(), current.end());
+        double mean = 0;
+        for (auto x : col) {
+            mean += x;
+        }
+        mean /= n;
+        double ss = 0, sp = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            col[i] -= mean;
+            ss += col[i] * col[i];
+            sp += col[i] * y[i];
+        }
+        if (ss == 0) {
+            continue;
+        }
+
+        output.r_squared[c] = (yss > 0 ? sp * sp / (ss * yss) : 0);
+        usable.push_back(c);
+        columns.push_back(std::move(col));
+        means.push_back(mean);
+    }
+
+    // Modified Gram-Schmidt, skipping columns that are (nearly) collinear with previous ones.
+    const auto nusable = usable.size();
+    std::vector<std::vector<double> > q;
+    std::vector<std::size_t> kept;
+    std::vector<std::vector<double> > r(nusable, std::vector<double>(nusable));
+    for (std::size_t j = 0; j < nusable; ++j) {
+        auto v = columns[j];
+        double original = 0;
+        for (auto x : v) {
+            original += x * x;
+        }
+
+        for (std::size_t k = 0; k < kept.size(); ++k) {
+            double proj = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                proj += q[k][i] * v[i];
+            }
+            r[k][j] = proj;
+            for (std::size_t i = 0; i < n; ++i) {
+                v[i] -= proj * q[k][i];
+            }
+        }
+
+        double norm = 0;
+        for (auto x : v) {
+            norm += x * x;
+        }
+        if (norm <= 1e-20 * original || kept.size() + 1 >= n) {
+            continue;
+        }
+
+        norm = std::sqrt(norm);
+        for (auto& x : v) {
+            x /= norm;
+        }
+        r[kept.size()][j] = norm;
+        q.push_back(std::move(v));
+        kept.push_back(j);
+    }
+
+    // Solving R * b = Q^T y by back-substitution over the kept columns.
+    const auto nkept = kept.size();
+    std::vector<double> z(nkept);
+    double explained = 0;
+    for (std::size_t k = 0; k < nkept; ++k) {
+        double proj = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            proj += q[k][i] * y[i];
+        }
+        z[k] = proj;
+        explained += proj * proj;
+    }
+
+    std::vector<double> coef(nkept);
+    for (std::size_t k = nkept; k > 0; --k) {
+        const auto row = k - 1;
+        double val = z[row];
+        for (std::size_t l = k; l < nkept; ++l) {
+            val -= r[row][kept[l]] * coef[l];
+        }
+        coef[row] = val / r[row][kept[row]];
+    }
+
+    output.intercept = ymean;
+    for (std::size_t k = 0; k < nkept; ++k) {
+        const auto j = kept[k];
+        output.marginal_cost[usable[j]] = coef[k];
+        output.intercept -= coef[k] * means[j];
+    }
+    output.total_r_squared = (yss > 0 ? explained / yss : 0);
+
+    return output;
+}
+
+}
+
+#endif
@@ -0,0 +1,317 @@
+#ifndef EZTIMER_CALIBRATION_HPP
+#define EZTIMER_CALIBRATION_HPP
+
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <optional>
+#include <numeric>
+#include <functional>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+
+#include "eztimer.hpp"
+
+/**
+ * @file calibration.hpp
+ * @brief Normalize timings against reference kernels.
+ */
+
+namespace eztimer {
+
+/**
+ * Reference kernels for calibration.
+ *
+ * - `INTEGER`: a dependent chain of xorshift operations on a 64-bit integer.
+ * - `FLOATING_POINT`: independent chains of double-precision multiply-adds.
+ * - `MEMORY_LATENCY`: a pointer chase through a random cycle in a large buffer.
+ * - `MEMORY_BANDWIDTH`: a sequential sum over a large buffer.
+ */
+enum class ReferenceKernel {
+    INTEGER,
+    FLOATING_POINT,
+    MEMORY_LATENCY,
+    MEMORY_BANDWIDTH
+};
+
+/**
+ * @brief Options for `time_calibrated()`.
+ */
+struct CalibrationOptions {
+    /**
+     * Reference kernels to time alongside the user's functions.
+     */
+    std::vector<ReferenceKernel> kernels { ReferenceKernel::INTEGER, ReferenceKernel::FLOATING_POINT, ReferenceKernel::MEMORY_LATENCY, ReferenceKernel::MEMORY_BANDWIDTH };
+
+    /**
+     * Number of operations for `ReferenceKernel::INTEGER` and `ReferenceKernel::FLOATING_POINT`.
+     */
+    std::size_t operations = 1 << 22;
+
+    /**
+     * Size of the buffer for `ReferenceKernel::MEMORY_LATENCY` and `ReferenceKernel::MEMORY_BANDWIDTH`, in bytes.
+     * This should be larger than the last-level cache.
+     */
+    std::size_t buffer_size = 64 << 20;
+
+    /**
+     * Number of loads for `ReferenceKernel::MEMORY_LATENCY`.
+     */
+    std::size_t loads = 1 << 18;
+
+    /**
+     * Seed for the random number generator used to create the pointer chase.
+     */
+    unsigned long long seed = 987654;
+
+    /**
+     * Further options to pass to `time()`.
+     */
+    Options timing;
+};
+
+/**
+ * @brief Timings for the user's functions, normalized against reference kernels.
+ */
+struct CalibratedTimings {
+    /**
+     * Timings for each of the user's functions.
+     */
+    std::vector<Timings> timings;
+
+    /**
+     * Reference kernels, as specified in `CalibrationOptions::kernels`.
+     */
+    std::vector<ReferenceKernel> kernels;
+
+    /**
+     * Timings for each reference kernel in `kernels`, interleaved with the user's functions in the same calls to `time()`.
+     */
+    std::vector<Timings> reference;
+
+    /**
+     * Reference unit, defined as the geometric mean of the mean times of all reference kernels.
+     */
+    std::chrono::duration<double> reference_unit = std::chrono::duration<double>(0);
+
+    /**
+     * Mean time of each of the user's functions, in reference units.
+     * This is more comparable across machines than the time in seconds.
+     */
+    std::vector<double> normalized;
+
+    /**
+     * Mean time of each of the user's functions relative to that of each reference kernel.
+     * Each inner vector corresponds to a user function and is parallel to `kernels`.
+     * This is useful for determining which aspect of the machine (e.g., memory bandwidth) best predicts the function's runtime across machines.
+     */
+    std::vector<std::vector<double> > relative;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+// Sattolo's algorithm, which yields a single cycle through all elements so
+// that the pointer chase visits the entire buffer.
+inline std::vector<std::size_t> random_cycle(std::size_t n, std::mt19937_64& rng) {
+    std::vector<std::size_t> output(n);
+    std::iota(output.begin(), output.end(), static_cast<std::size_t>(0));
+    for (std::size_t i = n; i > 1; --i) {
+        std::uniform_int_distribution<std::size_t> dist(0, i - 2);
+        std::swap(output[i - 1], output[dist(rng)]);
+    }
+    return output;
+}
+
+inline std::size_t pointer_chase(const std::vector<std::size_t>& cycle, std::size_t loads) {
+    std::size_t current = 0;
+    for (std::size_t l = 0; l < loads; ++l) {
+        current = cycle[current];
+    }
+    return current;
+}
+
+inline std::uint64_t integer_kernel(std::size_t operations) {
+    std::uint64_t x = 88172645463325252ull;
+    for (std::size_t i = 0; i < operations; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+    return x;
+}
+
+inline double floating_point_kernel(std::size_t operations) {
+    double a0 = 1, a1 = 2, a2 = 3, a3 = 4;
+    const double mult = 0.999999, add = 1e-7;
+    for (std::size_t i = 0; i < operations; i += 4) {
+        a0 = a0 * mult + add;
+        a1 = a1 * mult + add;
+        a2 = a2 * mult + add;
+        a3 = a3 * mult + add;
+    }
+    return a0 + a1 + a2 + a3;
+}
+
+inline std::uint64_t bandwidth_kernel(const std::vector<std::uint64_t>& buffer) {
+    std::uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    const auto n = buffer.size();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += buffer[i];
+        s1 += buffer[i + 1];
+        s2 += buffer[i + 2];
+        s3 += buffer[i + 3];
+    }
+    for (; i < n; ++i) {
+        s0 += buffer[i];
+    }
+    return s0 + s1 + s2 + s3;
+}
+
+inline std::function<std::uint64_t()> reference_kernel(ReferenceKernel kernel, const CalibrationOptions& opt, std::mt19937_64& rng) {
+    switch (kernel) {
+        case ReferenceKernel::INTEGER:
+            return [ops = opt.operations]() -> std::uint64_t { return integer_kernel(ops); };
+
+        case ReferenceKernel::FLOATING_POINT:
+            return [ops = opt.operations]() -> std::uint64_t { return static_cast<std::uint64_t>(floating_point_kernel(ops)); };
+
+        case ReferenceKernel::MEMORY_LATENCY:
+            {
+                auto cycle = std::make_shared<std::vector<std::size_t> >(random_cycle(std::max(opt.buffer_size / sizeof(std::size_t), static_cast<std::size_t>(1)), rng));
+                return [cycle, loads = opt.loads]() -> std::uint64_t { return pointer_chase(*cycle, loads); };
+            }
+
+        default:
+            {
+                auto buffer = std::make_shared<std::vector<std::uint64_t> >(opt.buffer_size / sizeof(std::uint64_t));
+                std::iota(buffer->begin(), buffer->end(), static_cast<std::uint64_t>(0));
+                return [buffer]() -> std::uint64_t { return bandwidth_kernel(*buffer); };
+            }
+    }
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Time the user's functions alongside a suite of reference kernels, and report the former's runtimes in reference units.
+ * Results from different machines can then be compared or merged by their normalized times, which are less dependent on the machine's overall speed.
+ * The reference kernels are included in the same randomized schedule as the user's functions in `time()`, so any drift in machine performance affects both equally.
+ * If `Result_` is default-constructible, the user's functions are passed to `time()` without any wrapping, so they are timed exactly as in an uncalibrated run.
+ * Otherwise, each result is wrapped in a `std::optional`, which adds a move to each timed call.
+ *
+ * @param funs Vector of functions to be timed, see `time()` for details.
+ * @param check Function that accepts a `Result_` and an index of `funs`, see `time()` for details.
+ * This is not called for the reference kernels.
+ * @param opt Further options.
+ *
+ * @return Timings for the user's functions and the reference kernels, along with the normalized times.
+ *
+ * @tparam Result_ Result of each function call.
+ */
+template<typename Result_>
+CalibratedTimings time_calibrated(
+    const std::vector<std::function<Result_()> >& funs,
+    const std::function<void(const Result_&, std::size_t)>& check,
+    const CalibrationOptions& opt
+) {
+    const auto nfun = funs.size();
+    const auto nkernels = opt.kernels.size();
+
+    // Storing the kernel results in a volatile sink, so that the compiler
+    // can't optimize away their computation.
+    volatile std::uint64_t sink = 0;
+    std::mt19937_64 rng(opt.seed);
+    std::vector<std::function<std::uint64_t()> > kernels;
+    kernels.reserve(nkernels);
+    for (auto k : opt.kernels) {
+        kernels.push_back(internal::reference_kernel(k, opt, rng));
+    }
+
+    std::vector<Timings> timings;
+    if constexpr (std::is_default_constructible<Result_>::value) {
+        // The user's functions are passed to time() as-is, so their results
+        // are handled exactly as in an uncalibrated run.
+        std::vector<std::function<Result_()> > all(funs);
+        all.reserve(nfun + nkernels);
+        for (auto& kernel : kernels) {
+            all.emplace_back([kernel = std::move(kernel), &sink]() -> Result_ {
+                sink = kernel();
+                return Result_();
+            });
+        }
+        timings = time<Result_>(
+            all,
+            [&](const Result_& res, std::size_t i) -> void {
+                if (i < nfun) {
+                    check(res, i);
+                }
+            },
+            opt.timing
+        );
+
+    } else {
+        // Otherwise, the kernels have no way of returning a Result_, so all
+        // results are wrapped in an optional at the cost of a move per call.
+        std::vector<std::function<std::optional<Result_>()> > wrapped;
+        wrapped.reserve(nfun + nkernels);
+        for (const auto& f : funs) {
+            wrapped.emplace_back([&f]() -> std::optional<Result_> { return f(); });
+        }
+        for (auto& kernel : kernels) {
+            wrapped.emplace_back([kernel = std::move(kernel), &sink]() -> std::optional<Result_> {
+                sink = kernel();
+                return std::optional<Result_>();
+            });
+        }
+        timings = time<std::optional<Result_> >(
+            wrapped,
+            [&](const std::optional<Result_>& res, std::size_t i) -> void {
+                if (i < nfun) {
+                    check(*res, i);
+                }
+            },
+            opt.timing
+        );
+    }
+
+    CalibratedTimings output;
+    output.kernels = opt.kernels;
+    output.timings.insert(output.timings.end(), std::make_move_iterator(timings.begin()), std::make_move_iterator(timings.begin() + nfun));
+    output.reference.insert(output.reference.end(), std::make_move_iterator(timings.begin() + nfun), std::make_move_iterator(timings.end()));
+
+    double logsum = 0;
+    for (const auto& ref : output.reference) {
+        logsum += std::log(ref.mean.count());
+    }
+    output.reference_unit = std::chrono::duration<double>(nkernels ? std::exp(logsum / nkernels) : 1);
+
+    output.normalized.reserve(nfun);
+    output.relative.reserve(nfun);
+    for (const auto& curtime : output.timings) {
+        output.normalized.push_back(curtime.mean / output.reference_unit);
+        std::vector<double> currel;
+        currel.reserve(nkernels);
+        for (const auto& ref : output.reference) {
+            currel.push_back(curtime.mean / ref.mean);
+        }
+        output.relative.push_back(std::move(currel));
+    }
+
+    return output;
+}
+
+}
+
+#endif
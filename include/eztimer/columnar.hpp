@@ -0,0 +1,713 @@
+#ifndef EZTIMER_COLUMNAR_HPP
+#define EZTIMER_COLUMNAR_HPP
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <optional>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define EZTIMER_HAS_MMAP
+#endif
+
+#include "eztimer.hpp"
+#include "store.hpp"
+#include "probe.hpp"
+
+/**
+ * @file columnar.hpp
+ * @brief Columnar binary format for timings, with a memory-mapped reader.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Options for `write_columnar()`.
+ */
+struct ColumnarOptions {
+    /**
+     * Name of each function.
+     * If empty, functions are named by their index.
+     */
+    std::vector<std::string> names;
+
+    /**
+     * Arbitrary key-value pairs to store in the header, e.g., the commit or the machine fingerprint.
+     */
+    std::vector<std::pair<std::string, std::string> > metadata;
+
+    /**
+     * Events in `Timings::counters`, typically the same as `Options::counters`.
+     * If empty, the counter columns are stored without their identities.
+     */
+    std::vector<Counter> counters;
+
+    /**
+     * Profile of the machine on which the timings were collected.
+     * If supplied, this is stored in the metadata under the `machine_profile` key, in the format of `write_machine_profile()`,
+     * and can be retrieved with `ColumnarReader::profile()`.
+     */
+    std::optional<MachineProfile> profile;
+};
+
+/**
+ * @brief Read-only view of a column in a columnar file.
+ *
+ * This points directly into the memory of `ColumnarReader`, and is only valid for the lifetime of the reader.
+ *
+ * @tparam Type_ Type of the values in the column.
+ */
+template<typename Type_>
+class ColumnView {
+public:
+    /**
+     * @cond
+     */
+    ColumnView() = default;
+
+    ColumnView(const Type_* ptr, std::size_t n) : my_ptr(ptr), my_size(n) {}
+    /**
+     * @endcond
+     */
+
+    /**
+     * @return Pointer to the first value.
+     */
+    const Type_* data() const {
+        return my_ptr;
+    }
+
+    /**
+     * @return Number of values.
+     */
+    std::size_t size() const {
+        return my_size;
+    }
+
+    /**
+     * @return Whether the column is empty.
+     */
+    bool empty() const {
+        return my_size == 0;
+    }
+
+    /**
+     * @param i Index of the value.
+     * @return The `i`-th value.
+     */
+    const Type_& operator[](std::size_t i) const {
+        return my_ptr[i];
+    }
+
+    /**
+     * @return Pointer to the first value.
+     */
+    const Type_* begin() const {
+        return my_ptr;
+    }
+
+    /**
+     * @return Pointer to one past the last value.
+     */
+    const Type_* end() const {
+        return my_ptr + my_size;
+    }
+
+private:
+    const Type_* my_ptr = NULL;
+    std::size_t my_size = 0;
+};
+
+/**
+ * @brief Summary of a function in a columnar file.
+ */
+struct ColumnarSummary {
+    /**
+     * Name of the function.
+     */
+    std::string name;
+
+    /**
+     * Number of runs.
+     */
+    std::uint64_t count = 0;
+
+    /**
+     * Mean time, in seconds.
+     */
+    double mean = 0;
+
+    /**
+     * Standard deviation of the times, in seconds.
+     */
+    double sd = 0;
+
+    /**
+     * Minimum time, in seconds.
+     */
+    double min = 0;
+
+    /**
+     * Maximum time, in seconds.
+     */
+    double max = 0;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+constexpr char columnar_magic[8] = { 'E', 'Z', 'T', 'C', 'O', 'L', '0', '1' };
+
+constexpr const char* columnar_profile_key = "machine_profile";
+
+constexpr std::uint32_t columnar_byte_order = 0x01020304;
+
+static_assert(sizeof(std::chrono::duration<double>) == sizeof(double), "durations should be stored as plain doubles");
+
+struct ColumnExtent {
+    std::uint64_t offset = 0;
+    std::uint64_t length = 0;
+};
+
+struct ColumnarEntry {
+    ColumnarSummary summary;
+    ColumnExtent times, iterations, cpus;
+    std::vector<ColumnExtent> counters;
+};
+
+// Columns are aligned to 8 bytes so that the mapped memory can be accessed
+// directly as doubles and 64-bit integers.
+inline std::uint64_t align_column(std::uint64_t offset) {
+    return (offset + 7) / 8 * 8;
+}
+
+inline std::string serialize_columnar_header(
+    const std::vector<ColumnarEntry>& entries,
+    const std::vector<std::pair<std::string, std::string> >& metadata,
+    const std::vector<std::int32_t>& counter_codes)
+{
+    std::ostringstream out;
+    out.write(columnar_magic, 8);
+    write_binary(out, columnar_byte_order);
+    write_binary(out, static_cast<std::uint32_t>(entries.size()));
+    write_binary(out, static_cast<std::uint32_t>(counter_codes.size()));
+    write_binary(out, static_cast<std::uint32_t>(metadata.size()));
+    for (const auto& meta : metadata) {
+        write_binary(out, meta.first);
+        write_binary(out, meta.second);
+    }
+    for (auto code : counter_codes) {
+        write_binary(out, code);
+    }
+
+    for (const auto& entry : entries) {
+        const auto& summary = entry.summary;
+        write_binary(out, summary.name);
+        write_binary(out, summary.count);
+        write_binary(out, summary.mean);
+        write_binary(out, summary.sd);
+        write_binary(out, summary.min);
+        write_binary(out, summary.max);
+        for (const auto* extent : { &entry.times, &entry.iterations, &entry.cpus }) {
+            write_binary(out, extent->offset);
+            write_binary(out, extent->length);
+        }
+        for (const auto& extent : entry.counters) {
+            write_binary(out, extent.offset);
+            write_binary(out, extent.length);
+        }
+    }
+
+    return out.str();
+}
+
+class ColumnarCursor {
+public:
+    ColumnarCursor(const char* ptr, std::size_t size) : my_ptr(ptr), my_remaining(size) {}
+
+    template<typename Type_>
+    Type_ read() {
+        Type_ output;
+        advance(sizeof(Type_));
+        std::memcpy(&output, my_ptr - sizeof(Type_), sizeof(Type_));
+        return output;
+    }
+
+    std::string read_string() {
+        const auto len = read<std::uint32_t>();
+        advance(len);
+        return std::string(my_ptr - len, len);
+    }
+
+    std::size_t remaining() const {
+        return my_remaining;
+    }
+
+private:
+    void advance(std::size_t n) {
+        if (n > my_remaining) {
+            throw std::runtime_error("truncated header in columnar file");
+        }
+        my_ptr += n;
+        my_remaining -= n;
+    }
+
+    const char* my_ptr;
+    std::size_t my_remaining;
+};
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Write timings to a file in a columnar binary format, for fast loading of large results with `ColumnarReader`.
+ *
+ * The file starts with a header that contains the metadata, the event counters and the summary statistics of each function.
+ * This is followed by the columns of each function, i.e., the times in seconds as doubles, the iteration indices and CPUs as 32-bit integers, and each event counter as 64-bit integers.
+ * Each column is written with a single bulk write and aligned to 8 bytes.
+ * All values are stored in the native byte order, so files can only be read on machines with the same endianness.
+ *
+ * @param path Path to the output file.
+ * This is overwritten if it already exists.
+ * @param timings Timings for each function, typically from `time()`.
+ * @param opt Further options.
+ */
+inline void write_columnar(const std::filesystem::path& path, const std::vector<Timings>& timings, const ColumnarOptions& opt = ColumnarOptions()) {
+    const auto nfun = timings.size();
+    if (!opt.names.empty() && opt.names.size() != nfun) {
+        throw std::runtime_error("length of 'names' should be equal to the number of functions");
+    }
+
+    std::size_t ncounters = opt.counters.size();
+    for (const auto& curtime : timings) {
+        if (opt.counters.empty()) {
+            ncounters = std::max(ncounters, curtime.counters.size());
+        } else if (!curtime.counters.empty() && curtime.counters.size() != ncounters) {
+            throw std::runtime_error("length of 'Timings::counters' should be equal to that of 'counters'");
+        }
+    }
+    std::vector<std::int32_t> counter_codes(ncounters, -1);
+    for (std::size_t c = 0; c < opt.counters.size(); ++c) {
+        counter_codes[c] = static_cast<std::int32_t>(opt.counters[c]);
+    }
+
+    std::vector<internal::ColumnarEntry> entries(nfun);
+    for (std::size_t f = 0; f < nfun; ++f) {
+        const auto& curtime = timings[f];
+        auto& entry = entries[f];
+        auto& summary = entry.summary;
+        summary.name = (opt.names.empty() ? std::to_string(f) : opt.names[f]);
+        summary.count = curtime.times.size();
+        summary.mean = curtime.mean.count();
+        summary.sd = curtime.sd.count();
+        if (!curtime.times.empty()) {
+            auto range = std::minmax_element(curtime.times.begin(), curtime.times.end());
+            summary.min = range.first->count();
+            summary.max = range.second->count();
+        }
+        entry.times.length = curtime.times.size();
+        entry.iterations.length = curtime.iterations.size();
+        entry.cpus.length = curtime.cpus.size();
+        entry.counters.resize(ncounters);
+        for (std::size_t c = 0; c < curtime.counters.size(); ++c) {
+            entry.counters[c].length = curtime.counters[c].size();
+        }
+    }
+
+    auto metadata = opt.metadata;
+    if (opt.profile.has_value()) {
+        std::ostringstream profile;
+        write_machine_profile(profile, *(opt.profile));
+        metadata.emplace_back(internal::columnar_profile_key, profile.str());
+    }
+
+    // The header has a fixed size for a given set of names and metadata,
+    // so we can serialize it once to find where the columns start.
+    std::uint64_t offset = internal::align_column(internal::serialize_columnar_header(entries, metadata, counter_codes).size());
+    auto assign = [&](internal::ColumnExtent& extent, std::size_t width) -> void {
+        extent.offset = offset;
+        offset = internal::align_column(offset + extent.length * width);
+    };
+    for (auto& entry : entries) {
+        assign(entry.times, sizeof(double));
+        assign(entry.iterations, sizeof(std::int32_t));
+        assign(entry.cpus, sizeof(std::int32_t));
+        for (auto& extent : entry.counters) {
+            assign(extent, sizeof(std::int64_t));
+        }
+    }
+
+    std::ofstream handle(path, std::ios::binary | std::ios::trunc);
+    if (!handle) {
+        throw std::runtime_error("failed to open '" + path.string() + "' for writing");
+    }
+
+    const auto header = internal::serialize_columnar_header(entries, metadata, counter_codes);
+    handle.write(header.data(), header.size());
+    std::uint64_t position = header.size();
+    const char padding[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    auto bulk_write = [&](const internal::ColumnExtent& extent, const void* data, std::size_t width) -> void {
+        handle.write(padding, extent.offset - position);
+        handle.write(reinterpret_cast<const char*>(data), extent.length * width);
+        position = extent.offset + extent.length * width;
+    };
+
+    // Narrowing to fixed-width types where the in-memory representation differs.
+    std::vector<std::int32_t> narrowed;
+    std::vector<std::int64_t> widened;
+    for (std::size_t f = 0; f < nfun; ++f) {
+        const auto& curtime = timings[f];
+        const auto& entry = entries[f];
+        bulk_write(entry.times, curtime.times.data(), sizeof(double));
+
+        narrowed.assign(curtime.iterations.begin(), curtime.iterations.end());
+        bulk_write(entry.iterations, narrowed.data(), sizeof(std::int32_t));
+        narrowed.assign(curtime.cpus.begin(), curtime.cpus.end());
+        bulk_write(entry.cpus, narrowed.data(), sizeof(std::int32_t));
+
+        for (std::size_t c = 0; c < ncounters; ++c) {
+            if (c < curtime.counters.size()) {
+                widened.assign(curtime.counters[c].begin(), curtime.counters[c].end());
+            } else {
+                widened.clear();
+            }
+            bulk_write(entry.counters[c], widened.data(), sizeof(std::int64_t));
+        }
+    }
+    handle.write(padding, offset - position);
+
+    if (!handle) {
+        throw std::runtime_error("failed to write to '" + path.string() + "'");
+    }
+}
+
+/**
+ * @brief Zero-copy reader for files created by `write_columnar()`.
+ *
+ * On POSIX systems, the file is memory-mapped so that opening is fast regardless of the file size, and the columns are only paged in when they are accessed.
+ * On other platforms, the entire file is read into memory.
+ */
+class ColumnarReader {
+public:
+    /**
+     * @param path Path to a file created by `write_columnar()`.
+     */
+    ColumnarReader(const std::filesystem::path& path) {
+#ifdef EZTIMER_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("failed to open '" + path.string() + "'");
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("failed to query the size of '" + path.string() + "'");
+        }
+        my_size = info.st_size;
+        if (my_size) {
+            void* ptr = ::mmap(NULL, my_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (ptr == MAP_FAILED) {
+                throw std::runtime_error("failed to memory-map '" + path.string() + "'");
+            }
+            my_mapped = ptr;
+            my_data = static_cast<const char*>(ptr);
+        } else {
+            ::close(fd);
+        }
+#else
+        std::ifstream handle(path, std::ios::binary | std::ios::ate);
+        if (!handle) {
+            throw std::runtime_error("failed to open '" + path.string() + "'");
+        }
+        my_size = handle.tellg();
+        my_buffer.resize((my_size + 7) / 8);
+        handle.seekg(0);
+        handle.read(reinterpret_cast<char*>(my_buffer.data()), my_size);
+        my_data = reinterpret_cast<const char*>(my_buffer.data());
+#endif
+
+        try {
+            parse();
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    /**
+     * @cond
+     */
+    ColumnarReader(const ColumnarReader&) = delete;
+    ColumnarReader& operator=(const ColumnarReader&) = delete;
+
+    ColumnarReader(ColumnarReader&& other) {
+        take(std::move(other));
+    }
+
+    ColumnarReader& operator=(ColumnarReader&& other) {
+        if (this != &other) {
+            release();
+            take(std::move(other));
+        }
+        return *this;
+    }
+
+    ~ColumnarReader() {
+        release();
+    }
+    /**
+     * @endcond
+     */
+
+    /**
+     * @return Number of functions in the file.
+     */
+    std::size_t size() const {
+        return my_entries.size();
+    }
+
+    /**
+     * @return Metadata stored in the header, see `ColumnarOptions::metadata`.
+     */
+    const std::vector<std::pair<std::string, std::string> >& metadata() const {
+        return my_metadata;
+    }
+
+    /**
+     * @return Profile of the machine, if it was stored with `ColumnarOptions::profile`.
+     */
+    std::optional<MachineProfile> profile() const {
+        std::optional<MachineProfile> output;
+        for (const auto& meta : my_metadata) {
+            if (meta.first == internal::columnar_profile_key) {
+                std::istringstream in(meta.second);
+                output = read_machine_profile(in);
+                break;
+            }
+        }
+        return output;
+    }
+
+    /**
+     * @return Event for each counter column, or an unset value if the identity of the counter was not stored.
+     */
+    std::vector<std::optional<Counter> > counters() const {
+        std::vector<std::optional<Counter> > output;
+        output.reserve(my_counter_codes.size());
+        for (auto code : my_counter_codes) {
+            if (code >= 0) {
+                output.emplace_back(static_cast<Counter>(code));
+            } else {
+                output.emplace_back();
+            }
+        }
+        return output;
+    }
+
+    /**
+     * @param f Index of the function.
+     * @return Summary statistics for function `f`, available without touching its columns.
+     */
+    const ColumnarSummary& summary(std::size_t f) const {
+        return my_entries.at(f).summary;
+    }
+
+    /**
+     * @param f Index of the function.
+     * @return Time of each run of function `f`, in seconds.
+     */
+    ColumnView<double> times(std::size_t f) const {
+        return view<double>(my_entries.at(f).times);
+    }
+
+    /**
+     * @param f Index of the function.
+     * @return Iteration index of each run of function `f`, see `Timings::iterations`.
+     */
+    ColumnView<std::int32_t> iterations(std::size_t f) const {
+        return view<std::int32_t>(my_entries.at(f).iterations);
+    }
+
+    /**
+     * @param f Index of the function.
+     * @return CPU of each run of function `f`, see `Timings::cpus`.
+     * This is empty if CPUs were not recorded.
+     */
+    ColumnView<std::int32_t> cpus(std::size_t f) const {
+        return view<std::int32_t>(my_entries.at(f).cpus);
+    }
+
+    /**
+     * @param f Index of the function.
+     * @param c Index of the counter.
+     * @return Number of events for each run of function `f`, see `Timings::counters`.
+     * This is empty if the counter was not available.
+     */
+    ColumnView<std::int64_t> counter(std::size_t f, std::size_t c) const {
+        return view<std::int64_t>(my_entries.at(f).counters.at(c));
+    }
+
+    /**
+     * Copy the columns of a function into a `Timings` object, e.g., for use in other functions in this library.
+     *
+     * @param f Index of the function.
+     * @return Timings for function `f`.
+     */
+    Timings load(std::size_t f) const {
+        Timings output;
+        auto curtimes = times(f);
+        output.times.reserve(curtimes.size());
+        for (auto t : curtimes) {
+            output.times.emplace_back(t);
+        }
+        auto curiterations = iterations(f);
+        output.iterations.assign(curiterations.begin(), curiterations.end());
+        auto curcpus = cpus(f);
+        output.cpus.assign(curcpus.begin(), curcpus.end());
+        output.counters.resize(my_counter_codes.size());
+        for (std::size_t c = 0; c < my_counter_codes.size(); ++c) {
+            auto curcount = counter(f, c);
+            output.counters[c].assign(curcount.begin(), curcount.end());
+        }
+
+        const auto& summary = my_entries[f].summary;
+        output.mean = std::chrono::duration<double>(summary.mean);
+        output.sd = std::chrono::duration<double>(summary.sd);
+        return output;
+    }
+
+private:
+    const char* my_data = NULL;
+    std::size_t my_size = 0;
+#ifdef EZTIMER_HAS_MMAP
+    void* my_mapped = NULL;
+#else
+    std::vector<std::uint64_t> my_buffer;
+#endif
+
+    std::vector<std::pair<std::string, std::string> > my_metadata;
+    std::vector<std::int32_t> my_counter_codes;
+    std::vector<internal::ColumnarEntry> my_entries;
+
+private:
+    void parse() {
+        internal::ColumnarCursor cursor(my_data, my_size);
+        char magic[8];
+        for (auto& m : magic) {
+            m = cursor.read<char>();
+        }
+        if (std::memcmp(magic, internal::columnar_magic, 8) != 0) {
+            throw std::runtime_error("unrecognized format for a columnar file");
+        }
+        if (cursor.read<std::uint32_t>() != internal::columnar_byte_order) {
+            throw std::runtime_error("columnar file was written with a different byte order");
+        }
+
+        const auto nfun = cursor.read<std::uint32_t>();
+        const auto ncounters = cursor.read<std::uint32_t>();
+        const auto nmeta = cursor.read<std::uint32_t>();
+        for (std::uint32_t m = 0; m < nmeta; ++m) {
+            auto key = cursor.read_string();
+            auto value = cursor.read_string();
+            my_metadata.emplace_back(std::move(key), std::move(value));
+        }
+        if (ncounters > cursor.remaining() / sizeof(std::int32_t)) {
+            throw std::runtime_error("truncated header in columnar file");
+        }
+        my_counter_codes.reserve(ncounters);
+        for (std::uint32_t c = 0; c < ncounters; ++c) {
+            my_counter_codes.push_back(cursor.read<std::int32_t>());
+        }
+
+        // Each entry needs at least its name length, summary statistics and column extents,
+        // so the number of entries can be bounded before anything is allocated for them.
+        const std::size_t extent_size = 2 * sizeof(std::uint64_t);
+        const std::size_t min_entry = sizeof(std::uint32_t) + sizeof(std::uint64_t) + 4 * sizeof(double) + (3 + static_cast<std::size_t>(ncounters)) * extent_size;
+        if (nfun > cursor.remaining() / min_entry) {
+            throw std::runtime_error("truncated header in columnar file");
+        }
+
+        auto read_extent = [&](internal::ColumnExtent& extent, std::size_t width) -> void {
+            extent.offset = cursor.read<std::uint64_t>();
+            extent.length = cursor.read<std::uint64_t>();
+            if (extent.offset % 8 != 0 || extent.offset > my_size || extent.length > (my_size - extent.offset) / width) {
+                throw std::runtime_error("column extends beyond the end of the columnar file");
+            }
+        };
+
+        my_entries.reserve(nfun);
+        for (std::uint32_t f = 0; f < nfun; ++f) {
+            my_entries.emplace_back();
+            auto& entry = my_entries.back();
+            auto& summary = entry.summary;
+            summary.name = cursor.read_string();
+            summary.count = cursor.read<std::uint64_t>();
+            summary.mean = cursor.read<double>();
+            summary.sd = cursor.read<double>();
+            summary.min = cursor.read<double>();
+            summary.max = cursor.read<double>();
+            read_extent(entry.times, sizeof(double));
+            read_extent(entry.iterations, sizeof(std::int32_t));
+            read_extent(entry.cpus, sizeof(std::int32_t));
+            entry.counters.resize(ncounters);
+            for (auto& extent : entry.counters) {
+                read_extent(extent, sizeof(std::int64_t));
+            }
+        }
+    }
+
+    template<typename Type_>
+    ColumnView<Type_> view(const internal::ColumnExtent& extent) const {
+        return ColumnView<Type_>(reinterpret_cast<const Type_*>(my_data + extent.offset), extent.length);
+    }
+
+    void release() {
+#ifdef EZTIMER_HAS_MMAP
+        if (my_mapped != NULL) {
+            ::munmap(my_mapped, my_size);
+            my_mapped = NULL;
+        }
+#endif
+        my_data = NULL;
+        my_size = 0;
+    }
+
+    void take(ColumnarReader&& other) {
+        my_size = other.my_size;
+#ifdef EZTIMER_HAS_MMAP
+        my_mapped = other.my_mapped;
+        my_data = other.my_data;
+        other.my_mapped = NULL;
+#else
+        my_buffer = std::move(other.my_buffer);
+        my_data = reinterpret_cast<const char*>(my_buffer.data());
+#endif
+        other.my_data = NULL;
+        other.my_size = 0;
+        my_metadata = std::move(other.my_metadata);
+        my_counter_codes = std::move(other.my_counter_codes);
+        my_entries = std::move(other.my_entries);
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,382 @@
+#ifndef EZTIMER_COMPARE_HPP
+#define EZTIMER_COMPARE_HPP
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+#include <unordered_map>
+#include <chrono>
+#include <random>
+
+#include "eztimer.hpp"
+#include "stats.hpp"
+
+/**
+ * @file compare.hpp
+ * @brief Compare timings between functions.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Options for `compare_paired()`.
+ */
+struct CompareOptions {
+    /**
+     * Confidence level for the interval of the ratio.
+     */
+    double confidence = 0.95;
+};
+
+/**
+ * @brief Comparison of the runtimes of two functions.
+ */
+struct Comparison {
+    /**
+     * Ratio of the runtime of the second function to that of the first function.
+     * Values below 1 indicate that the second function is faster.
+     */
+    double ratio = std::numeric_limits<double>::quiet_NaN();
+
+    /**
+     * Lower bound of the confidence interval for `ratio`.
+     */
+    double lower = std::numeric_limits<double>::quiet_NaN();
+
+    /**
+     * Upper bound of the confidence interval for `ratio`.
+     */
+    double upper = std::numeric_limits<double>::quiet_NaN();
+
+    /**
+     * Number of pairs of runs used in the comparison.
+     */
+    std::size_t pairs = 0;
+
+    /**
+     * Whether the confidence interval excludes 1, i.e., the difference in runtime is significant.
+     */
+    bool significant = false;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+inline std::vector<double> paired_log_ratios(const Timings& first, const Timings& second) {
+    std::vector<double> logratios;
+
+    if (first.iterations.empty() || second.iterations.empty()) {
+        const auto n = std::min(first.times.size(), second.times.size());
+        logratios.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            logratios.push_back(std::log(second.times[i] / first.times[i]));
+        }
+    } else {
+        std::unordered_map<int, std::size_t> mapping;
+        mapping.reserve(first.iterations.size());
+        for (std::size_t i = 0; i < first.iterations.size(); ++i) {
+            mapping[first.iterations[i]] = i;
+        }
+        for (std::size_t j = 0; j < second.iterations.size(); ++j) {
+            auto it = mapping.find(second.iterations[j]);
+            if (it != mapping.end()) {
+                logratios.push_back(std::log(second.times[j] / first.times[it->second]));
+            }
+        }
+    }
+    return logratios;
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Compare the runtimes of two functions that were timed in the same call to `time()`.
+ * Runs from the same iteration are paired by `Timings::iterations`, so that any drift in machine performance across iterations affects both functions equally.
+ * The ratio is computed as the geometric mean of the per-iteration ratios, with a confidence interval from a paired t-test on the log-ratios.
+ *
+ * If `Timings::iterations` is empty for either function, runs are paired by their position in `Timings::times`.
+ * Iterations that were skipped for either function (e.g., due to `Options::max_time_per_function`) are ignored.
+ *
+ * @param first Timings for the first function, typically the baseline.
+ * @param second Timings for the second function.
+ * @param opt Further options.
+ *
+ * @return Comparison of the second function against the first.
+ */
+inline Comparison compare_paired(const Timings& first, const Timings& second, const CompareOptions& opt = CompareOptions()) {
+    auto logratios = internal::paired_log_ratios(first, second);
+
+    Comparison output;
+    output.pairs = logratios.size();
+    if (output.pairs == 0) {
+        return output;
+    }
+
+    const double mu = internal::mean(logratios);
+    output.ratio = std::exp(mu);
+    if (output.pairs < 2) {
+        return output;
+    }
+
+    const double se = std::sqrt(internal::variance(logratios, mu) / output.pairs);
+    const double quant = internal::t_quantile(1 - (1 - opt.confidence) / 2, output.pairs - 1);
+    output.lower = std::exp(mu - quant * se);
+    output.upper = std::exp(mu + quant * se);
+    output.significant = (output.lower > 1 || output.upper < 1);
+    return output;
+}
+
+/**
+ * @brief Options for `compare_distributions()`.
+ */
+struct DistributionOptions {
+    /**
+     * Probabilities of the quantiles at which to estimate the shift between distributions.
+     */
+    std::vector<double> quantiles { 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 0.95, 0.99 };
+
+    /**
+     * Confidence level for the interval of each quantile shift.
+     * This is also used as the significance threshold for the Kolmogorov-Smirnov test, i.e., the distributions differ if the p-value is below `1 - confidence`.
+     */
+    double confidence = 0.95;
+
+    /**
+     * Number of bootstrap replicates used to compute the confidence intervals for the quantile shifts.
+     */
+    int bootstrap = 1000;
+
+    /**
+     * Seed for the random number generator used for bootstrapping.
+     */
+    unsigned long long seed = 654321;
+
+    /**
+     * Smallest probability in `quantiles` that is considered to be part of the upper tail, see `DistributionComparison::tail_regression`.
+     */
+    double tail = 0.9;
+};
+
+/**
+ * @brief Shift in a quantile of the runtime distribution between two functions.
+ */
+struct QuantileShift {
+    /**
+     * Probability of the quantile.
+     */
+    double quantile = 0;
+
+    /**
+     * Quantile of the runtimes for the first function.
+     */
+    std::chrono::duration<double> first = std::chrono::duration<double>(0);
+
+    /**
+     * Quantile of the runtimes for the second function.
+     */
+    std::chrono::duration<double> second = std::chrono::duration<double>(0);
+
+    /**
+     * Difference between `second` and `first`.
+     * Positive values indicate that the second function is slower at this quantile.
+     */
+    std::chrono::duration<double> difference = std::chrono::duration<double>(0);
+
+    /**
+     * Lower bound of the bootstrap confidence interval for `difference`.
+     */
+    std::chrono::duration<double> lower = std::chrono::duration<double>(std::numeric_limits<double>::quiet_NaN());
+
+    /**
+     * Upper bound of the bootstrap confidence interval for `difference`.
+     */
+    std::chrono::duration<double> upper = std::chrono::duration<double>(std::numeric_limits<double>::quiet_NaN());
+
+    /**
+     * Whether the confidence interval excludes zero.
+     */
+    bool significant = false;
+};
+
+/**
+ * @brief Comparison of the runtime distributions of two functions.
+ */
+struct DistributionComparison {
+    /**
+     * Two-sample Kolmogorov-Smirnov statistic, i.e., the largest absolute difference between the empirical distribution functions.
+     */
+    double ks_statistic = std::numeric_limits<double>::quiet_NaN();
+
+    /**
+     * Asymptotic p-value for `ks_statistic`.
+     */
+    double ks_pvalue = std::numeric_limits<double>::quiet_NaN();
+
+    /**
+     * Whether `ks_pvalue` is below `1 - DistributionOptions::confidence`.
+     */
+    bool different = false;
+
+    /**
+     * Shift at each quantile in `DistributionOptions::quantiles`.
+     */
+    std::vector<QuantileShift> shifts;
+
+    /**
+     * Whether the second function is significantly slower at any quantile in the upper tail, i.e., at or above `DistributionOptions::tail`.
+     * This may be true even if the median is unchanged.
+     */
+    bool tail_regression = false;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+inline double kolmogorov_pvalue(double statistic, double n1, double n2) {
+    const double ne = n1 * n2 / (n1 + n2);
+    const double root = std::sqrt(ne);
+    const double lambda = (root + 0.12 + 0.11 / root) * statistic;
+    if (lambda < 0.2) {
+        return 1;
+    }
+
+    double sum = 0, sign = 1;
+    for (int j = 1; j <= 100; ++j) {
+        const double term = std::exp(-2 * j * j * lambda * lambda);
+        sum += sign * term;
+        if (term < 1e-12) {
+            break;
+        }
+        sign = -sign;
+    }
+    return std::min(1.0, std::max(0.0, 2 * sum));
+}
+
+inline double ks_statistic(const std::vector<double>& sorted1, const std::vector<double>& sorted2) {
+    const auto n1 = sorted1.size(), n2 = sorted2.size();
+    std::size_t i = 0, j = 0;
+    double output = 0;
+    while (i < n1 && j < n2) {
+        const double x = std::min(sorted1[i], sorted2[j]);
+        while (i < n1 && sorted1[i] == x) {
+            ++i;
+        }
+        while (j < n2 && sorted2[j] == x) {
+            ++j;
+        }
+        output = std::max(output, std::abs(static_cast<double>(i) / n1 - static_cast<double>(j) / n2));
+    }
+    return output;
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Compare the entire runtime distributions of two functions, e.g., a baseline and the current version.
+ * This detects changes that do not affect the mean or median, such as a fattened upper tail.
+ *
+ * A two-sample Kolmogorov-Smirnov test is used to determine whether the distributions differ anywhere.
+ * The shift function is also computed as the difference in each quantile of the runtimes, with a percentile bootstrap confidence interval from resampling each function's runtimes independently.
+ * Note that the intervals are not adjusted for multiple quantiles.
+ *
+ * Unlike `compare_paired()`, the runtimes are not paired, so the two `Timings` may come from separate calls to `time()` (e.g., a stored baseline).
+ *
+ * @param first Timings for the first function, typically the baseline.
+ * @param second Timings for the second function.
+ * @param opt Further options.
+ *
+ * @return Comparison of the distribution of the second function against the first.
+ */
+inline DistributionComparison compare_distributions(const Timings& first, const Timings& second, const DistributionOptions& opt = DistributionOptions()) {
+    DistributionComparison output;
+    const auto n1 = first.times.size(), n2 = second.times.size();
+    if (n1 == 0 || n2 == 0) {
+        return output;
+    }
+
+    std::vector<double> sorted1, sorted2;
+    sorted1.reserve(n1);
+    for (auto t : first.times) {
+        sorted1.push_back(t.count());
+    }
+    std::sort(sorted1.begin(), sorted1.end());
+    sorted2.reserve(n2);
+    for (auto t : second.times) {
+        sorted2.push_back(t.count());
+    }
+    std::sort(sorted2.begin(), sorted2.end());
+
+    output.ks_statistic = internal::ks_statistic(sorted1, sorted2);
+    output.ks_pvalue = internal::kolmogorov_pvalue(output.ks_statistic, n1, n2);
+    output.different = output.ks_pvalue < 1 - opt.confidence;
+
+    const auto nquant = opt.quantiles.size();
+    output.shifts.resize(nquant);
+    for (std::size_t q = 0; q < nquant; ++q) {
+        auto& current = output.shifts[q];
+        const double p = opt.quantiles[q];
+        current.quantile = p;
+        const double x1 = internal::sorted_quantile(sorted1, p), x2 = internal::sorted_quantile(sorted2, p);
+        current.first = std::chrono::duration<double>(x1);
+        current.second = std::chrono::duration<double>(x2);
+        current.difference = std::chrono::duration<double>(x2 - x1);
+    }
+
+    if (opt.bootstrap < 2) {
+        return output;
+    }
+
+    std::mt19937_64 rng(opt.seed);
+    std::uniform_int_distribution<std::size_t> pick1(0, n1 - 1), pick2(0, n2 - 1);
+    std::vector<double> resampled1(n1), resampled2(n2);
+    std::vector<std::vector<double> > replicates(nquant);
+    for (auto& rep : replicates) {
+        rep.reserve(opt.bootstrap);
+    }
+
+    for (int b = 0; b < opt.bootstrap; ++b) {
+        for (auto& x : resampled1) {
+            x = sorted1[pick1(rng)];
+        }
+        std::sort(resampled1.begin(), resampled1.end());
+        for (auto& x : resampled2) {
+            x = sorted2[pick2(rng)];
+        }
+        std::sort(resampled2.begin(), resampled2.end());
+        for (std::size_t q = 0; q < nquant; ++q) {
+            const double p = opt.quantiles[q];
+            replicates[q].push_back(internal::sorted_quantile(resampled2, p) - internal::sorted_quantile(resampled1, p));
+        }
+    }
+
+    const double alpha = 1 - opt.confidence;
+    for (std::size_t q = 0; q < nquant; ++q) {
+        auto& rep = replicates[q];
+        std::sort(rep.begin(), rep.end());
+        auto& current = output.shifts[q];
+        current.lower = std::chrono::duration<double>(internal::sorted_quantile(rep, alpha / 2));
+        current.upper = std::chrono::duration<double>(internal::sorted_quantile(rep, 1 - alpha / 2));
+        current.significant = (current.lower.count() > 0 || current.upper.count() < 0);
+        if (current.quantile >= opt.tail && current.lower.count() > 0) {
+            output.tail_regression = true;
+        }
+    }
+
+    return output;
+}
+
+}
+
+#endif
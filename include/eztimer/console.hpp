@@ -0,0 +1,305 @@
+#ifndef EZTIMER_CONSOLE_HPP
+#define EZTIMER_CONSOLE_HPP
+
+#include <vector>
+#include <string>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <ostream>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#include "eztimer.hpp"
+#include "stats.hpp"
+#include "format.hpp"
+#include "compare.hpp"
+
+/**
+ * @file console.hpp
+ * @brief Print a summary table of the timings to the terminal.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Options for `write_console_report()`.
+ */
+struct ConsoleOptions {
+    /**
+     * Name of each function.
+     * If empty, functions are named by their index.
+     */
+    std::vector<std::string> names;
+
+    /**
+     * Index of the baseline function for the relative speeds.
+     */
+    std::size_t baseline = 0;
+
+    /**
+     * Confidence level for the intervals of the means and the relative speeds.
+     */
+    double confidence = 0.95;
+
+    /**
+     * Number of bins in the histogram of each function.
+     * If zero, no histograms are printed.
+     */
+    std::size_t bins = 16;
+
+    /**
+     * Whether to use ANSI colours for the significance markers.
+     * If not set, colours are only used when writing to `std::cout` while it is a terminal and the `NO_COLOR` environment variable is not set.
+     */
+    std::optional<bool> colour;
+
+    /**
+     * Whether to use Unicode characters for the histograms, markers and units.
+     * If false, only ASCII characters are used.
+     */
+    bool unicode = true;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+// Number of code points, so that multi-byte UTF-8 characters are aligned
+// correctly; continuation bytes are of the form 10xxxxxx.
+inline std::size_t display_width(const std::string& text) {
+    std::size_t width = 0;
+    for (auto c : text) {
+        if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) {
+            ++width;
+        }
+    }
+    return width;
+}
+
+inline std::string sparkline(const std::vector<double>& values, double lower, double upper, std::size_t bins, bool unicode) {
+    std::vector<std::size_t> counts(bins);
+    const double range = upper - lower;
+    for (auto x : values) {
+        if (x > 0) {
+            const double position = (range > 0 ? (std::log10(x) - lower) / range : 0);
+            const auto b = static_cast<std::size_t>(std::max(position, 0.0) * bins);
+            ++counts[std::min(b, bins - 1)];
+        }
+    }
+
+    static const std::array<const char*, 8> blocks { "▁", "▂", "▃", "▄", "▅", "▆", "▇", "█" };
+    static const std::string ascii = ".:-=+*#@";
+    const double maxcount = *std::max_element(counts.begin(), counts.end());
+
+    std::string output;
+    for (auto count : counts) {
+        if (count == 0) {
+            output += ' ';
+            continue;
+        }
+
+        // Non-empty bins always get the smallest block, so that isolated outliers are visible.
+        const auto level = std::min(static_cast<std::size_t>(count / maxcount * 8), static_cast<std::size_t>(7));
+        if (unicode) {
+            output += blocks[level];
+        } else {
+            output += ascii[level];
+        }
+    }
+    return output;
+}
+
+inline bool use_colour(const std::ostream& out, const ConsoleOptions& opt) {
+    if (opt.colour.has_value()) {
+        return *(opt.colour);
+    }
+    if (std::getenv("NO_COLOR") != NULL) {
+        return false;
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    return &out == &std::cout && isatty(fileno(stdout));
+#else
+    return false;
+#endif
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Write a summary of the timings as an aligned table, e.g., to print the results of `time()` to the terminal.
+ * For each function, the table contains:
+ *
+ * - The number of runs.
+ * - The mean, median and 99th percentile of the times, with automatically scaled units.
+ * - The half-width of the confidence interval for the mean, relative to the mean.
+ * - The speed relative to the baseline, from `compare_paired()`.
+ *   This is followed by a marker for whether the function is significantly faster, slower or indistinguishable from the baseline.
+ * - A histogram of the log-times, on a scale shared by all functions.
+ *
+ * @param out Output stream.
+ * @param timings Timings for each function, typically from `time()`.
+ * @param opt Further options.
+ */
+inline void write_console_report(std::ostream& out, const std::vector<Timings>& timings, const ConsoleOptions& opt = ConsoleOptions()) {
+    const auto nfun = timings.size();
+    std::vector<std::string> labels;
+    labels.reserve(nfun);
+    if (opt.names.empty()) {
+        for (std::size_t f = 0; f < nfun; ++f) {
+            labels.push_back(std::to_string(f));
+        }
+    } else if (opt.names.size() != nfun) {
+        throw std::runtime_error("length of 'names' should be equal to the number of functions");
+    } else {
+        labels = opt.names;
+    }
+    if (nfun && opt.baseline >= nfun) {
+        throw std::runtime_error("'baseline' should be less than the number of functions");
+    }
+
+    const bool colour = internal::use_colour(out, opt);
+    const bool unicode = opt.unicode;
+
+    std::vector<std::vector<double> > sorted(nfun);
+    double lower = std::numeric_limits<double>::infinity(), upper = -lower;
+    for (std::size_t f = 0; f < nfun; ++f) {
+        auto& cursorted = sorted[f];
+        cursorted.reserve(timings[f].times.size());
+        for (auto t : timings[f].times) {
+            cursorted.push_back(t.count());
+        }
+        std::sort(cursorted.begin(), cursorted.end());
+        auto first = std::upper_bound(cursorted.begin(), cursorted.end(), 0.0);
+        if (first != cursorted.end()) {
+            lower = std::min(lower, std::log10(*first));
+            upper = std::max(upper, std::log10(cursorted.back()));
+        }
+    }
+
+    // Assembling all cells first so that the column widths can be determined.
+    std::vector<std::vector<std::string> > rows;
+    rows.push_back({ "Function", "Runs", "Mean", "Median", "p99", unicode ? "±CI" : "+/-CI", "Relative" });
+    std::vector<int> markers(nfun); // -1 for slower, 1 for faster, 0 for not significant.
+    CompareOptions copt;
+    copt.confidence = opt.confidence;
+
+    for (std::size_t f = 0; f < nfun; ++f) {
+        const auto& curtime = timings[f];
+        const auto& cursorted = sorted[f];
+        const auto n = cursorted.size();
+
+        std::vector<std::string> row;
+        row.push_back(labels[f]);
+        row.push_back(std::to_string(n));
+        row.push_back(internal::format_duration(n ? curtime.mean.count() : std::numeric_limits<double>::quiet_NaN(), 3, unicode));
+        row.push_back(internal::format_duration(n ? internal::sorted_quantile(cursorted, 0.5) : std::numeric_limits<double>::quiet_NaN(), 3, unicode));
+        row.push_back(internal::format_duration(n ? internal::sorted_quantile(cursorted, 0.99) : std::numeric_limits<double>::quiet_NaN(), 3, unicode));
+
+        if (n > 1 && curtime.mean.count() > 0) {
+            const double halfwidth = internal::t_quantile(1 - (1 - opt.confidence) / 2, n - 1) * curtime.sd.count() / std::sqrt(static_cast<double>(n));
+            std::ostringstream ci;
+            ci << std::fixed << std::setprecision(2) << halfwidth / curtime.mean.count() * 100 << "%";
+            row.push_back(ci.str());
+        } else {
+            row.push_back("-");
+        }
+
+        if (f == opt.baseline) {
+            row.push_back("baseline");
+        } else {
+            // Reporting speed rather than runtime, so that values above 1 are faster.
+            auto comp = compare_paired(timings[opt.baseline], timings[f], copt);
+            if (std::isfinite(comp.ratio)) {
+                std::ostringstream rel;
+                rel << std::fixed << std::setprecision(2) << 1 / comp.ratio << "x";
+                row.push_back(rel.str());
+                if (comp.significant) {
+                    markers[f] = (comp.ratio < 1 ? 1 : -1);
+                }
+            } else {
+                row.push_back("-");
+            }
+        }
+
+        rows.push_back(std::move(row));
+    }
+
+    const auto ncols = rows.front().size();
+    std::vector<std::size_t> widths(ncols);
+    for (const auto& row : rows) {
+        for (std::size_t c = 0; c < ncols; ++c) {
+            widths[c] = std::max(widths[c], internal::display_width(row[c]));
+        }
+    }
+
+    const char* green = (colour ? "\033[32m" : "");
+    const char* red = (colour ? "\033[31m" : "");
+    const char* dim = (colour ? "\033[2m" : "");
+    const char* reset = (colour ? "\033[0m" : "");
+
+    std::ostringstream buffer;
+    for (std::size_t r = 0; r < rows.size(); ++r) {
+        const auto& row = rows[r];
+        for (std::size_t c = 0; c < ncols; ++c) {
+            const std::string padding(widths[c] - internal::display_width(row[c]), ' ');
+            if (c == 0) {
+                buffer << row[c] << padding;
+            } else {
+                buffer << "  " << padding << row[c];
+            }
+        }
+
+        if (r == 0) {
+            if (opt.bins) {
+                buffer << "    Histogram";
+            }
+            buffer << "\n";
+            continue;
+        }
+
+        const auto f = r - 1;
+        if (markers[f] > 0) {
+            buffer << " " << green << (unicode ? "▲" : "+") << reset;
+        } else if (markers[f] < 0) {
+            buffer << " " << red << (unicode ? "▼" : "-") << reset;
+        } else {
+            buffer << " " << dim << (f == opt.baseline ? " " : (unicode ? "≈" : "=")) << reset;
+        }
+
+        if (opt.bins) {
+            buffer << "  " << (unicode ? "│" : "|") << internal::sparkline(sorted[f], lower, upper, opt.bins, unicode) << (unicode ? "│" : "|");
+        }
+        buffer << "\n";
+    }
+
+    if (nfun) {
+        buffer << "\n" << dim << "CI: " << opt.confidence * 100 << "% confidence interval of the mean. Relative: speed relative to " << labels[opt.baseline] << ", "
+            << (unicode ? "▲/▼" : "+/-") << " for significantly faster/slower.";
+        if (opt.bins && std::isfinite(lower)) {
+            buffer << " Histogram: " << internal::format_duration(std::pow(10, lower), 3, unicode) << " to " << internal::format_duration(std::pow(10, upper), 3, unicode) << ", log scale.";
+        }
+        buffer << reset << "\n";
+    }
+
+    out << buffer.str();
+}
+
+}
+
+#endif
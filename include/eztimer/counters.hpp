@@ -0,0 +1,214 @@
+#ifndef EZTIMER_COUNTERS_HPP
+#define EZTIMER_COUNTERS_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+/**
+ * @file counters.hpp
+ * @brief Hardware and software event counters.
+ */
+
+namespace eztimer {
+
+/**
+ * Events that can be counted during each function call.
+ */
+enum class Counter {
+    CYCLES,
+    INSTRUCTIONS,
+    CACHE_MISSES,
+    BRANCH_MISSES,
+    DTLB_MISSES,
+    PAGE_FAULTS,
+    CONTEXT_SWITCHES
+};
+
+/**
+ * @brief Set of event counters for the calling thread.
+ *
+ * On Linux, each counter is opened with `perf_event_open()` for the calling thread, excluding kernel events where possible.
+ * Counters that cannot be opened (e.g., due to a restrictive `perf_event_paranoid` setting or lack of hardware support) are marked as unavailable.
+ * On other platforms, no counters are available.
+ */
+class CounterSet {
+public:
+    /**
+     * @param counters Events to be counted.
+     */
+    CounterSet(const std::vector<Counter>& counters) : my_fds(counters.size(), -1) {
+#ifdef __linux__
+        for (std::size_t c = 0; c < counters.size(); ++c) {
+            my_fds[c] = open(counters[c]);
+        }
+#endif
+    }
+
+    /**
+     * @cond
+     */
+    CounterSet(const CounterSet&) = delete;
+    CounterSet& operator=(const CounterSet&) = delete;
+
+    CounterSet(CounterSet&& other) : my_fds(std::move(other.my_fds)) {
+        other.my_fds.clear();
+    }
+
+    CounterSet& operator=(CounterSet&& other) {
+        if (this != &other) {
+            close_all();
+            my_fds = std::move(other.my_fds);
+            other.my_fds.clear();
+        }
+        return *this;
+    }
+
+    ~CounterSet() {
+        close_all();
+    }
+    /**
+     * @endcond
+     */
+
+public:
+    /**
+     * @return Number of counters in this set.
+     */
+    std::size_t size() const {
+        return my_fds.size();
+    }
+
+    /**
+     * @param i Index of the counter.
+     * @return Whether the `i`-th counter could be opened.
+     */
+    bool available(std::size_t i) const {
+        return my_fds[i] >= 0;
+    }
+
+    /**
+     * Reset and start all available counters.
+     */
+    void start() {
+#ifdef __linux__
+        for (auto fd : my_fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    /**
+     * Stop all available counters and report the number of events since the last `start()`.
+     * @param[out] output Vector of length equal to `size()`.
+     * On return, this contains the count for each available counter; unavailable counters are set to zero.
+     */
+    void stop(std::vector<long long>& output) {
+        output.resize(my_fds.size());
+#ifdef __linux__
+        for (auto fd : my_fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+#endif
+        for (std::size_t c = 0; c < my_fds.size(); ++c) {
+            output[c] = 0;
+#ifdef __linux__
+            if (my_fds[c] >= 0) {
+                long long value = 0;
+                if (read(my_fds[c], &value, sizeof(value)) == static_cast<ssize_t>(sizeof(value))) {
+                    output[c] = value;
+                }
+            }
+#endif
+        }
+    }
+
+private:
+    std::vector<int> my_fds;
+
+    void close_all() {
+#ifdef __linux__
+        for (auto fd : my_fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+        my_fds.clear();
+    }
+
+#ifdef __linux__
+    static int open(Counter counter) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.disabled = 1;
+        attr.exclude_hv = 1;
+
+        bool software = false;
+        switch (counter) {
+            case Counter::CYCLES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case Counter::INSTRUCTIONS:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case Counter::CACHE_MISSES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CACHE_MISSES;
+                break;
+            case Counter::BRANCH_MISSES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+            case Counter::DTLB_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+            case Counter::PAGE_FAULTS:
+                attr.type = PERF_TYPE_SOFTWARE;
+                attr.config = PERF_COUNT_SW_PAGE_FAULTS;
+                software = true;
+                break;
+            case Counter::CONTEXT_SWITCHES:
+                attr.type = PERF_TYPE_SOFTWARE;
+                attr.config = PERF_COUNT_SW_CONTEXT_SWITCHES;
+                software = true;
+                break;
+        }
+
+        // Software events mostly happen in the kernel, so we try to include
+        // kernel events for those before falling back to user-only counting.
+        if (software) {
+            attr.exclude_kernel = 0;
+            int fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+            if (fd >= 0) {
+                return fd;
+            }
+        }
+
+        attr.exclude_kernel = 1;
+        return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+};
+
+}
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef EZTIMER_ENVIRONMENT_SWEEP_HPP
+#define EZTIMER_ENVIRONMENT_SWEEP_HPP
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstddef>
+#include <ostream>
+#include <algorithm>
+
+#include "eztimer.hpp"
+#include "process.hpp"
+
+/**
+ * @file environment_sweep.hpp
+ * @brief Sweep over environment variables in child processes.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Timings for each combination of environment variables.
+ */
+struct EnvironmentSweep {
+    /**
+     * Names of the environment variables in the grid.
+     */
+    std::vector<std::string> variables;
+
+    /**
+     * Values of the environment variables for each setting (outer vector).
+     * Each inner vector is parallel to `variables`.
+     */
+    std::vector<std::vector<std::string> > settings;
+
+    /**
+     * Output of `time_processes()`, where each command corresponds to a setting.
+     */
+    ProcessTimings processes;
+
+    /**
+     * Names of the functions reported by the child processes with `report_to_parent()`, in order of first appearance.
+     */
+    std::vector<std::string> functions;
+
+    /**
+     * Timings for each setting (outer vector) and each function in `functions` (inner vector).
+     */
+    std::vector<std::vector<Timings> > timings;
+
+    /**
+     * For each function in `functions`, the index of the setting with the lowest mean time.
+     */
+    std::vector<std::size_t> best;
+
+    /**
+     * Index of the setting with the lowest mean time for the entire child process, i.e., `processes.timings`.
+     */
+    std::size_t best_process = 0;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+inline std::size_t which_min_mean(const std::vector<const Timings*>& candidates) {
+    std::size_t best = 0;
+    bool found = false;
+    for (std::size_t s = 0; s < candidates.size(); ++s) {
+        const auto& current = *(candidates[s]);
+        if (current.times.empty()) {
+            continue;
+        }
+        if (!found || current.mean < candidates[best]->mean) {
+            best = s;
+            found = true;
+        }
+    }
+    return best;
+}
+
+inline std::string escape_csv(const std::string& x) {
+    if (x.find_first_of(",\"\n") == std::string::npos) {
+        return x;
+    }
+    std::string output = "\"";
+    for (auto c : x) {
+        if (c == '"') {
+            output += '"';
+        }
+        output += c;
+    }
+    output += '"';
+    return output;
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Run a benchmark executable over a grid of environment variables, e.g., `OMP_NUM_THREADS` or `MALLOC_ARENA_MAX`.
+ * This is intended for runtime settings that are only read at startup and cannot be varied within a single process.
+ * All combinations of values are run in random order within each iteration, as described in `time_processes()`.
+ * Per-function results are only available if the executable reports its timings with `report_to_parent()`.
+ *
+ * @param command Command to run the benchmark executable.
+ * @param grid Vector of environment variables, where each entry contains the name of the variable and the values to test.
+ * Settings are formed from all combinations of values, with the first variable changing fastest.
+ * @param opt Further options.
+ *
+ * @return Timings for each setting.
+ */
+inline EnvironmentSweep sweep_environment(
+    const Command& command,
+    const std::vector<std::pair<std::string, std::vector<std::string> > >& grid,
+    const ProcessOptions& opt
+) {
+    EnvironmentSweep output;
+    std::size_t nsettings = 1;
+    for (const auto& g : grid) {
+        output.variables.push_back(g.first);
+        nsettings *= g.second.size();
+    }
+
+    output.settings.reserve(nsettings);
+    std::vector<Command> commands;
+    commands.reserve(nsettings);
+    const auto nvar = grid.size();
+    for (std::size_t s = 0; s < nsettings; ++s) {
+        std::vector<std::string> values;
+        values.reserve(nvar);
+        Command current = command;
+        std::size_t remaining = s;
+        for (const auto& g : grid) {
+            const auto& val = g.second[remaining % g.second.size()];
+            remaining /= g.second.size();
+            values.push_back(val);
+
+            auto& env = current.environment;
+            env.erase(std::remove_if(env.begin(), env.end(), [&](const auto& x) -> bool { return x.first == g.first; }), env.end());
+            env.emplace_back(g.first, val);
+        }
+        output.settings.push_back(std::move(values));
+        commands.push_back(std::move(current));
+    }
+
+    output.processes = time_processes(commands, opt);
+
+    for (const auto& curruns : output.processes.runs) {
+        for (const auto& run : curruns) {
+            for (const auto& rep : run.reported) {
+                if (std::find(output.functions.begin(), output.functions.end(), rep.first) == output.functions.end()) {
+                    output.functions.push_back(rep.first);
+                }
+            }
+        }
+    }
+    const auto nfun = output.functions.size();
+
+    output.timings.resize(nsettings);
+    for (std::size_t s = 0; s < nsettings; ++s) {
+        auto& curtimings = output.timings[s];
+        curtimings.reserve(nfun);
+        for (const auto& fun : output.functions) {
+            curtimings.push_back(reported_timings(output.processes, s, fun));
+        }
+    }
+
+    std::vector<const Timings*> candidates(nsettings);
+    output.best.reserve(nfun);
+    for (std::size_t f = 0; f < nfun; ++f) {
+        for (std::size_t s = 0; s < nsettings; ++s) {
+            candidates[s] = &(output.timings[s][f]);
+        }
+        output.best.push_back(internal::which_min_mean(candidates));
+    }
+    for (std::size_t s = 0; s < nsettings; ++s) {
+        candidates[s] = &(output.processes.timings[s]);
+    }
+    output.best_process = internal::which_min_mean(candidates);
+
+    return output;
+}
+
+/**
+ * Write the results of `sweep_environment()` as a CSV file, e.g., to plot scaling curves across thread counts.
+ * Each row corresponds to a function in a setting, with one column for each environment variable, followed by the `function`, `iterations`, `mean` and `sd` columns.
+ * The runtime of the entire child process is reported in rows where `function` is empty.
+ *
+ * @param output Stream to write to.
+ * @param sweep Output of `sweep_environment()`.
+ */
+inline void write_environment_sweep(std::ostream& output, const EnvironmentSweep& sweep) {
+    for (const auto& var : sweep.variables) {
+        output << internal::escape_csv(var) << ",";
+    }
+    output << "function,iterations,mean,sd\n";
+
+    auto dump = [&](const std::vector<std::string>& values, const std::string& name, const Timings& timings) -> void {
+        for (const auto& val : values) {
+            output << internal::escape_csv(val) << ",";
+        }
+        output << internal::escape_csv(name) << "," << timings.times.size() << "," << timings.mean.count() << "," << timings.sd.count() << "\n";
+    };
+
+    for (std::size_t s = 0; s < sweep.settings.size(); ++s) {
+        dump(sweep.settings[s], "", sweep.processes.timings[s]);
+        for (std::size_t f = 0; f < sweep.functions.size(); ++f) {
+            dump(sweep.settings[s], sweep.functions[f], sweep.timings[s][f]);
+        }
+    }
+}
+
+}
+
+#endif
@@ -9,6 +9,12 @@
 #include <optional>
 #include <functional>
 #include <cassert>
+#include <cmath>
+#include <algorithm>
+
+#include "counters.hpp"
+#include "tail_options.hpp"
+#include "tail.hpp"
 
 /**
  * @file eztimer.hpp
@@ -69,6 +75,25 @@ struct Options {
      * Ignored if not set.
      */
     std::function<void()> setup;
+
+    /**
+     * Events to count during each function call, see `Timings::counters`.
+     * Counters are started before and stopped after the timed region of each call, so their overhead is not included in the timings.
+     */
+    std::vector<Counter> counters;
+
+    /**
+     * Options for capturing diagnostics for slow calls, see `Timings::outliers`.
+     * Any event counts in the diagnostics are taken from `counters`.
+     *
+     * Ignored if not set.
+     */
+    std::optional<TailCaptureOptions> tail_capture;
+
+    /**
+     * Whether to record the CPU on which each function call finished, see `Timings::cpus`.
+     */
+    bool record_cpu = false;
 };
 
 /**
@@ -80,6 +105,13 @@ struct Timings {
      */
     std::vector<std::chrono::duration<double> > times;
 
+    /**
+     * Vector of the iteration index for each run of the function, parallel to `times`.
+     * Indices start from zero at the first non-burn-in iteration.
+     * As all functions are called once per iteration, runs from different functions with the same index were interleaved with each other.
+     */
+    std::vector<int> iterations;
+
     /**
      * Mean of `times`, in seconds.
      */
@@ -89,8 +121,55 @@ struct Timings {
      * standard deviation of `times`, in seconds.
      */
     std::chrono::duration<double> sd = std::chrono::duration<double>(0);
+
+    /**
+     * Vector of length equal to `Options::counters`.
+     * Each inner vector contains the number of events for each run of the function, parallel to `times`.
+     * An inner vector is empty if the corresponding counter is not available on this platform.
+     */
+    std::vector<std::vector<long long> > counters;
+
+    /**
+     * Diagnostics for the slowest calls, sorted by `Outlier::index`.
+     * This is only filled if `Options::tail_capture` is set.
+     */
+    std::vector<Outlier> outliers;
+
+    /**
+     * Vector of the CPU on which each run of the function finished, parallel to `times`.
+     * This is only filled if `Options::record_cpu = true`.
+     * Entries are set to -1 if the CPU cannot be determined on this platform.
+     */
+    std::vector<int> cpus;
 };
 
+/**
+ * Compute the summary statistics in `Timings` from its `Timings::times`.
+ * This is called by `time()` but can also be used for `Timings` that are constructed or modified by the caller.
+ *
+ * @param timings Timings for a function.
+ * On output, `Timings::mean` and `Timings::sd` are filled.
+ * If `Timings::times` is empty, both are set to zero.
+ */
+inline void compute_statistics(Timings& timings) {
+    timings.mean = std::chrono::duration<double>(0);
+    timings.sd = std::chrono::duration<double>(0);
+    if (timings.times.empty()) {
+        return;
+    }
+
+    for (const auto id : timings.times) {
+        timings.mean += id;
+    }
+    timings.mean /= timings.times.size();
+    for (const auto id : timings.times) {
+        const double delta = (id - timings.mean).count();
+        timings.sd += std::chrono::duration<double>(delta * delta);
+    }
+    timings.sd /= timings.times.size() - 1;
+    timings.sd = std::chrono::duration<double>(std::sqrt(timings.sd.count()));
+}
+
 /**
  * Record the execution time of any number of functions, possibly over multiple iterations.
  * When multiple functions are supplied, they are called in a random order per iteration to avoid any dependencies.
@@ -131,6 +210,21 @@ std::vector<Timings> time(
     }
 
     std::vector<Timings> output(nfun);
+    const auto ncounters = opt.counters.size();
+    std::optional<CounterSet> counters;
+    std::vector<long long> counts;
+    if (ncounters) {
+        counters.emplace(opt.counters);
+        for (auto& curout : output) {
+            curout.counters.resize(ncounters);
+        }
+    }
+
+    std::optional<internal::TailCapture> tail;
+    if (opt.tail_capture.has_value()) {
+        tail.emplace(*(opt.tail_capture), nfun);
+    }
+
     auto total_time = std::chrono::duration<double>(0);
     auto oIt = order.begin();
 
@@ -152,11 +246,35 @@ std::vector<Timings> time(
                 }
             }
 
+            const bool capture = tail && i >= opt.burn_in;
+            if (capture) {
+                tail->before(current);
+            }
+            if (counters) {
+                counters->start();
+            }
             const auto start = std::chrono::steady_clock::now();
             auto res = funs[current]();
             const auto end = std::chrono::steady_clock::now();
             const auto curtime = std::chrono::duration_cast<std::chrono::duration<double> >(end - start);
             curout.times.push_back(curtime);
+            curout.iterations.push_back(i - opt.burn_in);
+            if (opt.record_cpu) {
+                curout.cpus.push_back(internal::current_cpu());
+            }
+
+            if (counters) {
+                counters->stop(counts);
+                for (std::size_t c = 0; c < ncounters; ++c) {
+                    if (counters->available(c)) {
+                        curout.counters[c].push_back(counts[c]);
+                    }
+                }
+            }
+
+            if (capture) {
+                tail->after(current, curtime, curout.times.size() - 1 - opt.burn_in, i - opt.burn_in, counts, curout.outliers);
+            }
 
             if (i >= opt.burn_in) {
                 check(res, current);
@@ -173,18 +291,17 @@ std::vector<Timings> time(
         // Throwing away the burn-in cycles. We add them and throw them away to
         // ensure that the compiler doesn't just optimize out the calls.
         curout.times.erase(curout.times.begin(), curout.times.begin() + opt.burn_in);
-        if (curout.times.empty()) {
-            continue;
+        curout.iterations.erase(curout.iterations.begin(), curout.iterations.begin() + opt.burn_in);
+        if (opt.record_cpu) {
+            curout.cpus.erase(curout.cpus.begin(), curout.cpus.begin() + opt.burn_in);
         }
-
-        // Computing the remaining statistics.
-        curout.mean /= curout.times.size();
-        for (const auto id : curout.times) {
-            const double delta = (id - curout.mean).count();
-            curout.sd += std::chrono::duration<double>(delta * delta);
+        for (auto& curcount : curout.counters) {
+            if (!curcount.empty()) {
+                curcount.erase(curcount.begin(), curcount.begin() + opt.burn_in);
+            }
         }
-        curout.sd /= curout.times.size() - 1;
-        curout.sd = std::chrono::duration<double>(std::sqrt(curout.sd.count()));
+        std::sort(curout.outliers.begin(), curout.outliers.end(), [](const Outlier& l, const Outlier& r) -> bool { return l.index < r.index; });
+        compute_statistics(curout);
     }
 
     return output; 
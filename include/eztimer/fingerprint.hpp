@@ -0,0 +1,165 @@
+#ifndef EZTIMER_FINGERPRINT_HPP
+#define EZTIMER_FINGERPRINT_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#include <sys/types.h>
+#include <sys/sysctl.h>
+#endif
+
+/**
+ * @file fingerprint.hpp
+ * @brief Identify the machine on which timings were collected.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Description of the machine on which timings were collected.
+ */
+struct Fingerprint {
+    /**
+     * Name of the host.
+     */
+    std::string hostname;
+
+    /**
+     * Model name of the CPU, or an empty string if this is not known.
+     */
+    std::string cpu_model;
+
+    /**
+     * Number of hardware threads.
+     */
+    unsigned cpus = 0;
+
+    /**
+     * Amount of physical memory in bytes.
+     */
+    unsigned long long memory = 0;
+
+    /**
+     * Name, release and architecture of the operating system.
+     */
+    std::string os;
+
+    /**
+     * Compiler used to build the program.
+     */
+    std::string compiler;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+inline std::string cpu_model() {
+    std::string output;
+#if defined(__linux__)
+    std::ifstream handle("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(handle, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            const auto colon = line.find(':');
+            if (colon != std::string::npos) {
+                output = line.substr(line.find_first_not_of(" \t", colon + 1));
+            }
+            break;
+        }
+    }
+#elif defined(__APPLE__)
+    char buffer[256];
+    std::size_t len = sizeof(buffer);
+    if (sysctlbyname("machdep.cpu.brand_string", buffer, &len, NULL, 0) == 0) {
+        output = buffer;
+    }
+#endif
+    return output;
+}
+
+inline std::string compiler_version() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#else
+    return "";
+#endif
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Describe the current machine, so that timings from different machines are not compared with each other.
+ *
+ * @return Fingerprint of the current machine.
+ */
+inline Fingerprint machine_fingerprint() {
+    Fingerprint output;
+
+    utsname info;
+    if (uname(&info) == 0) {
+        output.hostname = info.nodename;
+        output.os = std::string(info.sysname) + " " + info.release + " " + info.machine;
+    }
+
+    output.cpu_model = internal::cpu_model();
+    output.cpus = std::thread::hardware_concurrency();
+
+    const long pages = sysconf(_SC_PHYS_PAGES), page_size = sysconf(_SC_PAGE_SIZE);
+    if (pages > 0 && page_size > 0) {
+        output.memory = static_cast<unsigned long long>(pages) * static_cast<unsigned long long>(page_size);
+    }
+
+    output.compiler = internal::compiler_version();
+    return output;
+}
+
+/**
+ * Compute a short identifier for a fingerprint, e.g., to index results in a `ResultsStore`.
+ * This is a hash of all fields in the fingerprint, so any change to the machine or compiler will yield a different identifier.
+ *
+ * @param fingerprint Fingerprint of a machine, typically from `machine_fingerprint()`.
+ *
+ * @return Hexadecimal string of length 16.
+ */
+inline std::string fingerprint_id(const Fingerprint& fingerprint) {
+    // 64-bit FNV-1a, with a separator between fields so that they can't run
+    // into each other.
+    std::uint64_t hash = 14695981039346656037ull;
+    auto add = [&](const std::string& field) -> void {
+        for (unsigned char c : field) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        hash ^= 0xff;
+        hash *= 1099511628211ull;
+    };
+
+    add(fingerprint.hostname);
+    add(fingerprint.cpu_model);
+    add(std::to_string(fingerprint.cpus));
+    add(std::to_string(fingerprint.memory));
+    add(fingerprint.os);
+    add(fingerprint.compiler);
+
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+    return buffer;
+}
+
+}
+
+#endif
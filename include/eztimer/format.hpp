@@ -0,0 +1,80 @@
+#ifndef EZTIMER_FORMAT_HPP
+#define EZTIMER_FORMAT_HPP
+
+#include <string>
+#include <cmath>
+#include <cstddef>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+/**
+ * @file format.hpp
+ * @brief Formatting utilities.
+ */
+
+namespace eztimer {
+
+/**
+ * @cond
+ */
+namespace internal {
+
+// Formats a duration with an automatically chosen unit and a fixed number of
+// significant figures. The unit is chosen after rounding, so that values just
+// below a unit boundary are reported as, e.g., "1.00 us" instead of "1000 ns".
+inline std::string format_duration(double seconds, int significant, bool unicode = false) {
+    if (!std::isfinite(seconds)) {
+        return "-";
+    }
+
+    const char* units[] = { "ns", (unicode ? "µs" : "us"), "ms", "s" };
+    constexpr std::size_t nunits = 4;
+    significant = std::max(significant, 1);
+
+    double scaled = seconds * 1e9;
+    std::size_t unit = 0;
+    while (unit + 1 < nunits && std::abs(scaled) >= 1000) {
+        scaled /= 1000;
+        ++unit;
+    }
+
+    double rounded = 0;
+    int exponent = 0;
+    while (true) {
+        if (scaled == 0) {
+            rounded = 0;
+            exponent = 0;
+            break;
+        }
+        exponent = static_cast<int>(std::floor(std::log10(std::abs(scaled))));
+        double step = std::pow(10.0, exponent - significant + 1);
+        if (unit + 1 == nunits) {
+            step = std::min(step, 1.0); // no larger unit, so whole seconds are always shown.
+        }
+        rounded = std::round(scaled / step) * step;
+        if (unit + 1 < nunits && std::abs(rounded) >= 1000) {
+            scaled /= 1000;
+            ++unit;
+            continue;
+        }
+        if (rounded != 0) {
+            exponent = static_cast<int>(std::floor(std::log10(std::abs(rounded))));
+        }
+        break;
+    }
+
+    // Fixed notation, so that large values in seconds are not printed in scientific notation.
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(std::max(0, significant - 1 - exponent)) << rounded << " " << units[unit];
+    return out.str();
+}
+
+}
+/**
+ * @endcond
+ */
+
+}
+
+#endif
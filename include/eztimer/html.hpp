@@ -0,0 +1,427 @@
+#ifndef EZTIMER_HTML_HPP
+#define EZTIMER_HTML_HPP
+
+#include <vector>
+#include <string>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <ostream>
+#include <iomanip>
+#include <stdexcept>
+#include <algorithm>
+
+#include "eztimer.hpp"
+#include "stats.hpp"
+#include "format.hpp"
+#include "compare.hpp"
+#include "fingerprint.hpp"
+#include "probe.hpp"
+#include "roofline.hpp"
+
+/**
+ * @file html.hpp
+ * @brief Write a self-contained HTML report of the timings.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Options for `write_html_report()`.
+ */
+struct HtmlReportOptions {
+    /**
+     * Title of the report.
+     */
+    std::string title = "eztimer report";
+
+    /**
+     * Name of each function.
+     * If empty, functions are named by their index.
+     */
+    std::vector<std::string> names;
+
+    /**
+     * Index of the baseline function for the speedup table.
+     */
+    std::size_t baseline = 0;
+
+    /**
+     * Confidence level for the intervals of the speedups, see `compare_paired()`.
+     */
+    double confidence = 0.95;
+
+    /**
+     * Number of bins for the density of each violin plot.
+     */
+    std::size_t bins = 64;
+
+    /**
+     * Maximum number of points in the time series of each function.
+     * Longer series are split into this many consecutive buckets, and the minimum, mean and maximum of each bucket are plotted.
+     */
+    std::size_t max_points = 500;
+
+    /**
+     * Fingerprint of the machine on which the timings were collected.
+     * If not set, the fingerprint of the current machine is used.
+     */
+    std::optional<Fingerprint> fingerprint;
+
+    /**
+     * Profile of the machine, typically from `cached_probe()`.
+     * If set, this is included in the report.
+     */
+    std::optional<MachineProfile> profile;
+
+    /**
+     * Roofline for the functions, typically from `roofline()`.
+     * If set, the roofline plot is included in the report.
+     */
+    std::optional<Roofline> roofline;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+struct Downsampled {
+    std::vector<int> iterations;
+    std::vector<double> min, mean, max;
+};
+
+// Splitting the series into consecutive buckets and reporting the envelope
+// of each bucket, so that isolated spikes are still visible after
+// downsampling. This is a single pass regardless of the number of buckets.
+inline Downsampled downsample(const Timings& timings, std::size_t max_points) {
+    Downsampled output;
+    const auto n = timings.times.size();
+    if (n == 0) {
+        return output;
+    }
+
+    const auto nbuckets = std::min(n, std::max(max_points, static_cast<std::size_t>(1)));
+    output.iterations.reserve(nbuckets);
+    output.min.reserve(nbuckets);
+    output.mean.reserve(nbuckets);
+    output.max.reserve(nbuckets);
+
+    const bool has_iterations = (timings.iterations.size() == n);
+    for (std::size_t b = 0; b < nbuckets; ++b) {
+        const std::size_t start = (b * n) / nbuckets, end = ((b + 1) * n) / nbuckets;
+        double lo = std::numeric_limits<double>::infinity(), hi = -lo, total = 0;
+        for (std::size_t i = start; i < end; ++i) {
+            const double current = timings.times[i].count();
+            lo = std::min(lo, current);
+            hi = std::max(hi, current);
+            total += current;
+        }
+        output.iterations.push_back(has_iterations ? timings.iterations[start] : static_cast<int>(start));
+        output.min.push_back(lo);
+        output.mean.push_back(total / (end - start));
+        output.max.push_back(hi);
+    }
+
+    return output;
+}
+
+inline const char* report_colour(std::size_t i) {
+    static const std::array<const char*, 10> palette { "#1f77b4", "#ff7f0e", "#2ca02c", "#d62728", "#9467bd", "#8c564b", "#e377c2", "#7f7f7f", "#bcbd22", "#17becf" };
+    return palette[i % palette.size()];
+}
+
+struct LogAxis {
+    LogAxis(double lo, double hi) {
+        lower = std::floor(std::log10(lo));
+        upper = std::ceil(std::log10(hi));
+        if (upper <= lower) {
+            upper = lower + 1;
+        }
+    }
+
+    double lower, upper;
+
+    double scale(double x) const {
+        return (std::log10(x) - lower) / (upper - lower);
+    }
+};
+
+inline void write_log_ticks(std::ostringstream& buffer, const LogAxis& axis, double left, double right, double top, double bottom) {
+    for (double d = axis.lower; d <= axis.upper; ++d) {
+        const double y = bottom - (d - axis.lower) / (axis.upper - axis.lower) * (bottom - top);
+        buffer << "<line x1=\"" << left << "\" y1=\"" << y << "\" x2=\"" << right << "\" y2=\"" << y << "\" stroke=\"#dddddd\"/>\n";
+        buffer << "<text x=\"" << left - 6 << "\" y=\"" << y + 4 << "\" text-anchor=\"end\">" << format_duration(std::pow(10, d), 1) << "</text>\n";
+    }
+}
+
+// Expects sorted times for each function, so that only the positive times
+// are used on the logarithmic axis.
+inline void write_distribution_svg(std::ostringstream& buffer, const std::vector<std::vector<double> >& sorted, const std::vector<std::string>& labels, std::size_t bins) {
+    const auto nfun = sorted.size();
+    double lo = std::numeric_limits<double>::infinity(), hi = 0;
+    for (const auto& cursorted : sorted) {
+        auto first = std::upper_bound(cursorted.begin(), cursorted.end(), 0.0);
+        if (first != cursorted.end()) {
+            lo = std::min(lo, *first);
+            hi = std::max(hi, cursorted.back());
+        }
+    }
+    if (!(hi > 0)) {
+        buffer << "<p>No positive timings to plot.</p>\n";
+        return;
+    }
+    LogAxis axis(lo, hi);
+
+    const double column = 120, left = 80, top = 20, plot_height = 300;
+    const double width = left + column * nfun + 20, height = top + plot_height + 40, bottom = top + plot_height;
+    auto ypos = [&](double x) -> double { return bottom - axis.scale(x) * plot_height; };
+
+    buffer << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width << "\" height=\"" << height << "\" font-family=\"sans-serif\" font-size=\"11\">\n";
+    write_log_ticks(buffer, axis, left, width - 20, top, bottom);
+
+    bins = std::max(bins, static_cast<std::size_t>(2));
+    std::vector<std::size_t> counts(bins);
+    std::vector<double> positive;
+    for (std::size_t f = 0; f < nfun; ++f) {
+        const double centre = left + column * (f + 0.5);
+        const char* colour = report_colour(f);
+        buffer << "<text x=\"" << centre << "\" y=\"" << bottom + 20 << "\" text-anchor=\"middle\">" << xml_escape(labels[f]) << "</text>\n";
+
+        positive.assign(std::upper_bound(sorted[f].begin(), sorted[f].end(), 0.0), sorted[f].end());
+        if (positive.empty()) {
+            continue;
+        }
+
+        // Violin from a histogram of the log-times, which is linear in the number of timings.
+        std::fill(counts.begin(), counts.end(), 0);
+        for (auto x : positive) {
+            const auto b = static_cast<std::size_t>(axis.scale(x) * bins);
+            ++counts[std::min(b, bins - 1)];
+        }
+        const double maxcount = *std::max_element(counts.begin(), counts.end());
+        const double halfwidth = column * 0.4;
+        std::ostringstream right, leftside;
+        right.precision(buffer.precision());
+        leftside.precision(buffer.precision());
+        for (std::size_t b = 0; b < bins; ++b) {
+            const double y = bottom - (b + 0.5) / bins * plot_height;
+            const double w = counts[b] / maxcount * halfwidth;
+            right << " " << centre + w << "," << y;
+        }
+        for (std::size_t b = bins; b > 0; --b) {
+            const double y = bottom - (b - 0.5) / bins * plot_height;
+            const double w = counts[b - 1] / maxcount * halfwidth;
+            leftside << " " << centre - w << "," << y;
+        }
+        buffer << "<polygon points=\"" << right.str() << leftside.str() << "\" fill=\"" << colour << "\" fill-opacity=\"0.3\" stroke=\"" << colour << "\"/>\n";
+
+        // Box from the quartiles, with whiskers at the 5th and 95th percentiles.
+        const double q05 = sorted_quantile(positive, 0.05), q25 = sorted_quantile(positive, 0.25), q50 = sorted_quantile(positive, 0.5);
+        const double q75 = sorted_quantile(positive, 0.75), q95 = sorted_quantile(positive, 0.95);
+        const double boxwidth = column * 0.08;
+        buffer << "<line x1=\"" << centre << "\" y1=\"" << ypos(q05) << "\" x2=\"" << centre << "\" y2=\"" << ypos(q95) << "\" stroke=\"black\"/>\n";
+        buffer << "<rect x=\"" << centre - boxwidth << "\" y=\"" << ypos(q75) << "\" width=\"" << 2 * boxwidth << "\" height=\"" << ypos(q25) - ypos(q75)
+            << "\" fill=\"white\" stroke=\"black\"><title>" << xml_escape(labels[f]) << ": median " << format_duration(q50, 4)
+            << ", IQR " << format_duration(q25, 4) << " to " << format_duration(q75, 4) << "</title></rect>\n";
+        buffer << "<line x1=\"" << centre - boxwidth << "\" y1=\"" << ypos(q50) << "\" x2=\"" << centre + boxwidth << "\" y2=\"" << ypos(q50) << "\" stroke=\"black\" stroke-width=\"2\"/>\n";
+    }
+
+    buffer << "<rect x=\"" << left << "\" y=\"" << top << "\" width=\"" << width - 20 - left << "\" height=\"" << plot_height << "\" fill=\"none\" stroke=\"black\"/>\n";
+    buffer << "</svg>\n";
+}
+
+inline void write_series_svg(std::ostringstream& buffer, const std::vector<Downsampled>& series, const std::vector<std::string>& labels) {
+    double lo = std::numeric_limits<double>::infinity(), hi = 0;
+    int last = 1;
+    for (const auto& current : series) {
+        for (std::size_t i = 0; i < current.mean.size(); ++i) {
+            if (current.min[i] > 0) {
+                lo = std::min(lo, current.min[i]);
+            }
+            hi = std::max(hi, current.max[i]);
+        }
+        if (!current.iterations.empty()) {
+            last = std::max(last, current.iterations.back());
+        }
+    }
+    if (!(hi > 0)) {
+        buffer << "<p>No positive timings to plot.</p>\n";
+        return;
+    }
+    LogAxis axis(lo, hi);
+
+    const double left = 80, right = 160, top = 20, plot_width = 640, plot_height = 300;
+    const double width = left + plot_width + right, height = top + plot_height + 50, bottom = top + plot_height;
+    auto xpos = [&](int i) -> double { return left + static_cast<double>(i) / last * plot_width; };
+    auto ypos = [&](double x) -> double { return bottom - axis.scale(std::max(x, lo)) * plot_height; };
+
+    buffer << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width << "\" height=\"" << height << "\" font-family=\"sans-serif\" font-size=\"11\">\n";
+    write_log_ticks(buffer, axis, left, left + plot_width, top, bottom);
+    buffer << "<text x=\"" << left << "\" y=\"" << bottom + 16 << "\" text-anchor=\"middle\">0</text>\n";
+    buffer << "<text x=\"" << left + plot_width << "\" y=\"" << bottom + 16 << "\" text-anchor=\"middle\">" << last << "</text>\n";
+    buffer << "<text x=\"" << left + plot_width / 2 << "\" y=\"" << bottom + 36 << "\" text-anchor=\"middle\">Iteration</text>\n";
+
+    for (std::size_t f = 0; f < series.size(); ++f) {
+        const auto& current = series[f];
+        const char* colour = report_colour(f);
+        if (!current.mean.empty()) {
+            // Envelope of each bucket, followed by the mean.
+            buffer << "<polygon fill=\"" << colour << "\" fill-opacity=\"0.2\" stroke=\"none\" points=\"";
+            for (std::size_t i = 0; i < current.max.size(); ++i) {
+                buffer << xpos(current.iterations[i]) << "," << ypos(current.max[i]) << " ";
+            }
+            for (std::size_t i = current.min.size(); i > 0; --i) {
+                buffer << xpos(current.iterations[i - 1]) << "," << ypos(current.min[i - 1]) << " ";
+            }
+            buffer << "\"/>\n";
+
+            buffer << "<polyline fill=\"none\" stroke=\"" << colour << "\" points=\"";
+            for (std::size_t i = 0; i < current.mean.size(); ++i) {
+                buffer << xpos(current.iterations[i]) << "," << ypos(current.mean[i]) << " ";
+            }
+            buffer << "\"/>\n";
+        }
+
+        const double legend = top + 10 + 16 * f;
+        buffer << "<rect x=\"" << left + plot_width + 12 << "\" y=\"" << legend - 8 << "\" width=\"10\" height=\"10\" fill=\"" << colour << "\"/>\n";
+        buffer << "<text x=\"" << left + plot_width + 28 << "\" y=\"" << legend + 1 << "\">" << xml_escape(labels[f]) << "</text>\n";
+    }
+
+    buffer << "<rect x=\"" << left << "\" y=\"" << top << "\" width=\"" << plot_width << "\" height=\"" << plot_height << "\" fill=\"none\" stroke=\"black\"/>\n";
+    buffer << "</svg>\n";
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Write a self-contained HTML report of the timings, with inline SVG plots and no external assets, e.g., for sharing results.
+ * The report contains:
+ *
+ * - A summary table with the mean, standard deviation and median of each function.
+ * - Violin plots of the distribution of times for each function, overlaid with box plots of the quartiles and the 5th and 95th percentiles.
+ * - Time series of each function across iterations, to show the effects of warm-up and drift.
+ * - A table of the speedup of each function relative to the baseline, with confidence intervals from `compare_paired()`.
+ * - The fingerprint of the machine, along with the machine profile and roofline plot if supplied.
+ *
+ * The violin plots use a histogram with a fixed number of bins and the time series are downsampled to a fixed number of points,
+ * so the size of the report does not depend on the number of timings.
+ *
+ * @param out Output stream.
+ * @param timings Timings for each function, typically from `time()`.
+ * @param opt Further options.
+ */
+inline void write_html_report(std::ostream& out, const std::vector<Timings>& timings, const HtmlReportOptions& opt = HtmlReportOptions()) {
+    const auto nfun = timings.size();
+    std::vector<std::string> labels;
+    labels.reserve(nfun);
+    if (opt.names.empty()) {
+        for (std::size_t f = 0; f < nfun; ++f) {
+            labels.push_back(std::to_string(f));
+        }
+    } else if (opt.names.size() != nfun) {
+        throw std::runtime_error("length of 'names' should be equal to the number of functions");
+    } else {
+        labels = opt.names;
+    }
+    if (nfun && opt.baseline >= nfun) {
+        throw std::runtime_error("'baseline' should be less than the number of functions");
+    }
+
+    std::ostringstream buffer;
+    buffer << std::setprecision(6);
+    const auto title = internal::xml_escape(opt.title);
+    buffer << "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n<title>" << title << "</title>\n";
+    buffer << "<style>\n"
+        << "body { font-family: sans-serif; margin: 2em; color: #222; }\n"
+        << "table { border-collapse: collapse; margin-bottom: 1em; }\n"
+        << "th, td { border: 1px solid #ccc; padding: 0.3em 0.6em; text-align: right; }\n"
+        << "th:first-child, td:first-child { text-align: left; }\n"
+        << ".significant { font-weight: bold; }\n"
+        << "pre { background: #f6f6f6; padding: 0.5em; }\n"
+        << "</style>\n</head>\n<body>\n";
+    buffer << "<h1>" << title << "</h1>\n";
+
+    buffer << "<h2>Summary</h2>\n<table>\n<tr><th>Function</th><th>Runs</th><th>Mean</th><th>SD</th><th>Median</th></tr>\n";
+    std::vector<std::vector<double> > sorted(nfun);
+    for (std::size_t f = 0; f < nfun; ++f) {
+        const auto& curtime = timings[f];
+        auto& cursorted = sorted[f];
+        cursorted.reserve(curtime.times.size());
+        for (auto t : curtime.times) {
+            cursorted.push_back(t.count());
+        }
+        std::sort(cursorted.begin(), cursorted.end());
+        const double median = (cursorted.empty() ? std::numeric_limits<double>::quiet_NaN() : internal::sorted_quantile(cursorted, 0.5));
+        buffer << "<tr><td>" << internal::xml_escape(labels[f]) << "</td><td>" << curtime.times.size() << "</td><td>" << internal::format_duration(curtime.mean.count(), 4)
+            << "</td><td>" << internal::format_duration(curtime.sd.count(), 4) << "</td><td>" << internal::format_duration(median, 4) << "</td></tr>\n";
+    }
+    buffer << "</table>\n";
+
+    buffer << "<h2>Distributions</h2>\n";
+    internal::write_distribution_svg(buffer, sorted, labels, opt.bins);
+
+    buffer << "<h2>Time series</h2>\n";
+    std::vector<internal::Downsampled> series;
+    series.reserve(nfun);
+    for (const auto& curtime : timings) {
+        series.push_back(internal::downsample(curtime, opt.max_points));
+    }
+    internal::write_series_svg(buffer, series, labels);
+
+    if (nfun > 1) {
+        CompareOptions copt;
+        copt.confidence = opt.confidence;
+        buffer << "<h2>Speedups</h2>\n<p>Speedup of each function relative to " << internal::xml_escape(labels[opt.baseline])
+            << ", with " << opt.confidence * 100 << "% confidence intervals. Significant differences are shown in bold.</p>\n";
+        buffer << "<table>\n<tr><th>Function</th><th>Pairs</th><th>Speedup</th><th>Lower</th><th>Upper</th></tr>\n";
+        for (std::size_t f = 0; f < nfun; ++f) {
+            if (f == opt.baseline) {
+                continue;
+            }
+
+            // Inverting the ratio of runtimes so that values above 1 are faster than the baseline.
+            auto comp = compare_paired(timings[opt.baseline], timings[f], copt);
+            buffer << "<tr" << (comp.significant ? " class=\"significant\"" : "") << "><td>" << internal::xml_escape(labels[f]) << "</td><td>" << comp.pairs
+                << "</td><td>" << 1 / comp.ratio << "</td><td>" << 1 / comp.upper << "</td><td>" << 1 / comp.lower << "</td></tr>\n";
+        }
+        buffer << "</table>\n";
+    }
+
+    if (opt.roofline.has_value()) {
+        buffer << "<h2>Roofline</h2>\n";
+        std::ostringstream svg;
+        write_roofline_svg(svg, *(opt.roofline), (opt.roofline->points.size() == nfun ? labels : std::vector<std::string>()));
+        buffer << svg.str();
+    }
+
+    buffer << "<h2>Environment</h2>\n<table>\n";
+    const auto fingerprint = (opt.fingerprint.has_value() ? *(opt.fingerprint) : machine_fingerprint());
+    buffer << "<tr><td>Identifier</td><td>" << fingerprint_id(fingerprint) << "</td></tr>\n";
+    buffer << "<tr><td>Host</td><td>" << internal::xml_escape(fingerprint.hostname) << "</td></tr>\n";
+    buffer << "<tr><td>CPU</td><td>" << internal::xml_escape(fingerprint.cpu_model) << "</td></tr>\n";
+    buffer << "<tr><td>Threads</td><td>" << fingerprint.cpus << "</td></tr>\n";
+    buffer << "<tr><td>Memory</td><td>" << fingerprint.memory << " bytes</td></tr>\n";
+    buffer << "<tr><td>OS</td><td>" << internal::xml_escape(fingerprint.os) << "</td></tr>\n";
+    buffer << "<tr><td>Compiler</td><td>" << internal::xml_escape(fingerprint.compiler) << "</td></tr>\n";
+    buffer << "</table>\n";
+
+    if (opt.profile.has_value()) {
+        std::ostringstream profile;
+        write_machine_profile(profile, *(opt.profile));
+        buffer << "<h3>Machine profile</h3>\n<pre>" << internal::xml_escape(profile.str()) << "</pre>\n";
+    }
+
+    buffer << "</body>\n</html>\n";
+    out << buffer.str();
+}
+
+}
+
+#endif
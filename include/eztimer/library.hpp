@@ -0,0 +1,115 @@
+#ifndef EZTIMER_LIBRARY_HPP
+#define EZTIMER_LIBRARY_HPP
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <stdexcept>
+
+#include <dlfcn.h>
+
+/**
+ * @file library.hpp
+ * @brief Load functions from different builds of a shared library.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Shared library that is loaded with `dlopen()`.
+ *
+ * The library is opened with `RTLD_NOW | RTLD_LOCAL` so that its symbols are not made available to subsequently loaded libraries.
+ * Where available (i.e., glibc), `RTLD_DEEPBIND` is also used so that the library resolves its own symbols in preference to those already loaded into the process.
+ * This allows different builds of the same library to be loaded side-by-side, as long as they are located at different paths.
+ *
+ * Copies of a `SharedLibrary` refer to the same handle, which is closed with `dlclose()` once all copies (and all functions from `SharedLibrary::function()`) are destroyed.
+ */
+class SharedLibrary {
+public:
+    /**
+     * @param path Path to the shared library.
+     * This should contain a slash, otherwise `dlopen()` will search the library paths.
+     */
+    SharedLibrary(const std::string& path) : my_path(path) {
+        int flags = RTLD_NOW | RTLD_LOCAL;
+#ifdef RTLD_DEEPBIND
+        flags |= RTLD_DEEPBIND;
+#endif
+        void* handle = dlopen(path.c_str(), flags);
+        if (handle == NULL) {
+            const char* msg = dlerror();
+            throw std::runtime_error("failed to load '" + path + "'" + (msg ? std::string(": ") + msg : std::string()));
+        }
+        my_handle.reset(handle, [](void* ptr) -> void { dlclose(ptr); });
+    }
+
+public:
+    /**
+     * @return Path to the shared library.
+     */
+    const std::string& path() const {
+        return my_path;
+    }
+
+    /**
+     * @param name Name of the symbol.
+     * @return Address of the symbol in this library.
+     * An error is thrown if the symbol cannot be found.
+     */
+    void* symbol(const std::string& name) const {
+        dlerror();
+        void* ptr = dlsym(my_handle.get(), name.c_str());
+        if (ptr == NULL) {
+            const char* msg = dlerror();
+            throw std::runtime_error("failed to find '" + name + "' in '" + my_path + "'" + (msg ? std::string(": ") + msg : std::string()));
+        }
+        return ptr;
+    }
+
+    /**
+     * @param name Name of a function with no arguments that returns a `Result_`.
+     * This should usually be declared with C linkage to avoid name mangling.
+     * @return The function from this library.
+     * This keeps the library open for as long as it exists.
+     *
+     * @tparam Result_ Result of the function call.
+     */
+    template<typename Result_>
+    std::function<Result_()> function(const std::string& name) const {
+        auto ptr = reinterpret_cast<Result_(*)()>(symbol(name));
+        auto handle = my_handle;
+        return [ptr, handle]() -> Result_ { return ptr(); };
+    }
+
+private:
+    std::string my_path;
+    std::shared_ptr<void> my_handle;
+};
+
+/**
+ * Load the same entry point from different builds of a shared library, e.g., an old and new version.
+ * The returned functions can be passed directly to `time()` so that the builds are interleaved in each iteration.
+ * Their timings can then be compared with `compare_paired()`.
+ *
+ * @param paths Paths to the shared libraries.
+ * @param name Name of a function with no arguments that returns a `Result_`, see `SharedLibrary::function()`.
+ *
+ * @return Vector of length equal to `paths.size()`, containing the entry point from each library.
+ *
+ * @tparam Result_ Result of each function call.
+ */
+template<typename Result_>
+std::vector<std::function<Result_()> > load_functions(const std::vector<std::string>& paths, const std::string& name) {
+    std::vector<std::function<Result_()> > output;
+    output.reserve(paths.size());
+    for (const auto& p : paths) {
+        SharedLibrary lib(p);
+        output.push_back(lib.template function<Result_>(name));
+    }
+    return output;
+}
+
+}
+
+#endif
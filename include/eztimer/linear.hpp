@@ -0,0 +1,234 @@
+#ifndef EZTIMER_LINEAR_HPP
+#define EZTIMER_LINEAR_HPP
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+#include <functional>
+
+#include "eztimer.hpp"
+#include "stats.hpp"
+
+/**
+ * @file linear.hpp
+ * @brief Estimate the per-call cost by regression over batch sizes.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Options for `time_linear()`.
+ */
+struct LinearOptions {
+    /**
+     * Number of calls to add to the batch size at each iteration.
+     * The batch size for the `i`-th iteration (starting from zero) is `(i + 1) * step`.
+     */
+    int step = 1;
+
+    /**
+     * Confidence level for the interval of the slope.
+     */
+    double confidence = 0.95;
+
+    /**
+     * Further options to pass to `time()`.
+     * `Options::iterations` determines the largest batch size, i.e., `Options::iterations * step`.
+     * Burn-in iterations use a batch size of `step`.
+     */
+    Options timing;
+};
+
+/**
+ * @brief Linear regression of batch times on batch sizes for a function.
+ */
+struct LinearTimings {
+    /**
+     * Number of calls in each batch, parallel to `Timings::times` in `timings`.
+     */
+    std::vector<int> batch_sizes;
+
+    /**
+     * Timings for each batch, as reported by `time()`.
+     * Note that `Timings::mean` and `Timings::sd` are computed across batches of different sizes and are not directly interpretable.
+     */
+    Timings timings;
+
+    /**
+     * Ordinary least squares estimate of the slope, i.e., the cost per call.
+     */
+    std::chrono::duration<double> slope = std::chrono::duration<double>(std::numeric_limits<double>::quiet_NaN());
+
+    /**
+     * Lower bound of the confidence interval for `slope`.
+     */
+    std::chrono::duration<double> lower = std::chrono::duration<double>(std::numeric_limits<double>::quiet_NaN());
+
+    /**
+     * Upper bound of the confidence interval for `slope`.
+     */
+    std::chrono::duration<double> upper = std::chrono::duration<double>(std::numeric_limits<double>::quiet_NaN());
+
+    /**
+     * Ordinary least squares estimate of the intercept, i.e., the fixed overhead per batch.
+     */
+    std::chrono::duration<double> intercept = std::chrono::duration<double>(std::numeric_limits<double>::quiet_NaN());
+
+    /**
+     * Coefficient of determination for the ordinary least squares fit.
+     */
+    double r_squared = std::numeric_limits<double>::quiet_NaN();
+
+    /**
+     * Theil-Sen estimate of the slope, i.e., the median of the slopes between all pairs of batches with different sizes.
+     * This is robust to outlying batches.
+     */
+    std::chrono::duration<double> theil_sen_slope = std::chrono::duration<double>(std::numeric_limits<double>::quiet_NaN());
+
+    /**
+     * Theil-Sen estimate of the intercept, i.e., the median of the residuals after subtracting `theil_sen_slope` times the batch size.
+     */
+    std::chrono::duration<double> theil_sen_intercept = std::chrono::duration<double>(std::numeric_limits<double>::quiet_NaN());
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+inline void fit_linear(LinearTimings& output, double confidence) {
+    const auto n = output.batch_sizes.size();
+    if (n < 2) {
+        return;
+    }
+
+    double xmean = 0, ymean = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        xmean += output.batch_sizes[i];
+        ymean += output.timings.times[i].count();
+    }
+    xmean /= n;
+    ymean /= n;
+
+    double sxx = 0, sxy = 0, syy = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double dx = output.batch_sizes[i] - xmean;
+        const double dy = output.timings.times[i].count() - ymean;
+        sxx += dx * dx;
+        sxy += dx * dy;
+        syy += dy * dy;
+    }
+    if (sxx == 0) {
+        return;
+    }
+
+    const double slope = sxy / sxx;
+    const double intercept = ymean - slope * xmean;
+    output.slope = std::chrono::duration<double>(slope);
+    output.intercept = std::chrono::duration<double>(intercept);
+
+    const double sse = std::max(0.0, syy - slope * sxy);
+    output.r_squared = (syy > 0 ? 1 - sse / syy : 1);
+    if (n > 2) {
+        const double se = std::sqrt(sse / (n - 2) / sxx);
+        const double quant = t_quantile(1 - (1 - confidence) / 2, n - 2);
+        output.lower = std::chrono::duration<double>(slope - quant * se);
+        output.upper = std::chrono::duration<double>(slope + quant * se);
+    }
+
+    std::vector<double> slopes;
+    slopes.reserve(n * (n - 1) / 2);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = i + 1; j < n; ++j) {
+            const double dx = output.batch_sizes[j] - output.batch_sizes[i];
+            if (dx != 0) {
+                slopes.push_back((output.timings.times[j].count() - output.timings.times[i].count()) / dx);
+            }
+        }
+    }
+    std::sort(slopes.begin(), slopes.end());
+    const double ts_slope = sorted_quantile(slopes, 0.5);
+
+    std::vector<double> residuals;
+    residuals.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        residuals.push_back(output.timings.times[i].count() - ts_slope * output.batch_sizes[i]);
+    }
+    std::sort(residuals.begin(), residuals.end());
+    output.theil_sen_slope = std::chrono::duration<double>(ts_slope);
+    output.theil_sen_intercept = std::chrono::duration<double>(sorted_quantile(residuals, 0.5));
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Estimate the cost of each call for very fast functions, where per-call timings would be dominated by fixed overhead (e.g., from reading the clock).
+ * In each iteration, each function is called in a batch of increasing size, i.e., `1 * step`, `2 * step`, etc.; the time for the entire batch is recorded.
+ * The batch times are then regressed on the batch sizes, such that the slope is the cost per call and the fixed overhead is absorbed by the intercept.
+ * This is the same approach as used by the Criterion benchmarking library.
+ *
+ * @param funs Vector of functions to be timed.
+ * Each function should return a value that depends on the computation of interest, see `time()` for details.
+ * @param check Function that accepts a `Result_` and an index of `funs`, see `time()` for details.
+ * This is only called on the result of the last call in each batch.
+ * @param opt Further options.
+ *
+ * @return Vector of length equal to `funs.size()`, containing the regression results for each function.
+ *
+ * @tparam Result_ Result of each function call.
+ */
+template<typename Result_>
+std::vector<LinearTimings> time_linear(
+    const std::vector<std::function<Result_()> >& funs,
+    const std::function<void(const Result_&, std::size_t)>& check,
+    const LinearOptions& opt
+) {
+    const auto nfun = funs.size();
+    const int step = std::max(opt.step, 1);
+    int batch = step;
+    int iteration = 0;
+
+    auto topt = opt.timing;
+    topt.setup = [&]() -> void {
+        batch = std::max(iteration - opt.timing.burn_in + 1, 1) * step;
+        ++iteration;
+        if (opt.timing.setup) {
+            opt.timing.setup();
+        }
+    };
+
+    std::vector<std::function<Result_()> > wrapped;
+    wrapped.reserve(nfun);
+    for (const auto& f : funs) {
+        wrapped.emplace_back([&f, &batch]() -> Result_ {
+            for (int b = 1; b < batch; ++b) {
+                f();
+            }
+            return f();
+        });
+    }
+
+    auto timings = time<Result_>(wrapped, check, topt);
+
+    std::vector<LinearTimings> output(nfun);
+    for (std::size_t f = 0; f < nfun; ++f) {
+        auto& curout = output[f];
+        curout.timings = std::move(timings[f]);
+        curout.batch_sizes.reserve(curout.timings.iterations.size());
+        for (auto i : curout.timings.iterations) {
+            curout.batch_sizes.push_back((i + 1) * step);
+        }
+        internal::fit_linear(curout, opt.confidence);
+    }
+
+    return output;
+}
+
+}
+
+#endif
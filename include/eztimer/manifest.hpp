@@ -0,0 +1,886 @@
+#ifndef EZTIMER_MANIFEST_HPP
+#define EZTIMER_MANIFEST_HPP
+
+#include <vector>
+#include <string>
+#include <map>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <optional>
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include <ostream>
+#include <istream>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+
+#include "eztimer.hpp"
+#include "counters.hpp"
+#include "console.hpp"
+#include "html.hpp"
+#include "columnar.hpp"
+#include "store.hpp"
+#include "fingerprint.hpp"
+#include "probe.hpp"
+
+/**
+ * @file manifest.hpp
+ * @brief Run registered benchmarks from a manifest file.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Parameters for a single instance of a registered benchmark.
+ *
+ * Each parameter is stored as a string, as specified in the manifest, and converted on request.
+ */
+class BenchmarkParameters {
+public:
+    /**
+     * @cond
+     */
+    BenchmarkParameters() = default;
+
+    BenchmarkParameters(std::vector<std::pair<std::string, std::string> > values) : my_values(std::move(values)) {}
+    /**
+     * @endcond
+     */
+
+    /**
+     * @return All parameters as name-value pairs, in the order of their appearance in the manifest.
+     */
+    const std::vector<std::pair<std::string, std::string> >& values() const {
+        return my_values;
+    }
+
+    /**
+     * @param name Name of the parameter.
+     * @return Whether the parameter is present.
+     */
+    bool has(const std::string& name) const {
+        return find(name) != NULL;
+    }
+
+    /**
+     * @param name Name of the parameter.
+     * @return Value of the parameter.
+     * An error is raised if the parameter is not present.
+     */
+    const std::string& get(const std::string& name) const {
+        auto ptr = find(name);
+        if (ptr == NULL) {
+            throw std::runtime_error("no value for parameter '" + name + "'");
+        }
+        return *ptr;
+    }
+
+    /**
+     * @param name Name of the parameter.
+     * @param fallback Value to return if the parameter is not present.
+     * @return Value of the parameter.
+     */
+    std::string get(const std::string& name, const std::string& fallback) const {
+        auto ptr = find(name);
+        return (ptr == NULL ? fallback : *ptr);
+    }
+
+    /**
+     * @param name Name of the parameter.
+     * @return Value of the parameter as an integer.
+     * An error is raised if the parameter is not present or is not an integer.
+     */
+    long long get_integer(const std::string& name) const {
+        const auto& value = get(name);
+        std::size_t used = 0;
+        long long output = 0;
+        try {
+            output = std::stoll(value, &used);
+        } catch (std::exception&) {
+            used = 0;
+        }
+        if (used == 0 || used != value.size()) {
+            throw std::runtime_error("parameter '" + name + "' should be an integer, got '" + value + "'");
+        }
+        return output;
+    }
+
+    /**
+     * @param name Name of the parameter.
+     * @param fallback Value to return if the parameter is not present.
+     * @return Value of the parameter as an integer.
+     * An error is raised if the parameter is present but is not an integer.
+     */
+    long long get_integer(const std::string& name, long long fallback) const {
+        return (has(name) ? get_integer(name) : fallback);
+    }
+
+    /**
+     * @param name Name of the parameter.
+     * @return Value of the parameter as a floating-point number.
+     * An error is raised if the parameter is not present or is not a number.
+     */
+    double get_number(const std::string& name) const {
+        const auto& value = get(name);
+        std::size_t used = 0;
+        double output = 0;
+        try {
+            output = std::stod(value, &used);
+        } catch (std::exception&) {
+            used = 0;
+        }
+        if (used == 0 || used != value.size()) {
+            throw std::runtime_error("parameter '" + name + "' should be a number, got '" + value + "'");
+        }
+        return output;
+    }
+
+    /**
+     * @param name Name of the parameter.
+     * @param fallback Value to return if the parameter is not present.
+     * @return Value of the parameter as a floating-point number.
+     * An error is raised if the parameter is present but is not a number.
+     */
+    double get_number(const std::string& name, double fallback) const {
+        return (has(name) ? get_number(name) : fallback);
+    }
+
+private:
+    std::vector<std::pair<std::string, std::string> > my_values;
+
+    const std::string* find(const std::string& name) const {
+        for (const auto& val : my_values) {
+            if (val.first == name) {
+                return &(val.second);
+            }
+        }
+        return NULL;
+    }
+};
+
+/**
+ * @brief Registry of benchmarks that can be selected by name in a manifest.
+ *
+ * Each benchmark is registered as a factory that creates the function to be timed from a set of parameters.
+ * This allows a manifest to choose the benchmarks, their options and their parameters at runtime, without recompiling the program.
+ */
+class BenchmarkRegistry {
+public:
+    /**
+     * Register a benchmark.
+     * An error is raised if a benchmark of the same name was already registered.
+     *
+     * All instances of the benchmark are timed with a single call to `time<Result_>()`, so the results are handled exactly as in `time()`.
+     * In particular, `check` is called and each result is destroyed outside of the timed region.
+     *
+     * @param name Name of the benchmark, to be used in the manifest.
+     * @param factory Function that accepts the parameters for an instance of the benchmark, and returns the function to be timed.
+     * The returned function should return a value that depends on the computation of interest, see `time()` for details.
+     * @param check Function that accepts the result of the timed function and performs some kind of check on it.
+     * Ignored if empty.
+     *
+     * @tparam Result_ Result of each function call.
+     */
+    template<typename Result_>
+    void add(
+        const std::string& name,
+        std::function<std::function<Result_()>(const BenchmarkParameters&)> factory,
+        std::function<void(const Result_&)> check = std::function<void(const Result_&)>())
+    {
+        if (my_runners.find(name) != my_runners.end()) {
+            throw std::runtime_error("benchmark '" + name + "' is already registered");
+        }
+
+        my_runners[name] = [factory = std::move(factory), check = std::move(check)](const std::vector<BenchmarkParameters>& settings, const Options& opt) -> std::vector<Timings> {
+            std::vector<std::function<Result_()> > funs;
+            funs.reserve(settings.size());
+            for (const auto& params : settings) {
+                funs.push_back(factory(params));
+            }
+            return time<Result_>(
+                funs,
+                [&](const Result_& res, std::size_t) -> void {
+                    if (check) {
+                        check(res);
+                    }
+                },
+                opt
+            );
+        };
+    }
+
+    /**
+     * @param name Name of the benchmark.
+     * @return Whether the benchmark is registered.
+     */
+    bool has(const std::string& name) const {
+        return my_runners.find(name) != my_runners.end();
+    }
+
+    /**
+     * @return Names of all registered benchmarks, in sorted order.
+     */
+    std::vector<std::string> names() const {
+        std::vector<std::string> output;
+        output.reserve(my_runners.size());
+        for (const auto& entry : my_runners) {
+            output.push_back(entry.first);
+        }
+        return output;
+    }
+
+    /**
+     * Time all instances of a registered benchmark.
+     * An error is raised if the benchmark is not registered.
+     *
+     * @param name Name of the benchmark.
+     * @param settings Parameters for each instance of the benchmark.
+     * @param opt Options to pass to `time()`.
+     *
+     * @return Timings for each instance in `settings`.
+     */
+    std::vector<Timings> run(const std::string& name, const std::vector<BenchmarkParameters>& settings, const Options& opt) const {
+        auto it = my_runners.find(name);
+        if (it == my_runners.end()) {
+            throw std::runtime_error("benchmark '" + name + "' is not registered");
+        }
+        return (it->second)(settings, opt);
+    }
+
+private:
+    std::map<std::string, std::function<std::vector<Timings>(const std::vector<BenchmarkParameters>&, const Options&)> > my_runners;
+};
+
+/**
+ * @brief Benchmark section of a manifest.
+ */
+struct ManifestBenchmark {
+    /**
+     * Name of the section, used to label the results.
+     */
+    std::string name;
+
+    /**
+     * Name of the registered benchmark to run.
+     * This defaults to `name` if the `function` key is not present.
+     */
+    std::string function;
+
+    /**
+     * Whether to run this benchmark, from the `enabled` key.
+     */
+    bool enabled = true;
+
+    /**
+     * Options for `time()`, starting from `Manifest::defaults` and overridden by any keys in this section.
+     */
+    Options options;
+
+    /**
+     * Grid of parameters, from the `param.<name>` keys.
+     * Each entry contains the name of the parameter and its values.
+     * Instances are formed from all combinations of values, with the first parameter changing fastest.
+     */
+    std::vector<std::pair<std::string, std::vector<std::string> > > parameters;
+};
+
+/**
+ * @brief Output sinks for `run_manifest()`, from the `[output]` section of the manifest.
+ */
+struct ManifestOutputs {
+    /**
+     * Whether to print a summary table for each benchmark with `write_console_report()`, from the `console` key.
+     */
+    bool console = true;
+
+    /**
+     * Path to a CSV file with the summary statistics of each instance, from the `csv` key.
+     */
+    std::optional<std::filesystem::path> csv;
+
+    /**
+     * Path to a HTML report from `write_html_report()`, from the `html` key.
+     * If the path contains `{benchmark}`, a separate report is created for each benchmark by replacing it with the benchmark's name.
+     * Otherwise, all instances of all benchmarks are included in a single report.
+     */
+    std::optional<std::filesystem::path> html;
+
+    /**
+     * Path to a columnar file from `write_columnar()`, from the `columnar` key.
+     */
+    std::optional<std::filesystem::path> columnar;
+
+    /**
+     * Path to the directory of a `ResultsStore`, from the `store` key.
+     */
+    std::optional<std::filesystem::path> store;
+
+    /**
+     * Commit to record in the columnar file and the store, from the `commit` key.
+     */
+    std::string commit = "unknown";
+
+    /**
+     * Path to a cached machine profile for `cached_probe()`, from the `profile` key.
+     * If supplied, the profile is embedded in the HTML report and the columnar file, and saved in the store with `ResultsStore::save_profile()`.
+     */
+    std::optional<std::filesystem::path> profile;
+};
+
+/**
+ * @brief Parsed contents of a manifest.
+ */
+struct Manifest {
+    /**
+     * Default options for all benchmarks, from the `[defaults]` section.
+     */
+    Options defaults;
+
+    /**
+     * Benchmarks to run, from the `[benchmark <name>]` sections in order of their appearance.
+     */
+    std::vector<ManifestBenchmark> benchmarks;
+
+    /**
+     * Output sinks.
+     */
+    ManifestOutputs outputs;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+struct ManifestEntry {
+    std::string key;
+    std::string value;
+    std::size_t line;
+};
+
+struct ManifestSection {
+    std::string name;
+    std::size_t line;
+    std::vector<ManifestEntry> entries;
+};
+
+inline std::string trim_manifest(const std::string& x) {
+    const auto first = x.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return std::string();
+    }
+    const auto last = x.find_last_not_of(" \t\r");
+    return x.substr(first, last - first + 1);
+}
+
+inline std::vector<std::string> split_manifest_list(const std::string& value) {
+    std::vector<std::string> output;
+    std::size_t start = 0;
+    while (true) {
+        const auto comma = value.find(',', start);
+        auto current = trim_manifest(value.substr(start, comma == std::string::npos ? std::string::npos : comma - start));
+        if (!current.empty()) {
+            output.push_back(std::move(current));
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    return output;
+}
+
+[[noreturn]] inline void manifest_error(std::size_t line, const std::string& message) {
+    throw std::runtime_error("manifest line " + std::to_string(line) + ": " + message);
+}
+
+inline bool parse_manifest_bool(const ManifestEntry& entry) {
+    if (entry.value == "true" || entry.value == "yes" || entry.value == "on" || entry.value == "1") {
+        return true;
+    }
+    if (entry.value == "false" || entry.value == "no" || entry.value == "off" || entry.value == "0") {
+        return false;
+    }
+    manifest_error(entry.line, "'" + entry.key + "' should be a boolean, got '" + entry.value + "'");
+}
+
+template<typename Type_>
+Type_ parse_manifest_number(const ManifestEntry& entry) {
+    std::istringstream in(entry.value);
+    Type_ output;
+    if (!(in >> output) || !(in >> std::ws).eof()) {
+        manifest_error(entry.line, "'" + entry.key + "' should be a number, got '" + entry.value + "'");
+    }
+    return output;
+}
+
+inline Counter parse_manifest_counter(const ManifestEntry& entry, const std::string& name) {
+    static const std::map<std::string, Counter> mapping {
+        { "cycles", Counter::CYCLES },
+        { "instructions", Counter::INSTRUCTIONS },
+        { "cache_misses", Counter::CACHE_MISSES },
+        { "branch_misses", Counter::BRANCH_MISSES },
+        { "dtlb_misses", Counter::DTLB_MISSES },
+        { "page_faults", Counter::PAGE_FAULTS },
+        { "context_switches", Counter::CONTEXT_SWITCHES }
+    };
+    auto it = mapping.find(name);
+    if (it == mapping.end()) {
+        manifest_error(entry.line, "unknown counter '" + name + "'");
+    }
+    return it->second;
+}
+
+// Returns false if the key is not an option, so that the caller can check
+// for section-specific keys.
+inline bool apply_manifest_option(Options& opt, const ManifestEntry& entry) {
+    if (entry.key == "iterations") {
+        opt.iterations = parse_manifest_number<int>(entry);
+    } else if (entry.key == "burn_in") {
+        opt.burn_in = parse_manifest_number<int>(entry);
+    } else if (entry.key == "seed") {
+        opt.seed = parse_manifest_number<unsigned long long>(entry);
+    } else if (entry.key == "max_time_per_function") {
+        opt.max_time_per_function = std::chrono::duration<double>(parse_manifest_number<double>(entry));
+    } else if (entry.key == "max_time_total") {
+        opt.max_time_total = std::chrono::duration<double>(parse_manifest_number<double>(entry));
+    } else if (entry.key == "record_cpu") {
+        opt.record_cpu = parse_manifest_bool(entry);
+    } else if (entry.key == "counters") {
+        opt.counters.clear();
+        for (const auto& name : split_manifest_list(entry.value)) {
+            opt.counters.push_back(parse_manifest_counter(entry, name));
+        }
+    } else {
+        return false;
+    }
+
+    if (opt.iterations < 0 || opt.burn_in < 0) {
+        manifest_error(entry.line, "'" + entry.key + "' should be non-negative");
+    }
+    return true;
+}
+
+inline std::string manifest_instance_name(const std::string& benchmark, const BenchmarkParameters& params) {
+    if (params.values().empty()) {
+        return benchmark;
+    }
+    std::string output = benchmark + "[";
+    bool first = true;
+    for (const auto& val : params.values()) {
+        if (!first) {
+            output += ",";
+        }
+        output += val.first + "=" + val.second;
+        first = false;
+    }
+    output += "]";
+    return output;
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Parse a manifest in an INI-like format.
+ * Lines starting with `#` or `;` are treated as comments, and each key-value pair is specified as `key = value`.
+ * The manifest may contain the following sections:
+ *
+ * - `[defaults]`, containing default options for all benchmarks.
+ *   The keys are `iterations`, `burn_in`, `seed`, `max_time_per_function` and `max_time_total` (in seconds), `record_cpu`,
+ *   and `counters` (a comma-separated list of `cycles`, `instructions`, `cache_misses`, `branch_misses`, `dtlb_misses`, `page_faults` or `context_switches`).
+ * - `[benchmark <name>]`, for each benchmark to run.
+ *   This accepts the same keys as `[defaults]` to override the default options, as well as:
+ *   `function`, the name of the registered benchmark if it is different from `<name>`;
+ *   `enabled`, whether to run the benchmark;
+ *   and `param.<parameter>`, a comma-separated list of values for `<parameter>`.
+ * - `[output]`, containing the `console`, `csv`, `html`, `columnar`, `store`, `commit` and `profile` keys, see `ManifestOutputs` for details.
+ *
+ * An error is raised for unknown sections or keys, so that typos are not silently ignored.
+ *
+ * @param in Input stream.
+ * @return The parsed manifest.
+ */
+inline Manifest parse_manifest(std::istream& in) {
+    std::vector<internal::ManifestSection> sections;
+    std::string line;
+    std::size_t lineno = 0;
+    while (std::getline(in, line)) {
+        ++lineno;
+        line = internal::trim_manifest(line);
+        if (line.empty() || line[0] == '#' || line[0] == ';') {
+            continue;
+        }
+
+        if (line[0] == '[') {
+            if (line.back() != ']') {
+                internal::manifest_error(lineno, "unterminated section header");
+            }
+            sections.push_back(internal::ManifestSection{ internal::trim_manifest(line.substr(1, line.size() - 2)), lineno, {} });
+            continue;
+        }
+
+        const auto equals = line.find('=');
+        if (equals == std::string::npos) {
+            internal::manifest_error(lineno, "expected 'key = value'");
+        }
+        if (sections.empty()) {
+            internal::manifest_error(lineno, "key-value pair outside of a section");
+        }
+        auto key = internal::trim_manifest(line.substr(0, equals));
+        if (key.empty()) {
+            internal::manifest_error(lineno, "empty key");
+        }
+        sections.back().entries.push_back(internal::ManifestEntry{ std::move(key), internal::trim_manifest(line.substr(equals + 1)), lineno });
+    }
+
+    // Applying the defaults before the benchmarks, so that the order of the sections doesn't matter.
+    Manifest output;
+    for (const auto& section : sections) {
+        if (section.name == "defaults") {
+            for (const auto& entry : section.entries) {
+                if (!internal::apply_manifest_option(output.defaults, entry)) {
+                    internal::manifest_error(entry.line, "unknown key '" + entry.key + "' in [defaults]");
+                }
+            }
+        }
+    }
+
+    const std::string prefix = "benchmark ";
+    for (const auto& section : sections) {
+        if (section.name == "defaults") {
+            continue;
+
+        } else if (section.name == "output") {
+            auto& outputs = output.outputs;
+            for (const auto& entry : section.entries) {
+                if (entry.key == "console") {
+                    outputs.console = internal::parse_manifest_bool(entry);
+                } else if (entry.key == "csv") {
+                    outputs.csv = entry.value;
+                } else if (entry.key == "html") {
+                    outputs.html = entry.value;
+                } else if (entry.key == "columnar") {
+                    outputs.columnar = entry.value;
+                } else if (entry.key == "store") {
+                    outputs.store = entry.value;
+                } else if (entry.key == "commit") {
+                    outputs.commit = entry.value;
+                } else if (entry.key == "profile") {
+                    outputs.profile = entry.value;
+                } else {
+                    internal::manifest_error(entry.line, "unknown key '" + entry.key + "' in [output]");
+                }
+            }
+
+        } else if (section.name == "benchmark" || section.name.rfind(prefix, 0) == 0) {
+            ManifestBenchmark bench;
+            if (section.name.size() > prefix.size()) {
+                bench.name = internal::trim_manifest(section.name.substr(prefix.size()));
+            }
+            if (bench.name.empty()) {
+                internal::manifest_error(section.line, "benchmark section has no name");
+            }
+            for (const auto& existing : output.benchmarks) {
+                if (existing.name == bench.name) {
+                    internal::manifest_error(section.line, "duplicate benchmark '" + bench.name + "'");
+                }
+            }
+            bench.function = bench.name;
+            bench.options = output.defaults;
+
+            for (const auto& entry : section.entries) {
+                if (internal::apply_manifest_option(bench.options, entry)) {
+                    continue;
+                }
+                if (entry.key == "function") {
+                    bench.function = entry.value;
+                } else if (entry.key == "enabled") {
+                    bench.enabled = internal::parse_manifest_bool(entry);
+                } else if (entry.key.rfind("param.", 0) == 0 && entry.key.size() > 6) {
+                    auto values = internal::split_manifest_list(entry.value);
+                    if (values.empty()) {
+                        internal::manifest_error(entry.line, "no values for '" + entry.key + "'");
+                    }
+                    bench.parameters.emplace_back(entry.key.substr(6), std::move(values));
+                } else {
+                    internal::manifest_error(entry.line, "unknown key '" + entry.key + "' in [" + section.name + "]");
+                }
+            }
+            output.benchmarks.push_back(std::move(bench));
+
+        } else {
+            internal::manifest_error(section.line, "unknown section [" + section.name + "]");
+        }
+    }
+
+    return output;
+}
+
+/**
+ * @param path Path to a manifest file.
+ * @return The parsed manifest, see `parse_manifest()` for details.
+ */
+inline Manifest read_manifest(const std::filesystem::path& path) {
+    std::ifstream handle(path);
+    if (!handle) {
+        throw std::runtime_error("failed to open manifest '" + path.string() + "'");
+    }
+    return parse_manifest(handle);
+}
+
+/**
+ * @brief Results of a benchmark in a manifest.
+ */
+struct ManifestResult {
+    /**
+     * Name of the benchmark section.
+     */
+    std::string benchmark;
+
+    /**
+     * Parameters for each instance of the benchmark.
+     */
+    std::vector<BenchmarkParameters> settings;
+
+    /**
+     * Name of each instance, formed from the benchmark name and the parameter values, e.g., `sort[n=1000,order=random]`.
+     */
+    std::vector<std::string> names;
+
+    /**
+     * Timings for each instance, from a single call to `time()`.
+     */
+    std::vector<Timings> timings;
+};
+
+/**
+ * Run the benchmarks in a manifest and write the results to the requested output sinks.
+ * All instances of a benchmark are timed together in a single call to `time()`, so that they are interleaved and can be compared with `compare_paired()`.
+ * All selected benchmarks are checked against the registry before any of them are run.
+ *
+ * @param manifest Manifest, typically from `read_manifest()`.
+ * @param registry Registry of benchmarks.
+ * @param only Names of the benchmark sections to run.
+ * If empty, all enabled benchmarks are run; otherwise, the specified benchmarks are run regardless of `ManifestBenchmark::enabled`.
+ * @param console Stream for the console summary, if `ManifestOutputs::console = true`.
+ *
+ * @return Results for each benchmark that was run.
+ */
+inline std::vector<ManifestResult> run_manifest(
+    const Manifest& manifest,
+    const BenchmarkRegistry& registry,
+    const std::vector<std::string>& only = std::vector<std::string>(),
+    std::ostream& console = std::cout)
+{
+    std::vector<const ManifestBenchmark*> selected;
+    if (only.empty()) {
+        for (const auto& bench : manifest.benchmarks) {
+            if (bench.enabled) {
+                selected.push_back(&bench);
+            }
+        }
+    } else {
+        for (const auto& name : only) {
+            auto it = std::find_if(manifest.benchmarks.begin(), manifest.benchmarks.end(), [&](const ManifestBenchmark& b) -> bool { return b.name == name; });
+            if (it == manifest.benchmarks.end()) {
+                throw std::runtime_error("benchmark '" + name + "' is not in the manifest");
+            }
+            selected.push_back(&(*it));
+        }
+    }
+    for (auto bench : selected) {
+        if (!registry.has(bench->function)) {
+            throw std::runtime_error("benchmark '" + bench->function + "' is not registered");
+        }
+    }
+
+    std::vector<ManifestResult> output;
+    output.reserve(selected.size());
+    for (auto bench : selected) {
+        ManifestResult result;
+        result.benchmark = bench->name;
+
+        std::size_t nsettings = 1;
+        for (const auto& param : bench->parameters) {
+            nsettings *= param.second.size();
+        }
+        for (std::size_t s = 0; s < nsettings; ++s) {
+            std::vector<std::pair<std::string, std::string> > values;
+            std::size_t remaining = s;
+            for (const auto& param : bench->parameters) {
+                values.emplace_back(param.first, param.second[remaining % param.second.size()]);
+                remaining /= param.second.size();
+            }
+            BenchmarkParameters params(std::move(values));
+            result.names.push_back(internal::manifest_instance_name(bench->name, params));
+            result.settings.push_back(std::move(params));
+        }
+
+        result.timings = registry.run(bench->function, result.settings, bench->options);
+        output.push_back(std::move(result));
+    }
+
+    // Writing to each sink once all benchmarks have finished.
+    const auto& sinks = manifest.outputs;
+    std::optional<MachineProfile> profile;
+    if (sinks.profile.has_value()) {
+        profile = cached_probe(*(sinks.profile));
+    }
+    std::vector<std::string> all_names;
+    std::vector<Timings> all_timings;
+    for (const auto& result : output) {
+        all_names.insert(all_names.end(), result.names.begin(), result.names.end());
+        all_timings.insert(all_timings.end(), result.timings.begin(), result.timings.end());
+    }
+
+    if (sinks.console) {
+        for (const auto& result : output) {
+            console << "== " << result.benchmark << " ==\n";
+            ConsoleOptions copt;
+            copt.names = result.names;
+            write_console_report(console, result.timings, copt);
+            console << "\n";
+        }
+    }
+
+    if (sinks.csv.has_value()) {
+        std::ofstream handle(*(sinks.csv));
+        if (!handle) {
+            throw std::runtime_error("failed to open '" + sinks.csv->string() + "' for writing");
+        }
+        handle << "benchmark,instance,parameters,runs,mean,sd\n";
+        for (const auto& result : output) {
+            for (std::size_t i = 0; i < result.names.size(); ++i) {
+                std::string params;
+                for (const auto& val : result.settings[i].values()) {
+                    if (!params.empty()) {
+                        params += ";";
+                    }
+                    params += val.first + "=" + val.second;
+                }
+                const auto& curtime = result.timings[i];
+                handle << internal::csv_escape(result.benchmark) << "," << internal::csv_escape(result.names[i]) << "," << internal::csv_escape(params) << ","
+                    << curtime.times.size() << "," << curtime.mean.count() << "," << curtime.sd.count() << "\n";
+            }
+        }
+    }
+
+    if (sinks.html.has_value()) {
+        const auto path = sinks.html->string();
+        const std::string placeholder = "{benchmark}";
+        auto write = [&](const std::string& filename, const std::string& title, const std::vector<std::string>& names, const std::vector<Timings>& timings) -> void {
+            std::ofstream handle(filename);
+            if (!handle) {
+                throw std::runtime_error("failed to open '" + filename + "' for writing");
+            }
+            HtmlReportOptions hopt;
+            hopt.title = title;
+            hopt.names = names;
+            hopt.profile = profile;
+            write_html_report(handle, timings, hopt);
+        };
+
+        const auto pos = path.find(placeholder);
+        if (pos != std::string::npos) {
+            for (const auto& result : output) {
+                auto filename = path;
+                filename.replace(pos, placeholder.size(), result.benchmark);
+                write(filename, result.benchmark, result.names, result.timings);
+            }
+        } else {
+            write(path, "eztimer manifest", all_names, all_timings);
+        }
+    }
+
+    if (sinks.columnar.has_value() || sinks.store.has_value()) {
+        const auto fingerprint = fingerprint_id(machine_fingerprint());
+
+        if (sinks.columnar.has_value()) {
+            ColumnarOptions copt;
+            copt.names = all_names;
+            copt.metadata.emplace_back("commit", sinks.commit);
+            copt.metadata.emplace_back("fingerprint", fingerprint);
+            copt.profile = profile;
+
+            // Counter identities can only be recorded if all benchmarks used the same counters.
+            if (!selected.empty() && std::all_of(selected.begin(), selected.end(), [&](const ManifestBenchmark* b) -> bool { return b->options.counters == selected.front()->options.counters; })) {
+                copt.counters = selected.front()->options.counters;
+            }
+            write_columnar(*(sinks.columnar), all_timings, copt);
+        }
+
+        if (sinks.store.has_value()) {
+            ResultsStore store(*(sinks.store));
+            store.append(all_names, sinks.commit, fingerprint, all_timings);
+            if (profile.has_value()) {
+                store.save_profile(*profile);
+            }
+        }
+    }
+
+    return output;
+}
+
+/**
+ * Entry point for a benchmark executable that is driven by a manifest, to be called from `main()` after registering all benchmarks.
+ * The command line arguments are `<manifest> [--only <name1,name2,...>]`, or `--list` to print the registered benchmarks.
+ * Any errors are printed to `std::cerr`.
+ *
+ * @param argc Number of command line arguments, as passed to `main()`.
+ * @param argv Command line arguments, as passed to `main()`.
+ * @param registry Registry of benchmarks.
+ *
+ * @return Exit code for `main()`.
+ */
+inline int manifest_main(int argc, const char* const* argv, const BenchmarkRegistry& registry) {
+    const std::string program = (argc > 0 ? argv[0] : "benchmark");
+    std::optional<std::string> path;
+    std::vector<std::string> only;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "-h" || arg == "--help") {
+                std::cout << "Usage: " << program << " <manifest> [--only <name1,name2,...>]\n"
+                    << "       " << program << " --list\n";
+                return 0;
+            } else if (arg == "--list") {
+                for (const auto& name : registry.names()) {
+                    std::cout << name << "\n";
+                }
+                return 0;
+            } else if (arg == "--only") {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error("no value supplied for '--only'");
+                }
+                only = internal::split_manifest_list(argv[++i]);
+            } else if (!path.has_value()) {
+                path = arg;
+            } else {
+                throw std::runtime_error("unexpected argument '" + arg + "'");
+            }
+        }
+
+        if (!path.has_value()) {
+            throw std::runtime_error("no manifest supplied");
+        }
+        run_manifest(read_manifest(*path), registry, only);
+
+    } catch (std::exception& e) {
+        std::cerr << program << ": " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+}
+
+#endif
@@ -0,0 +1,323 @@
+#ifndef EZTIMER_MODALITY_HPP
+#define EZTIMER_MODALITY_HPP
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+
+#include "eztimer.hpp"
+#include "stats.hpp"
+
+/**
+ * @file modality.hpp
+ * @brief Detect multimodal timing distributions.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Options for `detect_modes()`.
+ */
+struct ModalityOptions {
+    /**
+     * Maximum number of components in the Gaussian mixture model.
+     */
+    int max_components = 3;
+
+    /**
+     * Number of grid points at which to evaluate the kernel density estimate.
+     */
+    int grid_size = 512;
+
+    /**
+     * Minimum density of a local maximum in the kernel density estimate, relative to the global maximum, for it to be counted as a mode.
+     * This avoids counting small wiggles in the tails.
+     */
+    double min_relative_density = 0.05;
+
+    /**
+     * Maximum number of iterations for fitting each mixture model.
+     */
+    int max_iterations = 200;
+
+    /**
+     * Convergence tolerance for the log-likelihood when fitting each mixture model.
+     */
+    double tolerance = 1e-8;
+};
+
+/**
+ * @brief A mode of the timing distribution.
+ */
+struct Mode {
+    /**
+     * Location of the mode, i.e., the exponential of the mean of the log-times in the mixture component.
+     */
+    std::chrono::duration<double> location = std::chrono::duration<double>(0);
+
+    /**
+     * Proportion of timings that belong to this mode.
+     */
+    double weight = 0;
+
+    /**
+     * Standard deviation of the log-times in the mixture component.
+     */
+    double log_sd = 0;
+};
+
+/**
+ * @brief Modality of the timing distribution for a function.
+ */
+struct Modality {
+    /**
+     * Number of modes in the kernel density estimate of the log-times.
+     */
+    std::size_t kde_modes = 0;
+
+    /**
+     * Components of the Gaussian mixture model of the log-times with the lowest BIC, sorted by location.
+     */
+    std::vector<Mode> modes;
+
+    /**
+     * Whether the distribution is multimodal, i.e., both the kernel density estimate and the mixture model have more than one mode.
+     * Requiring agreement avoids false positives from the mixture model, which may use multiple components to fit a skewed unimodal distribution.
+     */
+    bool multimodal = false;
+
+    /**
+     * Warning message if the distribution is multimodal, otherwise an empty string.
+     */
+    std::string warning;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+inline std::size_t count_kde_modes(const std::vector<double>& sorted, const ModalityOptions& opt) {
+    const auto n = sorted.size();
+    const double mu = mean(sorted);
+    const double sd = std::sqrt(variance(sorted, mu));
+    const double iqr = sorted_quantile(sorted, 0.75) - sorted_quantile(sorted, 0.25);
+    double spread = std::min(sd, iqr / 1.34);
+    if (spread <= 0) {
+        spread = sd;
+    }
+    if (spread <= 0) {
+        return 1;
+    }
+    const double h = 0.9 * spread * std::pow(static_cast<double>(n), -0.2);
+
+    // Linear binning onto the grid, so that the cost does not scale with the
+    // product of the number of observations and grid points.
+    const auto ngrid = static_cast<std::size_t>(std::max(opt.grid_size, 3));
+    const double lower = sorted.front() - 3 * h, upper = sorted.back() + 3 * h;
+    const double dx = (upper - lower) / (ngrid - 1);
+    std::vector<double> counts(ngrid);
+    for (auto x : sorted) {
+        const double pos = (x - lower) / dx;
+        const auto left = std::min(static_cast<std::size_t>(pos), ngrid - 2);
+        const double frac = pos - left;
+        counts[left] += 1 - frac;
+        counts[left + 1] += frac;
+    }
+
+    const auto width = static_cast<std::size_t>(std::ceil(4 * h / dx));
+    std::vector<double> kernel(width + 1);
+    for (std::size_t k = 0; k <= width; ++k) {
+        const double z = k * dx / h;
+        kernel[k] = std::exp(-0.5 * z * z);
+    }
+
+    std::vector<double> density(ngrid);
+    for (std::size_t g = 0; g < ngrid; ++g) {
+        if (counts[g] == 0) {
+            continue;
+        }
+        const auto start = (g > width ? g - width : 0);
+        const auto end = std::min(ngrid, g + width + 1);
+        for (std::size_t j = start; j < end; ++j) {
+            density[j] += counts[g] * kernel[j > g ? j - g : g - j];
+        }
+    }
+
+    const double threshold = *std::max_element(density.begin(), density.end()) * opt.min_relative_density;
+    std::size_t modes = 0;
+    for (std::size_t g = 1; g + 1 < ngrid; ++g) {
+        if (density[g] >= threshold && density[g] > density[g - 1] && density[g] >= density[g + 1]) {
+            ++modes;
+        }
+    }
+    return std::max(modes, static_cast<std::size_t>(1));
+}
+
+struct Mixture {
+    std::vector<double> weights, means, sds;
+    double loglik = -std::numeric_limits<double>::infinity();
+};
+
+inline Mixture fit_mixture(const std::vector<double>& sorted, int k, const ModalityOptions& opt) {
+    const auto n = sorted.size();
+    const double overall_var = variance(sorted, mean(sorted));
+    const double var_floor = std::max(overall_var * 1e-6, 1e-12);
+
+    Mixture output;
+    output.weights.resize(k, 1.0 / k);
+    output.means.resize(k);
+    output.sds.resize(k, std::sqrt(std::max(overall_var / (k * k), var_floor)));
+    for (int c = 0; c < k; ++c) {
+        output.means[c] = sorted_quantile(sorted, (c + 0.5) / k);
+    }
+
+    std::vector<double> resp(n * k);
+    constexpr double log_sqrt_2pi = 0.91893853320467274178;
+    for (int it = 0; it < opt.max_iterations; ++it) {
+        // E-step, using the log-sum-exp trick for stability.
+        double loglik = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            double maxed = -std::numeric_limits<double>::infinity();
+            for (int c = 0; c < k; ++c) {
+                const double z = (sorted[i] - output.means[c]) / output.sds[c];
+                const double lp = std::log(output.weights[c]) - std::log(output.sds[c]) - log_sqrt_2pi - 0.5 * z * z;
+                resp[i * k + c] = lp;
+                maxed = std::max(maxed, lp);
+            }
+            double total = 0;
+            for (int c = 0; c < k; ++c) {
+                auto& r = resp[i * k + c];
+                r = std::exp(r - maxed);
+                total += r;
+            }
+            for (int c = 0; c < k; ++c) {
+                resp[i * k + c] /= total;
+            }
+            loglik += maxed + std::log(total);
+        }
+
+        // M-step.
+        for (int c = 0; c < k; ++c) {
+            double wsum = 0, msum = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                wsum += resp[i * k + c];
+                msum += resp[i * k + c] * sorted[i];
+            }
+            if (wsum <= 0) {
+                output.weights[c] = std::numeric_limits<double>::min();
+                continue;
+            }
+            const double mu = msum / wsum;
+            double vsum = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                const double delta = sorted[i] - mu;
+                vsum += resp[i * k + c] * delta * delta;
+            }
+            output.weights[c] = wsum / n;
+            output.means[c] = mu;
+            output.sds[c] = std::sqrt(std::max(vsum / wsum, var_floor));
+        }
+
+        const bool converged = std::abs(loglik - output.loglik) < opt.tolerance * std::max(1.0, std::abs(loglik));
+        output.loglik = loglik;
+        if (converged) {
+            break;
+        }
+    }
+
+    return output;
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Detect whether the timings for a function are multimodal, e.g., due to different frequency states or NUMA placements.
+ * In such cases, the mean and standard deviation are not meaningful summaries of the timings.
+ *
+ * Modes are counted as the local maxima of a Gaussian kernel density estimate of the log-times, using Silverman's rule of thumb for the bandwidth.
+ * Gaussian mixture models with up to `ModalityOptions::max_components` components are also fitted to the log-times by expectation-maximization,
+ * and the model with the lowest Bayesian information criterion is used to report the location and weight of each mode.
+ * Non-positive times are ignored.
+ *
+ * @param timings Timings for a function, typically from `time()`.
+ * @param opt Further options.
+ *
+ * @return Modality of the timing distribution.
+ */
+inline Modality detect_modes(const Timings& timings, const ModalityOptions& opt = ModalityOptions()) {
+    std::vector<double> logged;
+    logged.reserve(timings.times.size());
+    for (auto t : timings.times) {
+        if (t.count() > 0) {
+            logged.push_back(std::log(t.count()));
+        }
+    }
+    std::sort(logged.begin(), logged.end());
+
+    Modality output;
+    const auto n = logged.size();
+    if (n == 0) {
+        return output;
+    }
+    if (n < 3 || logged.front() == logged.back()) {
+        output.kde_modes = 1;
+        Mode only;
+        only.location = std::chrono::duration<double>(std::exp(internal::mean(logged)));
+        only.weight = 1;
+        output.modes.push_back(only);
+        return output;
+    }
+
+    output.kde_modes = internal::count_kde_modes(logged, opt);
+
+    internal::Mixture best;
+    double best_bic = std::numeric_limits<double>::infinity();
+    const int max_k = std::max(1, std::min(opt.max_components, static_cast<int>(n / 3)));
+    for (int k = 1; k <= max_k; ++k) {
+        auto current = internal::fit_mixture(logged, k, opt);
+        const double bic = -2 * current.loglik + (3 * k - 1) * std::log(static_cast<double>(n));
+        if (bic < best_bic) {
+            best_bic = bic;
+            best = std::move(current);
+        }
+    }
+
+    // Dropping components that don't account for a single timing, and
+    // renormalizing the remaining weights so that they still sum to 1.
+    double kept = 0;
+    for (std::size_t c = 0; c < best.means.size(); ++c) {
+        if (best.weights[c] * n < 1) {
+            continue;
+        }
+        Mode current;
+        current.location = std::chrono::duration<double>(std::exp(best.means[c]));
+        current.weight = best.weights[c];
+        current.log_sd = best.sds[c];
+        output.modes.push_back(current);
+        kept += current.weight;
+    }
+    for (auto& mode : output.modes) {
+        mode.weight /= kept;
+    }
+    std::sort(output.modes.begin(), output.modes.end(), [](const Mode& l, const Mode& r) -> bool { return l.location < r.location; });
+
+    output.multimodal = output.kde_modes > 1 && output.modes.size() > 1;
+    if (output.multimodal) {
+        // Only reporting the number of modes supported by both the density estimate and the mixture model.
+        const auto nmodes = std::min(output.kde_modes, output.modes.size());
+        output.warning = "timings have " + std::to_string(nmodes) + " modes, so the mean and standard deviation are not meaningful";
+    }
+    return output;
+}
+
+}
+
+#endif
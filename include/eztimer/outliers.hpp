@@ -0,0 +1,216 @@
+#ifndef EZTIMER_OUTLIERS_HPP
+#define EZTIMER_OUTLIERS_HPP
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstddef>
+#include <algorithm>
+
+#include "eztimer.hpp"
+#include "stats.hpp"
+
+/**
+ * @file outliers.hpp
+ * @brief Classify outlying timings.
+ */
+
+namespace eztimer {
+
+/**
+ * Effect of outliers on the variance of the timings, based on `OutlierSummary::variance_fraction`.
+ * These thresholds are specific to this library.
+ * They are not comparable to the model-based "variance introduced by outliers" reported by other benchmarking libraries.
+ *
+ * - `UNAFFECTED`: less than 1% of the variance is due to outliers.
+ * - `SLIGHT`: less than 10%.
+ * - `MODERATE`: less than 50%.
+ * - `SEVERE`: 50% or more.
+ */
+enum class OutlierEffect {
+    UNAFFECTED,
+    SLIGHT,
+    MODERATE,
+    SEVERE
+};
+
+/**
+ * @brief Summary of outliers in the timings for a function.
+ *
+ * Outliers are defined with Tukey's fences, based on the first and third quartiles (Q1 and Q3) and the interquartile range (IQR).
+ * Mild outliers lie beyond 1.5 IQRs from the quartiles, while severe outliers lie beyond 3 IQRs.
+ */
+struct OutlierSummary {
+    /**
+     * Number of severe outliers below Q1 - 3 * IQR.
+     */
+    std::size_t low_severe = 0;
+
+    /**
+     * Number of mild outliers between Q1 - 3 * IQR and Q1 - 1.5 * IQR.
+     */
+    std::size_t low_mild = 0;
+
+    /**
+     * Number of mild outliers between Q3 + 1.5 * IQR and Q3 + 3 * IQR.
+     */
+    std::size_t high_mild = 0;
+
+    /**
+     * Number of severe outliers above Q3 + 3 * IQR.
+     */
+    std::size_t high_severe = 0;
+
+    /**
+     * Proportion of all timings that are outliers of any kind.
+     */
+    double proportion = 0;
+
+    /**
+     * Lower fence for severe outliers.
+     */
+    std::chrono::duration<double> low_severe_fence = std::chrono::duration<double>(0);
+
+    /**
+     * Lower fence for mild outliers.
+     */
+    std::chrono::duration<double> low_mild_fence = std::chrono::duration<double>(0);
+
+    /**
+     * Upper fence for mild outliers.
+     */
+    std::chrono::duration<double> high_mild_fence = std::chrono::duration<double>(0);
+
+    /**
+     * Upper fence for severe outliers.
+     */
+    std::chrono::duration<double> high_severe_fence = std::chrono::duration<double>(0);
+
+    /**
+     * Proportion of the variance of the timings that is attributable to outliers.
+     * This is computed as one minus the ratio of the variance without any outliers to the variance of all timings.
+     * It is a simple empirical measure, not a model-based estimate of the variance introduced by outliers.
+     */
+    double variance_fraction = 0;
+
+    /**
+     * Effect of the outliers on the variance, based on `variance_fraction`.
+     */
+    OutlierEffect effect = OutlierEffect::UNAFFECTED;
+
+    /**
+     * Whether the timings are unreliable, i.e., `effect` is `OutlierEffect::SEVERE`.
+     */
+    bool unreliable = false;
+
+    /**
+     * Warning message if the timings are unreliable, otherwise an empty string.
+     */
+    std::string warning;
+
+    /**
+     * Mean of the timings after excluding severe outliers.
+     */
+    std::chrono::duration<double> robust_mean = std::chrono::duration<double>(0);
+
+    /**
+     * Standard deviation of the timings after excluding severe outliers.
+     */
+    std::chrono::duration<double> robust_sd = std::chrono::duration<double>(0);
+
+    /**
+     * Median of all timings.
+     */
+    std::chrono::duration<double> median = std::chrono::duration<double>(0);
+};
+
+/**
+ * Classify the timings for a function into mild and severe outliers, and summarize their effect on the variance.
+ * The timings themselves are not modified.
+ *
+ * @param timings Timings for a function, typically from `time()`.
+ *
+ * @return Summary of the outliers.
+ */
+inline OutlierSummary classify_outliers(const Timings& timings) {
+    OutlierSummary output;
+    const auto n = timings.times.size();
+    if (n == 0) {
+        return output;
+    }
+
+    std::vector<double> sorted;
+    sorted.reserve(n);
+    for (auto t : timings.times) {
+        sorted.push_back(t.count());
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    const double q1 = internal::sorted_quantile(sorted, 0.25);
+    const double q3 = internal::sorted_quantile(sorted, 0.75);
+    const double iqr = q3 - q1;
+    const double lsf = q1 - 3 * iqr, lmf = q1 - 1.5 * iqr, hmf = q3 + 1.5 * iqr, hsf = q3 + 3 * iqr;
+    output.low_severe_fence = std::chrono::duration<double>(lsf);
+    output.low_mild_fence = std::chrono::duration<double>(lmf);
+    output.high_mild_fence = std::chrono::duration<double>(hmf);
+    output.high_severe_fence = std::chrono::duration<double>(hsf);
+    output.median = std::chrono::duration<double>(internal::sorted_quantile(sorted, 0.5));
+
+    std::vector<double> non_severe, clean;
+    non_severe.reserve(n);
+    clean.reserve(n);
+    for (auto x : sorted) {
+        if (x < lsf) {
+            ++output.low_severe;
+            continue;
+        } else if (x > hsf) {
+            ++output.high_severe;
+            continue;
+        }
+
+        non_severe.push_back(x);
+        if (x < lmf) {
+            ++output.low_mild;
+        } else if (x > hmf) {
+            ++output.high_mild;
+        } else {
+            clean.push_back(x);
+        }
+    }
+    output.proportion = static_cast<double>(n - clean.size()) / n;
+
+    if (!non_severe.empty()) {
+        const double mu = internal::mean(non_severe);
+        output.robust_mean = std::chrono::duration<double>(mu);
+        if (non_severe.size() > 1) {
+            output.robust_sd = std::chrono::duration<double>(std::sqrt(internal::variance(non_severe, mu)));
+        }
+    }
+
+    if (n > 1 && clean.size() > 1) {
+        const double total_var = internal::variance(sorted, internal::mean(sorted));
+        const double clean_var = internal::variance(clean, internal::mean(clean));
+        if (total_var > 0) {
+            output.variance_fraction = std::max(0.0, 1 - clean_var / total_var);
+        }
+    }
+
+    if (output.variance_fraction < 0.01) {
+        output.effect = OutlierEffect::UNAFFECTED;
+    } else if (output.variance_fraction < 0.1) {
+        output.effect = OutlierEffect::SLIGHT;
+    } else if (output.variance_fraction < 0.5) {
+        output.effect = OutlierEffect::MODERATE;
+    } else {
+        output.effect = OutlierEffect::SEVERE;
+        output.unreliable = true;
+        output.warning = "outliers account for " + std::to_string(static_cast<int>(output.variance_fraction * 100)) +
+            "% of the variance, so the mean and standard deviation are unreliable";
+    }
+
+    return output;
+}
+
+}
+
+#endif
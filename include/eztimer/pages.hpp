@@ -0,0 +1,362 @@
+#ifndef EZTIMER_PAGES_HPP
+#define EZTIMER_PAGES_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <functional>
+#include <algorithm>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define EZTIMER_HAS_MMAP
+#endif
+
+#include "eztimer.hpp"
+#include "counters.hpp"
+
+/**
+ * @file pages.hpp
+ * @brief Allocation of inputs with different page policies.
+ */
+
+namespace eztimer {
+
+/**
+ * Page policy for the memory backing a buffer.
+ *
+ * - `SMALL`: regular pages, typically 4 KB. On Linux, transparent huge pages are explicitly disabled for the buffer.
+ * - `TRANSPARENT_HUGE`: regular mapping that is aligned to a 2 MB boundary and marked with `madvise(MADV_HUGEPAGE)`.
+ * Whether the kernel actually backs the buffer with huge pages depends on its THP configuration.
+ * - `EXPLICIT_HUGE`: mapping with `MAP_HUGETLB`, which requires huge pages to be reserved by the system administrator.
+ */
+enum class PagePolicy {
+    SMALL,
+    TRANSPARENT_HUGE,
+    EXPLICIT_HUGE
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+constexpr std::size_t huge_page_size = 2 * 1024 * 1024;
+constexpr std::size_t small_page_size = 4096;
+
+inline std::size_t round_up(std::size_t x, std::size_t unit) {
+    return (x + unit - 1) / unit * unit;
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * @brief Buffer that is backed by pages of a requested policy.
+ *
+ * If the requested policy is not available, allocation falls back to the next-best policy, i.e., from `PagePolicy::EXPLICIT_HUGE` to `PagePolicy::TRANSPARENT_HUGE` to `PagePolicy::SMALL`.
+ * The policy that was actually obtained is reported by `policy()`.
+ * On platforms without `mmap()`, all buffers use `PagePolicy::SMALL` from an aligned `operator new`.
+ */
+class PageBuffer {
+public:
+    /**
+     * @param bytes Size of the buffer in bytes.
+     * @param policy Requested page policy.
+     */
+    PageBuffer(std::size_t bytes, PagePolicy policy) : my_size(bytes) {
+        const std::size_t request = std::max(bytes, static_cast<std::size_t>(1));
+
+#ifdef EZTIMER_HAS_MMAP
+#ifdef MAP_HUGETLB
+        if (policy == PagePolicy::EXPLICIT_HUGE) {
+            my_mapped = internal::round_up(request, internal::huge_page_size);
+            void* ptr = mmap(NULL, my_mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (ptr != MAP_FAILED) {
+                my_base = ptr;
+                my_data = ptr;
+                my_policy = PagePolicy::EXPLICIT_HUGE;
+                return;
+            }
+        }
+#endif
+
+        if (policy == PagePolicy::SMALL) {
+            my_mapped = internal::round_up(request, internal::small_page_size);
+            my_base = map(my_mapped);
+            my_data = my_base;
+#ifdef MADV_NOHUGEPAGE
+            madvise(my_base, my_mapped, MADV_NOHUGEPAGE);
+#endif
+            return;
+        }
+
+        // Over-allocating so that we can align the start of the buffer to a
+        // huge page boundary, otherwise the kernel can't use huge pages.
+        const std::size_t usable = internal::round_up(request, internal::huge_page_size);
+        my_mapped = usable + internal::huge_page_size;
+        my_base = map(my_mapped);
+        const auto raw = reinterpret_cast<std::uintptr_t>(my_base);
+        const auto aligned = internal::round_up(raw, internal::huge_page_size);
+        my_data = static_cast<unsigned char*>(my_base) + (aligned - raw);
+#ifdef MADV_HUGEPAGE
+        if (madvise(my_data, usable, MADV_HUGEPAGE) == 0) {
+            my_policy = PagePolicy::TRANSPARENT_HUGE;
+        }
+#endif
+
+#else
+        (void)policy;
+        my_mapped = internal::round_up(request, internal::small_page_size);
+        my_base = ::operator new(my_mapped, std::align_val_t(internal::small_page_size));
+        my_data = my_base;
+#endif
+    }
+
+    /**
+     * @cond
+     */
+    PageBuffer(const PageBuffer&) = delete;
+    PageBuffer& operator=(const PageBuffer&) = delete;
+
+    PageBuffer(PageBuffer&& other) :
+        my_base(other.my_base), my_data(other.my_data), my_size(other.my_size), my_mapped(other.my_mapped), my_policy(other.my_policy)
+    {
+        other.my_base = NULL;
+    }
+
+    PageBuffer& operator=(PageBuffer&& other) {
+        if (this != &other) {
+            release();
+            my_base = other.my_base;
+            my_data = other.my_data;
+            my_size = other.my_size;
+            my_mapped = other.my_mapped;
+            my_policy = other.my_policy;
+            other.my_base = NULL;
+        }
+        return *this;
+    }
+
+    ~PageBuffer() {
+        release();
+    }
+    /**
+     * @endcond
+     */
+
+public:
+    /**
+     * @return Pointer to the start of the buffer.
+     */
+    void* data() const {
+        return my_data;
+    }
+
+    /**
+     * @return Size of the buffer in bytes, as requested in the constructor.
+     */
+    std::size_t size() const {
+        return my_size;
+    }
+
+    /**
+     * @return Page policy that was obtained for this buffer.
+     */
+    PagePolicy policy() const {
+        return my_policy;
+    }
+
+private:
+    void* my_base = NULL;
+    void* my_data = NULL;
+    std::size_t my_size = 0;
+    std::size_t my_mapped = 0;
+    PagePolicy my_policy = PagePolicy::SMALL;
+
+#ifdef EZTIMER_HAS_MMAP
+    static void* map(std::size_t len) {
+        void* ptr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+#endif
+
+    void release() {
+        if (my_base == NULL) {
+            return;
+        }
+#ifdef EZTIMER_HAS_MMAP
+        munmap(my_base, my_mapped);
+#else
+        ::operator delete(my_base, std::align_val_t(internal::small_page_size));
+#endif
+        my_base = NULL;
+    }
+};
+
+/**
+ * @brief Options for `time_page_policies()`.
+ */
+struct PagePolicyOptions {
+    /**
+     * Page policies to test.
+     */
+    std::vector<PagePolicy> policies { PagePolicy::SMALL, PagePolicy::TRANSPARENT_HUGE, PagePolicy::EXPLICIT_HUGE };
+
+    /**
+     * Whether to count data TLB misses for each call.
+     * If true, `Counter::DTLB_MISSES` is added to `Options::counters` in `timing` if it is not already present.
+     */
+    bool count_tlb_misses = true;
+
+    /**
+     * Further options to pass to `time()`.
+     */
+    Options timing;
+};
+
+/**
+ * @brief Timings for each function under each page policy.
+ */
+struct PagePolicyTimings {
+    /**
+     * Page policies that were requested, copied from `PagePolicyOptions::policies`.
+     */
+    std::vector<PagePolicy> requested;
+
+    /**
+     * Page policies that were actually obtained for each entry of `requested`, after any fallback.
+     */
+    std::vector<PagePolicy> obtained;
+
+    /**
+     * Timings for each policy (outer vector, same length as `requested`) and each function (inner vector).
+     */
+    std::vector<std::vector<Timings> > timings;
+
+    /**
+     * Ratio of the mean runtime under each policy to the mean runtime under the first policy, for each policy (outer) and function (inner).
+     */
+    std::vector<std::vector<double> > relative;
+
+    /**
+     * Mean number of data TLB misses per call for each policy (outer) and function (inner).
+     * This is not set if the counter is not available or `PagePolicyOptions::count_tlb_misses = false`.
+     */
+    std::vector<std::vector<std::optional<double> > > tlb_misses;
+};
+
+/**
+ * Time functions on the same input data that is backed by pages of different policies.
+ * A separate `PageBuffer` is allocated for each policy, so the memory usage is proportional to the number of policies.
+ * All combinations of policies and functions are timed in a single call to `time()`.
+ *
+ * @param bytes Size of the input buffer in bytes.
+ * @param fill Function that fills a buffer of size `bytes` with the input data.
+ * This is called once for each policy, before any timing is performed.
+ * @param funs Vector of functions to be timed.
+ * Each function accepts a pointer to the buffer and its size in bytes.
+ * @param check Function that accepts a `Result_` and an index of `funs`, see `time()` for details.
+ * @param opt Further options.
+ *
+ * @return Timings for each function under each page policy.
+ *
+ * @tparam Result_ Result of each function call.
+ */
+template<typename Result_>
+PagePolicyTimings time_page_policies(
+    std::size_t bytes,
+    const std::function<void(void*, std::size_t)>& fill,
+    const std::vector<std::function<Result_(void*, std::size_t)> >& funs,
+    const std::function<void(const Result_&, std::size_t)>& check,
+    const PagePolicyOptions& opt
+) {
+    const auto nfun = funs.size();
+    const auto npol = opt.policies.size();
+
+    PagePolicyTimings output;
+    output.requested = opt.policies;
+    std::vector<PageBuffer> buffers;
+    buffers.reserve(npol);
+    for (auto pol : opt.policies) {
+        buffers.emplace_back(bytes, pol);
+        fill(buffers.back().data(), bytes);
+        output.obtained.push_back(buffers.back().policy());
+    }
+
+    std::vector<std::function<Result_()> > wrapped;
+    wrapped.reserve(npol * nfun);
+    for (std::size_t p = 0; p < npol; ++p) {
+        void* ptr = buffers[p].data();
+        for (std::size_t f = 0; f < nfun; ++f) {
+            const auto& curfun = funs[f];
+            wrapped.emplace_back([&curfun, ptr, bytes]() -> Result_ { return curfun(ptr, bytes); });
+        }
+    }
+
+    auto topt = opt.timing;
+    std::optional<std::size_t> tlb_index;
+    if (opt.count_tlb_misses) {
+        auto it = std::find(topt.counters.begin(), topt.counters.end(), Counter::DTLB_MISSES);
+        tlb_index = it - topt.counters.begin();
+        if (it == topt.counters.end()) {
+            topt.counters.push_back(Counter::DTLB_MISSES);
+        }
+    }
+
+    auto timings = time<Result_>(
+        wrapped,
+        [&](const Result_& res, std::size_t i) -> void { check(res, i % nfun); },
+        topt
+    );
+
+    output.timings.resize(npol);
+    output.relative.resize(npol);
+    output.tlb_misses.resize(npol);
+    auto tIt = timings.begin();
+    for (std::size_t p = 0; p < npol; ++p) {
+        auto& current = output.timings[p];
+        current.insert(current.end(), std::make_move_iterator(tIt), std::make_move_iterator(tIt + nfun));
+        tIt += nfun;
+
+        auto& curtlb = output.tlb_misses[p];
+        curtlb.resize(nfun);
+        if (tlb_index.has_value()) {
+            for (std::size_t f = 0; f < nfun; ++f) {
+                const auto& misses = current[f].counters[*tlb_index];
+                if (!misses.empty()) {
+                    double total = 0;
+                    for (auto m : misses) {
+                        total += m;
+                    }
+                    curtlb[f] = total / misses.size();
+                }
+            }
+        }
+    }
+
+    for (std::size_t p = 0; p < npol; ++p) {
+        auto& currel = output.relative[p];
+        currel.resize(nfun, 1);
+        for (std::size_t f = 0; f < nfun; ++f) {
+            const auto& ref = output.timings[0][f].mean;
+            if (ref.count() > 0) {
+                currel[f] = output.timings[p][f].mean / ref;
+            }
+        }
+    }
+
+    return output;
+}
+
+}
+
+#endif
@@ -0,0 +1,410 @@
+#ifndef EZTIMER_PIPELINE_HPP
+#define EZTIMER_PIPELINE_HPP
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "eztimer.hpp"
+
+/**
+ * @file pipeline.hpp
+ * @brief Benchmark multi-stage pipelines.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Options for `time_pipeline()`.
+ */
+struct PipelineOptions {
+    /**
+     * Capacities of the queues between stages, in terms of the number of batches.
+     */
+    std::vector<std::size_t> queue_depths { 4, 16, 64 };
+
+    /**
+     * Number of items in each batch that is passed between stages.
+     */
+    std::vector<std::size_t> batch_sizes { 1, 16 };
+
+    /**
+     * Number of items to pass through the pipeline in each run.
+     */
+    std::size_t num_items = 10000;
+
+    /**
+     * Whether to pin each stage's thread to a different CPU.
+     * This is only supported on Linux and is ignored elsewhere, or if pinning fails.
+     */
+    bool pin_threads = true;
+
+    /**
+     * Further options to pass to `time()`.
+     */
+    Options timing;
+};
+
+/**
+ * @brief Configuration of a pipeline.
+ */
+struct PipelineConfiguration {
+    /**
+     * Capacity of each queue, in terms of the number of batches.
+     */
+    std::size_t queue_depth = 0;
+
+    /**
+     * Number of items in each batch.
+     */
+    std::size_t batch_size = 0;
+};
+
+/**
+ * @brief Statistics for a single stage of the pipeline.
+ */
+struct PipelineStageStatistics {
+    /**
+     * Mean time spent in the stage per item, in seconds.
+     */
+    double service_time = 0;
+
+    /**
+     * Mean proportion of the pipeline's wall time that was spent in this stage.
+     */
+    double busy_fraction = 0;
+
+    /**
+     * Mean number of batches in the stage's input queue, sampled whenever the stage retrieves a batch.
+     * This is always zero for the first stage, which has no input queue.
+     */
+    double occupancy = 0;
+};
+
+/**
+ * @brief Timings for each configuration of the pipeline.
+ */
+struct PipelineTimings {
+    /**
+     * All combinations of `PipelineOptions::queue_depths` and `PipelineOptions::batch_sizes`.
+     */
+    std::vector<PipelineConfiguration> configurations;
+
+    /**
+     * Timings for a complete run of the pipeline in each configuration.
+     */
+    std::vector<Timings> timings;
+
+    /**
+     * Throughput for each configuration, in items per second.
+     */
+    std::vector<double> throughput;
+
+    /**
+     * Statistics for each configuration (outer vector) and each stage (inner vector), averaged across runs.
+     */
+    std::vector<std::vector<PipelineStageStatistics> > stages;
+
+    /**
+     * For each configuration, the index of the bottleneck stage, i.e., the stage with the highest busy fraction.
+     */
+    std::vector<std::size_t> bottleneck;
+
+    /**
+     * Index of the configuration with the highest throughput.
+     */
+    std::size_t best = 0;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+// Bounded single-producer single-consumer queue.
+template<typename Type_>
+class SpscQueue {
+public:
+    SpscQueue(std::size_t capacity) : my_slots(capacity + 1) {}
+
+    bool push(Type_& x) {
+        const auto tail = my_tail.load(std::memory_order_relaxed);
+        const auto next = advance(tail);
+        if (next == my_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        my_slots[tail] = std::move(x);
+        my_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(Type_& x) {
+        const auto head = my_head.load(std::memory_order_relaxed);
+        if (head == my_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        x = std::move(my_slots[head]);
+        my_head.store(advance(head), std::memory_order_release);
+        return true;
+    }
+
+    std::size_t size() const {
+        const auto head = my_head.load(std::memory_order_acquire);
+        const auto tail = my_tail.load(std::memory_order_acquire);
+        return (tail >= head ? tail - head : tail + my_slots.size() - head);
+    }
+
+private:
+    std::vector<Type_> my_slots;
+    alignas(64) std::atomic<std::size_t> my_head{0};
+    alignas(64) std::atomic<std::size_t> my_tail{0};
+
+    std::size_t advance(std::size_t x) const {
+        ++x;
+        return (x == my_slots.size() ? 0 : x);
+    }
+};
+
+inline void pin_thread(std::size_t index) {
+#ifdef __linux__
+    const auto ncpus = std::thread::hardware_concurrency();
+    if (ncpus == 0) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % ncpus, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)index;
+#endif
+}
+
+struct PipelineRun {
+    std::vector<double> busy;
+    std::vector<double> occupancy;
+};
+
+template<typename Item_>
+PipelineRun run_pipeline(
+    const std::function<Item_(std::size_t)>& source,
+    const std::vector<std::function<void(Item_&)> >& stages,
+    const std::function<void(const Item_&, std::size_t)>& sink,
+    const PipelineConfiguration& config,
+    std::size_t num_items,
+    bool pin
+) {
+    typedef std::vector<Item_> Batch;
+    const auto nstages = stages.size();
+    std::vector<std::unique_ptr<SpscQueue<Batch> > > queues;
+    queues.reserve(nstages);
+    for (std::size_t s = 1; s < nstages; ++s) {
+        queues.emplace_back(new SpscQueue<Batch>(config.queue_depth));
+    }
+    std::vector<std::atomic<bool> > finished(nstages);
+    for (auto& f : finished) {
+        f = false;
+    }
+
+    PipelineRun output;
+    output.busy.resize(nstages);
+    output.occupancy.resize(nstages);
+
+    auto worker = [&](std::size_t s) -> void {
+        if (pin) {
+            pin_thread(s);
+        }
+
+        std::chrono::steady_clock::duration busy = std::chrono::steady_clock::duration::zero();
+        double occupancy = 0;
+        std::size_t npopped = 0;
+        std::size_t sunk = 0;
+        std::size_t produced = 0;
+        Batch batch;
+
+        while (true) {
+            if (s == 0) {
+                if (produced == num_items) {
+                    break;
+                }
+                const auto end = std::min(num_items, produced + config.batch_size);
+                batch.clear();
+                for (; produced < end; ++produced) {
+                    batch.push_back(source(produced));
+                }
+            } else {
+                auto& input = *(queues[s - 1]);
+                const auto current_size = input.size();
+                if (!input.pop(batch)) {
+                    if (!finished[s - 1].load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    // Checking again, in case the last batch was pushed
+                    // between our pop() and the load of the flag.
+                    if (!input.pop(batch)) {
+                        break;
+                    }
+                }
+                occupancy += current_size;
+                ++npopped;
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            for (auto& item : batch) {
+                stages[s](item);
+            }
+            busy += std::chrono::steady_clock::now() - start;
+
+            if (s + 1 == nstages) {
+                for (const auto& item : batch) {
+                    sink(item, sunk);
+                    ++sunk;
+                }
+            } else {
+                auto& output_queue = *(queues[s]);
+                while (!output_queue.push(batch)) {
+                    std::this_thread::yield();
+                }
+                batch = Batch();
+                batch.reserve(config.batch_size);
+            }
+        }
+
+        finished[s].store(true, std::memory_order_release);
+        output.busy[s] = std::chrono::duration_cast<std::chrono::duration<double> >(busy).count();
+        output.occupancy[s] = (npopped ? occupancy / npopped : 0);
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(nstages);
+    for (std::size_t s = 0; s < nstages; ++s) {
+        threads.emplace_back(worker, s);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    return output;
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Benchmark a pipeline where items are passed through multiple stages, each running on its own thread.
+ * Stages are connected by bounded lock-free queues that pass batches of items from one stage to the next.
+ * All combinations of queue depths and batch sizes are treated as separate functions in a single call to `time()`, so configurations are run in random order in each iteration.
+ *
+ * Each stage runs on a new thread that is created for each run, so the affinity of the calling thread is not affected by `PipelineOptions::pin_threads`.
+ * Thread creation is included in the timings but should be negligible for sufficiently large `PipelineOptions::num_items`.
+ * The time spent in each stage is measured per batch, and the stage with the highest busy fraction is reported as the bottleneck of the pipeline.
+ *
+ * @param source Function that generates the item with the specified index.
+ * This is run in the first stage's thread but is not included in its service time.
+ * @param stages Vector of stages, each of which modifies an item in place.
+ * This should contain at least one stage.
+ * @param sink Function that accepts each item from the final stage, along with its index.
+ * This is run in the last stage's thread but is not included in its service time.
+ * The sink should be cheap, but must use the item so that the pipeline is not optimized away.
+ * @param opt Further options.
+ *
+ * @return Timings and per-stage statistics for each configuration.
+ *
+ * @tparam Item_ Type of item passed between stages.
+ */
+template<typename Item_>
+PipelineTimings time_pipeline(
+    const std::function<Item_(std::size_t)>& source,
+    const std::vector<std::function<void(Item_&)> >& stages,
+    const std::function<void(const Item_&, std::size_t)>& sink,
+    const PipelineOptions& opt
+) {
+    PipelineTimings output;
+    for (auto depth : opt.queue_depths) {
+        for (auto batch : opt.batch_sizes) {
+            PipelineConfiguration config;
+            config.queue_depth = std::max(depth, static_cast<std::size_t>(1));
+            config.batch_size = std::max(batch, static_cast<std::size_t>(1));
+            output.configurations.push_back(config);
+        }
+    }
+
+    const auto nconfigs = output.configurations.size();
+    const auto nstages = stages.size();
+    std::vector<std::function<internal::PipelineRun()> > funs;
+    funs.reserve(nconfigs);
+    for (const auto& config : output.configurations) {
+        funs.emplace_back([&]() -> internal::PipelineRun {
+            return internal::run_pipeline<Item_>(source, stages, sink, config, opt.num_items, opt.pin_threads);
+        });
+    }
+
+    std::vector<std::vector<internal::PipelineRun> > runs(nconfigs);
+    output.timings = time<internal::PipelineRun>(
+        funs,
+        [&](const internal::PipelineRun& res, std::size_t i) -> void {
+            runs[i].push_back(res);
+        },
+        opt.timing
+    );
+
+    output.throughput.resize(nconfigs);
+    output.stages.resize(nconfigs);
+    output.bottleneck.resize(nconfigs);
+    for (std::size_t c = 0; c < nconfigs; ++c) {
+        const auto& curtimings = output.timings[c];
+        if (curtimings.mean.count() > 0) {
+            output.throughput[c] = opt.num_items / curtimings.mean.count();
+        }
+
+        auto& curstages = output.stages[c];
+        curstages.resize(nstages);
+        const auto& curruns = runs[c];
+        for (std::size_t r = 0; r < curruns.size(); ++r) {
+            const auto walltime = curtimings.times[r].count();
+            for (std::size_t s = 0; s < nstages; ++s) {
+                auto& stat = curstages[s];
+                const auto busy = curruns[r].busy[s];
+                stat.service_time += (opt.num_items ? busy / opt.num_items : 0);
+                stat.busy_fraction += (walltime > 0 ? busy / walltime : 0);
+                stat.occupancy += curruns[r].occupancy[s];
+            }
+        }
+
+        for (std::size_t s = 0; s < nstages; ++s) {
+            auto& stat = curstages[s];
+            if (!curruns.empty()) {
+                stat.service_time /= curruns.size();
+                stat.busy_fraction /= curruns.size();
+                stat.occupancy /= curruns.size();
+            }
+            if (stat.busy_fraction > curstages[output.bottleneck[c]].busy_fraction) {
+                output.bottleneck[c] = s;
+            }
+        }
+
+        if (output.throughput[c] > output.throughput[output.best]) {
+            output.best = c;
+        }
+    }
+
+    return output;
+}
+
+}
+
+#endif
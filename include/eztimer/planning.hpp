@@ -0,0 +1,269 @@
+#ifndef EZTIMER_PLANNING_HPP
+#define EZTIMER_PLANNING_HPP
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+#include "eztimer.hpp"
+#include "stats.hpp"
+#include "compare.hpp"
+
+/**
+ * @file planning.hpp
+ * @brief Plan the number of iterations to detect an effect.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Options for `plan_iterations()`.
+ */
+struct PlanningOptions {
+    /**
+     * Relative change in runtime to be detected, e.g., 0.02 for a 2% slowdown or speedup.
+     */
+    double effect = 0.02;
+
+    /**
+     * Significance level of the two-sided test.
+     */
+    double significance = 0.05;
+
+    /**
+     * Probability of detecting a change of size `effect`.
+     */
+    double power = 0.8;
+
+    /**
+     * Index of the baseline function.
+     * If set, each other function is compared to the baseline by pairing runs in the same iteration, as in `compare_paired()`.
+     * Otherwise, each function is compared to a separate measurement of itself with the same variance (e.g., a stored result from a previous build), as in `compare_distributions()`.
+     */
+    std::optional<std::size_t> baseline;
+
+    /**
+     * Options to pass to `time()` for the pilot run.
+     */
+    Options pilot;
+
+    /**
+     * Whether to run the full measurement with the planned number of iterations, see `IterationPlan::timings`.
+     */
+    bool run = false;
+
+    /**
+     * Options to pass to `time()` for the full measurement.
+     * `Options::iterations` is ignored and replaced by `IterationPlan::iterations`.
+     * `Options::max_time_total` and `Options::max_time_per_function` are used to check whether the plan is feasible.
+     */
+    Options timing;
+};
+
+/**
+ * @brief Plan for the number of iterations.
+ */
+struct IterationPlan {
+    /**
+     * Timings for each function in the pilot run.
+     */
+    std::vector<Timings> pilot;
+
+    /**
+     * Standard deviation of the log-times for each function in the pilot run.
+     * If `PlanningOptions::baseline` is set, this is instead the standard deviation of the log-ratios against the baseline, and the entry for the baseline is zero.
+     */
+    std::vector<double> log_sd;
+
+    /**
+     * Number of iterations required for each function to detect `PlanningOptions::effect`.
+     * If `PlanningOptions::baseline` is set, the entry for the baseline itself is zero.
+     */
+    std::vector<int> required;
+
+    /**
+     * Number of iterations to run, i.e., the maximum of `required`.
+     */
+    int iterations = 0;
+
+    /**
+     * Estimated time to run `iterations` iterations of all functions, excluding burn-in, based on the mean times in the pilot run.
+     */
+    std::chrono::duration<double> estimated_time = std::chrono::duration<double>(0);
+
+    /**
+     * Whether the plan fits within the `Options::max_time_total` and `Options::max_time_per_function` in `PlanningOptions::timing`.
+     */
+    bool feasible = true;
+
+    /**
+     * Warning message if the plan is not feasible, otherwise an empty string.
+     */
+    std::string warning;
+
+    /**
+     * Timings for each function in the full measurement.
+     * This is only filled if `PlanningOptions::run = true`.
+     */
+    std::vector<Timings> timings;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+inline int required_sample_size(double sd, double effect, double significance, double power, bool paired) {
+    const double delta = std::abs(std::log1p(effect));
+    if (sd == 0 || delta == 0) {
+        return 2;
+    }
+
+    // Normal approximation to start, and then refining with the t-distribution,
+    // where the degrees of freedom depend on the sample size itself.
+    const double factor = (paired ? 1 : 2) * (sd / delta) * (sd / delta);
+    const double za = normal_quantile(1 - significance / 2), zb = normal_quantile(power);
+    double n = factor * (za + zb) * (za + zb);
+    for (int it = 0; it < 20; ++it) {
+        const double df = std::max(1.0, paired ? std::ceil(n) - 1 : 2 * std::ceil(n) - 2);
+        const double ta = t_quantile(1 - significance / 2, df), tb = t_quantile(power, df);
+        const double next = factor * (ta + tb) * (ta + tb);
+        if (std::abs(next - n) < 0.5) {
+            n = next;
+            break;
+        }
+        n = next;
+    }
+
+    if (!std::isfinite(n) || n > static_cast<double>(std::numeric_limits<int>::max())) {
+        throw std::runtime_error("required number of iterations is too large to be represented");
+    }
+    return std::max(2, static_cast<int>(std::ceil(n)));
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Plan the number of iterations required to detect a relative change in runtime, based on the variance of existing timings.
+ * The required number of iterations is computed from the power of a t-test on the log-times (or log-ratios, if `PlanningOptions::baseline` is set).
+ * `PlanningOptions::pilot` and `PlanningOptions::run` are ignored here.
+ *
+ * @param pilot Timings for each function from a pilot run of `time()`.
+ * Each function should have at least two timings, all of which should be positive.
+ * @param opt Further options.
+ *
+ * @return Plan for the number of iterations.
+ * `IterationPlan::pilot` and `IterationPlan::timings` are left empty.
+ */
+inline IterationPlan plan_iterations(const std::vector<Timings>& pilot, const PlanningOptions& opt) {
+    const auto nfun = pilot.size();
+    if (opt.baseline.has_value() && *opt.baseline >= nfun) {
+        throw std::runtime_error("baseline index is out of range");
+    }
+
+    // Zero durations are possible with coarse clocks but cannot be logged.
+    for (std::size_t f = 0; f < nfun; ++f) {
+        for (auto t : pilot[f].times) {
+            if (!(t.count() > 0)) {
+                throw std::runtime_error("pilot run contains a non-positive timing for function " + std::to_string(f) + ", consider increasing the work per call");
+            }
+        }
+    }
+
+    IterationPlan output;
+    output.log_sd.resize(nfun);
+    output.required.resize(nfun);
+
+    for (std::size_t f = 0; f < nfun; ++f) {
+        const auto& current = pilot[f];
+        std::vector<double> logged;
+
+        if (opt.baseline.has_value()) {
+            if (f == *opt.baseline) {
+                continue;
+            }
+            logged = internal::paired_log_ratios(pilot[*opt.baseline], current);
+        } else {
+            logged.reserve(current.times.size());
+            for (auto t : current.times) {
+                logged.push_back(std::log(t.count()));
+            }
+        }
+
+        if (logged.size() < 2) {
+            throw std::runtime_error("pilot run should contain at least two timings for function " + std::to_string(f));
+        }
+        const double sd = std::sqrt(internal::variance(logged, internal::mean(logged)));
+        output.log_sd[f] = sd;
+        output.required[f] = internal::required_sample_size(sd, opt.effect, opt.significance, opt.power, opt.baseline.has_value());
+        output.iterations = std::max(output.iterations, output.required[f]);
+    }
+
+    const auto& timing = opt.timing;
+    for (std::size_t f = 0; f < nfun; ++f) {
+        const auto expected = pilot[f].mean * output.iterations;
+        output.estimated_time += expected;
+        if (timing.max_time_per_function.has_value() && expected > *(timing.max_time_per_function)) {
+            output.feasible = false;
+            output.warning = "function " + std::to_string(f) + " needs an estimated " + std::to_string(expected.count()) +
+                " seconds for " + std::to_string(output.iterations) + " iterations, exceeding 'max_time_per_function'";
+        }
+    }
+
+    if (timing.max_time_total.has_value() && output.estimated_time > *(timing.max_time_total)) {
+        output.feasible = false;
+        output.warning = "an estimated " + std::to_string(output.estimated_time.count()) + " seconds is needed for " +
+            std::to_string(output.iterations) + " iterations, exceeding 'max_time_total'";
+    }
+
+    return output;
+}
+
+/**
+ * Run a short pilot with `time()` to estimate the variance of each function, and plan the number of iterations required to detect a relative change in runtime.
+ * This avoids guessing `Options::iterations`, which may be too small to detect the change of interest or wastefully large.
+ * See the other `plan_iterations()` overload for details.
+ *
+ * If `PlanningOptions::run = true`, the full measurement is then performed with the planned number of iterations.
+ * This is done even if the plan is not feasible, in which case `time()` stops early at the specified limits and the results will have less power than requested.
+ *
+ * @param funs Vector of functions to be timed, see `time()` for details.
+ * @param check Function that accepts a `Result_` and an index of `funs`, see `time()` for details.
+ * @param opt Further options.
+ *
+ * @return Plan for the number of iterations, including the pilot timings and (optionally) the full measurement.
+ *
+ * @tparam Result_ Result of each function call.
+ */
+template<typename Result_>
+IterationPlan plan_iterations(
+    const std::vector<std::function<Result_()> >& funs,
+    const std::function<void(const Result_&, std::size_t)>& check,
+    const PlanningOptions& opt
+) {
+    auto pilot = time<Result_>(funs, check, opt.pilot);
+    auto output = plan_iterations(pilot, opt);
+    output.pilot = std::move(pilot);
+
+    if (opt.run) {
+        auto topt = opt.timing;
+        topt.iterations = output.iterations;
+        output.timings = time<Result_>(funs, check, topt);
+    }
+
+    return output;
+}
+
+}
+
+#endif
@@ -0,0 +1,471 @@
+#ifndef EZTIMER_PROBE_HPP
+#define EZTIMER_PROBE_HPP
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <random>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <ostream>
+#include <istream>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+
+#include "calibration.hpp"
+#include "fingerprint.hpp"
+
+/**
+ * @file probe.hpp
+ * @brief Measure the memory hierarchy and timer of the current machine.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Options for `probe_machine()`.
+ */
+struct ProbeOptions {
+    /**
+     * Smallest working set for the latency curve, in bytes.
+     */
+    std::size_t min_size = 4 << 10;
+
+    /**
+     * Largest working set for the latency curve, in bytes.
+     * This should be larger than the last-level cache.
+     */
+    std::size_t max_size = 128 << 20;
+
+    /**
+     * Multiplicative step between consecutive working sets in the latency curve.
+     */
+    double step = std::sqrt(2.0);
+
+    /**
+     * Number of loads for each point of the latency curve.
+     */
+    std::size_t loads = 1 << 20;
+
+    /**
+     * Number of repeats for each measurement, of which the fastest is reported.
+     */
+    int repeats = 3;
+
+    /**
+     * Minimum ratio of the latencies between consecutive plateaus for a cache level to be reported.
+     */
+    double cliff_ratio = 1.5;
+
+    /**
+     * Size of each array for the bandwidth tests, in bytes.
+     * This should be larger than the last-level cache.
+     */
+    std::size_t bandwidth_size = 32 << 20;
+
+    /**
+     * Size of a cache line, in bytes.
+     * Each load in the latency curve touches a different cache line.
+     */
+    std::size_t cache_line = 64;
+
+    /**
+     * Seed for the random number generator used to create the pointer chases.
+     */
+    unsigned long long seed = 1234567;
+};
+
+/**
+ * @brief Measured characteristics of a machine.
+ */
+struct MachineProfile {
+    /**
+     * Fingerprint of the machine.
+     */
+    Fingerprint fingerprint;
+
+    /**
+     * Smallest non-zero difference between consecutive readings of `std::chrono::steady_clock`.
+     */
+    std::chrono::duration<double> timer_resolution = std::chrono::duration<double>(0);
+
+    /**
+     * Median difference between consecutive readings of `std::chrono::steady_clock`, i.e., the overhead of reading the clock.
+     */
+    std::chrono::duration<double> timer_overhead = std::chrono::duration<double>(0);
+
+    /**
+     * Working set sizes for the latency curve, in bytes.
+     */
+    std::vector<std::size_t> sizes;
+
+    /**
+     * Latency of a dependent load at each working set size in `sizes`.
+     */
+    std::vector<std::chrono::duration<double> > latencies;
+
+    /**
+     * Estimated capacity of each cache level, in bytes, from smallest to largest.
+     * This is the largest working set before each increase in `latencies`.
+     */
+    std::vector<std::size_t> cache_sizes;
+
+    /**
+     * Latency of each cache level in `cache_sizes`, followed by the latency of main memory.
+     */
+    std::vector<std::chrono::duration<double> > cache_latencies;
+
+    /**
+     * Bandwidth of the STREAM copy kernel (`a = b`), in bytes per second.
+     */
+    double copy_bandwidth = 0;
+
+    /**
+     * Bandwidth of the STREAM scale kernel (`a = s * b`), in bytes per second.
+     */
+    double scale_bandwidth = 0;
+
+    /**
+     * Bandwidth of the STREAM add kernel (`a = b + c`), in bytes per second.
+     */
+    double add_bandwidth = 0;
+
+    /**
+     * Bandwidth of the STREAM triad kernel (`a = b + s * c`), in bytes per second.
+     */
+    double triad_bandwidth = 0;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+template<class Function_>
+double fastest_seconds(int repeats, Function_ fun) {
+    double best = std::numeric_limits<double>::infinity();
+    for (int r = 0; r < std::max(repeats, 1); ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fun();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+inline void measure_timer(MachineProfile& profile) {
+    constexpr int n = 100000;
+    std::vector<double> diffs;
+    diffs.reserve(n);
+    double resolution = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < n; ++i) {
+        auto first = std::chrono::steady_clock::now();
+        auto second = std::chrono::steady_clock::now();
+        const double delta = std::chrono::duration<double>(second - first).count();
+        diffs.push_back(delta);
+        if (delta > 0) {
+            resolution = std::min(resolution, delta);
+        }
+    }
+    std::nth_element(diffs.begin(), diffs.begin() + n / 2, diffs.end());
+    profile.timer_overhead = std::chrono::duration<double>(diffs[n / 2]);
+    profile.timer_resolution = std::chrono::duration<double>(std::isfinite(resolution) ? resolution : 0);
+}
+
+// Pointer chase where each step lands on a different cache line, in random
+// order to defeat the prefetchers.
+inline std::vector<std::size_t> line_cycle(std::size_t bytes, std::size_t line, std::mt19937_64& rng) {
+    const std::size_t per_line = std::max(line / sizeof(std::size_t), static_cast<std::size_t>(1));
+    const std::size_t nlines = std::max(bytes / (per_line * sizeof(std::size_t)), static_cast<std::size_t>(1));
+    auto order = random_cycle(nlines, rng);
+    std::vector<std::size_t> output(nlines * per_line);
+    for (std::size_t l = 0; l < nlines; ++l) {
+        output[l * per_line] = order[l] * per_line;
+    }
+    return output;
+}
+
+struct Cliff {
+    std::size_t before; // last index on the lower plateau.
+    std::size_t after; // first index on the upper plateau, or the last index if the curve never flattens.
+    double plateau; // value at the start of the lower plateau.
+};
+
+// Walking along a curve and recording a cliff whenever the value climbs past
+// the current plateau by the specified ratio. The plateau is then reset once
+// the curve flattens out again.
+inline std::vector<Cliff> find_cliffs(const std::vector<double>& values, double ratio) {
+    std::vector<Cliff> output;
+    const auto n = values.size();
+    if (n == 0) {
+        return output;
+    }
+
+    const double flat = std::sqrt(ratio);
+    double plateau = values[0];
+    std::size_t last_flat = 0;
+    bool climbing = false;
+    for (std::size_t i = 1; i < n; ++i) {
+        const double current = values[i];
+        if (!climbing) {
+            if (current > plateau * ratio) {
+                output.push_back(Cliff{ last_flat, n - 1, plateau });
+                climbing = true;
+            } else if (current <= plateau * flat) {
+                last_flat = i;
+            }
+        }
+        if (climbing && i + 1 < n && values[i + 1] <= current * flat) {
+            climbing = false;
+            plateau = values[i + 1];
+            last_flat = i + 1;
+            output.back().after = i + 1;
+        }
+    }
+    return output;
+}
+
+inline void detect_cache_levels(MachineProfile& profile, double cliff_ratio) {
+    profile.cache_sizes.clear();
+    profile.cache_latencies.clear();
+    if (profile.sizes.empty()) {
+        return;
+    }
+
+    std::vector<double> latencies;
+    latencies.reserve(profile.latencies.size());
+    for (auto lat : profile.latencies) {
+        latencies.push_back(lat.count());
+    }
+    for (const auto& cliff : find_cliffs(latencies, cliff_ratio)) {
+        profile.cache_sizes.push_back(profile.sizes[cliff.before]);
+        profile.cache_latencies.emplace_back(cliff.plateau);
+    }
+    profile.cache_latencies.push_back(profile.latencies.back());
+}
+
+inline void measure_bandwidth(MachineProfile& profile, const ProbeOptions& opt) {
+    const std::size_t n = std::max(opt.bandwidth_size / sizeof(double), static_cast<std::size_t>(1));
+    std::vector<double> a(n, 1), b(n, 2), c(n, 0);
+    const double scalar = 3;
+    const double bytes = static_cast<double>(n) * sizeof(double);
+
+    const double copy = fastest_seconds(opt.repeats, [&]() -> void { std::copy(a.begin(), a.end(), c.begin()); });
+    const double scale = fastest_seconds(opt.repeats, [&]() -> void {
+        for (std::size_t i = 0; i < n; ++i) {
+            b[i] = scalar * c[i];
+        }
+    });
+    const double add = fastest_seconds(opt.repeats, [&]() -> void {
+        for (std::size_t i = 0; i < n; ++i) {
+            c[i] = a[i] + b[i];
+        }
+    });
+    const double triad = fastest_seconds(opt.repeats, [&]() -> void {
+        for (std::size_t i = 0; i < n; ++i) {
+            a[i] = b[i] + scalar * c[i];
+        }
+    });
+
+    // Using the volatile sink to ensure that the arrays are used.
+    volatile double sink = a[n / 2] + b[n / 3] + c[n / 4];
+    (void)sink;
+
+    profile.copy_bandwidth = 2 * bytes / copy;
+    profile.scale_bandwidth = 2 * bytes / scale;
+    profile.add_bandwidth = 3 * bytes / add;
+    profile.triad_bandwidth = 3 * bytes / triad;
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Measure the memory hierarchy and timer of the current machine, to help interpret the results of `time()`.
+ * This may take several seconds with the default options, so the profile should be cached with `cached_probe()`.
+ *
+ * The latency curve is measured by chasing pointers through a random cycle of cache lines at each working set size.
+ * Cache levels are reported at the working set sizes where the latency jumps to a new plateau.
+ * The bandwidth is measured with the STREAM kernels on arrays of `ProbeOptions::bandwidth_size` bytes, counting the bytes read and written in the same manner as STREAM.
+ *
+ * @param opt Further options.
+ *
+ * @return Profile of the current machine.
+ */
+inline MachineProfile probe_machine(const ProbeOptions& opt = ProbeOptions()) {
+    MachineProfile output;
+    output.fingerprint = machine_fingerprint();
+    internal::measure_timer(output);
+
+    std::mt19937_64 rng(opt.seed);
+    const double step = std::max(opt.step, 1.01);
+    double size = std::max(opt.min_size, opt.cache_line);
+    while (size <= static_cast<double>(opt.max_size)) {
+        const auto bytes = static_cast<std::size_t>(size);
+        auto cycle = internal::line_cycle(bytes, opt.cache_line, rng);
+        std::size_t result = 0;
+        internal::pointer_chase(cycle, opt.loads / 10); // warming up the caches.
+        const double seconds = internal::fastest_seconds(opt.repeats, [&]() -> void { result += internal::pointer_chase(cycle, opt.loads); });
+        volatile std::size_t sink = result;
+        (void)sink;
+
+        if (output.sizes.empty() || output.sizes.back() != bytes) {
+            output.sizes.push_back(bytes);
+            output.latencies.emplace_back(seconds / std::max(opt.loads, static_cast<std::size_t>(1)));
+        }
+        size *= step;
+    }
+    internal::detect_cache_levels(output, opt.cliff_ratio);
+
+    internal::measure_bandwidth(output, opt);
+    return output;
+}
+
+/**
+ * Write a machine profile in a tab-separated text format, e.g., to embed in other output files.
+ * Each line contains a key followed by one or more values.
+ *
+ * @param out Output stream.
+ * @param profile Machine profile, typically from `probe_machine()`.
+ */
+inline void write_machine_profile(std::ostream& out, const MachineProfile& profile) {
+    const auto& fp = profile.fingerprint;
+    out << "fingerprint\t" << fingerprint_id(fp) << "\n";
+    out << "hostname\t" << fp.hostname << "\n";
+    out << "cpu_model\t" << fp.cpu_model << "\n";
+    out << "cpus\t" << fp.cpus << "\n";
+    out << "memory\t" << fp.memory << "\n";
+    out << "os\t" << fp.os << "\n";
+    out << "compiler\t" << fp.compiler << "\n";
+
+    auto old = out.precision(17);
+    out << "timer_resolution\t" << profile.timer_resolution.count() << "\n";
+    out << "timer_overhead\t" << profile.timer_overhead.count() << "\n";
+    for (std::size_t i = 0; i < profile.sizes.size(); ++i) {
+        out << "latency\t" << profile.sizes[i] << "\t" << profile.latencies[i].count() << "\n";
+    }
+    for (std::size_t i = 0; i < profile.cache_sizes.size(); ++i) {
+        out << "cache\t" << profile.cache_sizes[i] << "\t" << profile.cache_latencies[i].count() << "\n";
+    }
+    if (!profile.cache_latencies.empty()) {
+        out << "memory_latency\t" << profile.cache_latencies.back().count() << "\n";
+    }
+    out << "copy_bandwidth\t" << profile.copy_bandwidth << "\n";
+    out << "scale_bandwidth\t" << profile.scale_bandwidth << "\n";
+    out << "add_bandwidth\t" << profile.add_bandwidth << "\n";
+    out << "triad_bandwidth\t" << profile.triad_bandwidth << "\n";
+    out.precision(old);
+}
+
+/**
+ * Read a machine profile from the format of `write_machine_profile()`.
+ * Unknown keys are ignored.
+ *
+ * @param in Input stream.
+ *
+ * @return Machine profile.
+ */
+inline MachineProfile read_machine_profile(std::istream& in) {
+    MachineProfile output;
+    auto& fp = output.fingerprint;
+    std::string line;
+    while (std::getline(in, line)) {
+        const auto tab = line.find('\t');
+        if (tab == std::string::npos) {
+            continue;
+        }
+        const auto key = line.substr(0, tab);
+        const auto value = line.substr(tab + 1);
+        std::istringstream values(value);
+
+        if (key == "hostname") {
+            fp.hostname = value;
+        } else if (key == "cpu_model") {
+            fp.cpu_model = value;
+        } else if (key == "cpus") {
+            values >> fp.cpus;
+        } else if (key == "memory") {
+            values >> fp.memory;
+        } else if (key == "os") {
+            fp.os = value;
+        } else if (key == "compiler") {
+            fp.compiler = value;
+        } else if (key == "timer_resolution" || key == "timer_overhead") {
+            double val = 0;
+            values >> val;
+            (key == "timer_resolution" ? output.timer_resolution : output.timer_overhead) = std::chrono::duration<double>(val);
+        } else if (key == "latency" || key == "cache") {
+            std::size_t bytes = 0;
+            double val = 0;
+            if (!(values >> bytes >> val)) {
+                throw std::runtime_error("invalid '" + key + "' line in machine profile");
+            }
+            if (key == "latency") {
+                output.sizes.push_back(bytes);
+                output.latencies.emplace_back(val);
+            } else {
+                output.cache_sizes.push_back(bytes);
+                output.cache_latencies.emplace_back(val);
+            }
+        } else if (key == "memory_latency") {
+            double val = 0;
+            values >> val;
+            output.cache_latencies.emplace_back(val);
+        } else if (key == "copy_bandwidth") {
+            values >> output.copy_bandwidth;
+        } else if (key == "scale_bandwidth") {
+            values >> output.scale_bandwidth;
+        } else if (key == "add_bandwidth") {
+            values >> output.add_bandwidth;
+        } else if (key == "triad_bandwidth") {
+            values >> output.triad_bandwidth;
+        }
+    }
+    return output;
+}
+
+/**
+ * Load a cached machine profile from disk, or probe the machine and save the profile if no valid cache is available.
+ * The cache is only used if its fingerprint matches that of the current machine, so a cache file can be safely shared between machines (e.g., on a network drive).
+ * For example, the profile can be cached alongside the timings in a `ResultsStore` directory.
+ *
+ * @param path Path to the cache file.
+ * Parent directories are created if they do not already exist.
+ * @param opt Options to pass to `probe_machine()`.
+ *
+ * @return Profile of the current machine.
+ */
+inline MachineProfile cached_probe(const std::filesystem::path& path, const ProbeOptions& opt = ProbeOptions()) {
+    const auto current = fingerprint_id(machine_fingerprint());
+    {
+        std::ifstream handle(path);
+        if (handle) {
+            auto loaded = read_machine_profile(handle);
+            if (fingerprint_id(loaded.fingerprint) == current) {
+                return loaded;
+            }
+        }
+    }
+
+    auto output = probe_machine(opt);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+    std::ofstream handle(path);
+    write_machine_profile(handle, output);
+    if (!handle) {
+        throw std::runtime_error("failed to write machine profile to '" + path.string() + "'");
+    }
+    return output;
+}
+
+}
+
+#endif
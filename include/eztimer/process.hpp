@@ -0,0 +1,383 @@
+#ifndef EZTIMER_PROCESS_HPP
+#define EZTIMER_PROCESS_HPP
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <utility>
+#include <cstdlib>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <stdexcept>
+#include <functional>
+#include <unordered_set>
+
+#include <spawn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "eztimer.hpp"
+
+extern char** environ;
+
+/**
+ * @file process.hpp
+ * @brief Time the execution of child processes.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Command to be executed in a child process.
+ */
+struct Command {
+    /**
+     * Command-line arguments, where the first entry is the executable.
+     * If this does not contain a slash, the executable is searched for in the `PATH`.
+     */
+    std::vector<std::string> arguments;
+
+    /**
+     * Environment variables to set in the child process, as pairs of names and values.
+     * These are added to (or override) the environment of the parent process.
+     */
+    std::vector<std::pair<std::string, std::string> > environment;
+};
+
+/**
+ * @brief Resource usage and reported timings for a single run of a child process.
+ */
+struct ProcessRun {
+    /**
+     * User CPU time.
+     */
+    std::chrono::duration<double> user = std::chrono::duration<double>(0);
+
+    /**
+     * System CPU time.
+     */
+    std::chrono::duration<double> system = std::chrono::duration<double>(0);
+
+    /**
+     * Maximum resident set size, in kilobytes.
+     */
+    long max_rss = 0;
+
+    /**
+     * Number of minor page faults, i.e., those not requiring I/O.
+     */
+    long minor_faults = 0;
+
+    /**
+     * Number of major page faults, i.e., those requiring I/O.
+     */
+    long major_faults = 0;
+
+    /**
+     * Number of voluntary context switches.
+     */
+    long voluntary_switches = 0;
+
+    /**
+     * Number of involuntary context switches.
+     */
+    long involuntary_switches = 0;
+
+    /**
+     * Timings reported by the child with `report_to_parent()`, as pairs of names and times in seconds.
+     */
+    std::vector<std::pair<std::string, double> > reported;
+};
+
+/**
+ * @brief Options for `time_processes()`.
+ */
+struct ProcessOptions {
+    /**
+     * Whether to use the total time reported by each child with `report_to_parent()` instead of the wall time of the child process.
+     * If true, an error is thrown if a child does not report any times.
+     */
+    bool use_reported = false;
+
+    /**
+     * Further options to pass to `time()`.
+     * Note that `Options::counters` will only count events in the parent process.
+     */
+    Options timing;
+};
+
+/**
+ * @brief Timings for each command.
+ */
+struct ProcessTimings {
+    /**
+     * Timings for each command.
+     * Each time is either the wall time of the child process or the total reported time, depending on `ProcessOptions::use_reported`.
+     */
+    std::vector<Timings> timings;
+
+    /**
+     * Details for each run (inner vector, parallel to `Timings::times`) of each command (outer vector).
+     */
+    std::vector<std::vector<ProcessRun> > runs;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+constexpr const char* report_variable = "EZTIMER_REPORT_FD";
+
+inline double to_seconds(const timeval& tv) {
+    return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1e6;
+}
+
+inline void parse_reports(const std::string& contents, std::vector<std::pair<std::string, double> >& reported) {
+    std::size_t start = 0;
+    while (start < contents.size()) {
+        auto end = contents.find('\n', start);
+        if (end == std::string::npos) {
+            end = contents.size();
+        }
+        auto tab = contents.rfind('\t', end);
+        if (tab != std::string::npos && tab >= start) {
+            reported.emplace_back(contents.substr(start, tab - start), std::strtod(contents.c_str() + tab + 1, NULL));
+        }
+        start = end + 1;
+    }
+}
+
+inline ProcessRun run_process(const Command& command) {
+    if (command.arguments.empty()) {
+        throw std::runtime_error("command should contain at least one argument");
+    }
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        throw std::runtime_error("failed to create a pipe for the child process");
+    }
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+
+    // Assembling the environment, with overrides replacing any existing
+    // definitions of the same variables.
+    std::unordered_set<std::string> overridden;
+    for (const auto& env : command.environment) {
+        overridden.insert(env.first);
+    }
+    overridden.insert(report_variable);
+
+    std::vector<std::string> env_store;
+    for (char** e = environ; *e != NULL; ++e) {
+        const char* eq = std::strchr(*e, '=');
+        std::string name = (eq == NULL ? std::string(*e) : std::string(static_cast<const char*>(*e), eq));
+        if (overridden.find(name) == overridden.end()) {
+            env_store.emplace_back(*e);
+        }
+    }
+    for (const auto& env : command.environment) {
+        env_store.push_back(env.first + "=" + env.second);
+    }
+    env_store.push_back(std::string(report_variable) + "=" + std::to_string(fds[1]));
+
+    std::vector<char*> envp;
+    envp.reserve(env_store.size() + 1);
+    for (auto& e : env_store) {
+        envp.push_back(e.data());
+    }
+    envp.push_back(NULL);
+
+    std::vector<std::string> arg_store(command.arguments);
+    std::vector<char*> argv;
+    argv.reserve(arg_store.size() + 1);
+    for (auto& a : arg_store) {
+        argv.push_back(a.data());
+    }
+    argv.push_back(NULL);
+
+    pid_t pid;
+    const int status = posix_spawnp(&pid, argv[0], NULL, NULL, argv.data(), envp.data());
+    close(fds[1]);
+    if (status != 0) {
+        close(fds[0]);
+        throw std::runtime_error("failed to spawn '" + command.arguments[0] + "': " + std::strerror(status));
+    }
+
+    std::string contents;
+    char buffer[4096];
+    while (true) {
+        auto nread = read(fds[0], buffer, sizeof(buffer));
+        if (nread > 0) {
+            contents.append(buffer, nread);
+        } else if (nread == 0 || errno != EINTR) {
+            break;
+        }
+    }
+    close(fds[0]);
+
+    int wstatus = 0;
+    rusage usage;
+    while (wait4(pid, &wstatus, 0, &usage) < 0) {
+        if (errno != EINTR) {
+            throw std::runtime_error("failed to wait for '" + command.arguments[0] + "'");
+        }
+    }
+    if (!WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 0) {
+        throw std::runtime_error("'" + command.arguments[0] + "' did not exit successfully");
+    }
+
+    ProcessRun output;
+    output.user = std::chrono::duration<double>(to_seconds(usage.ru_utime));
+    output.system = std::chrono::duration<double>(to_seconds(usage.ru_stime));
+#ifdef __APPLE__
+    output.max_rss = usage.ru_maxrss / 1024;
+#else
+    output.max_rss = usage.ru_maxrss;
+#endif
+    output.minor_faults = usage.ru_minflt;
+    output.major_faults = usage.ru_majflt;
+    output.voluntary_switches = usage.ru_nvcsw;
+    output.involuntary_switches = usage.ru_nivcsw;
+    parse_reports(contents, output.reported);
+    return output;
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Time the execution of child processes, e.g., different builds of the same program.
+ * Each command is treated as a function in `time()`, so the commands are run in a random order per iteration, with burn-in and runtime caps.
+ * This allows comparisons between entire executables with the same machinery (e.g., `compare_paired()`) as in-process functions.
+ *
+ * By default, the recorded time is the wall time between spawning the child and its exit, which includes the process creation overhead.
+ * Alternatively, the child can report its own timings with `report_to_parent()`, see `ProcessOptions::use_reported`.
+ * An error is thrown if any child process does not exit successfully.
+ *
+ * @param commands Vector of commands to be timed.
+ * @param opt Further options.
+ *
+ * @return Timings and resource usage for each command.
+ */
+inline ProcessTimings time_processes(const std::vector<Command>& commands, const ProcessOptions& opt) {
+    const auto ncom = commands.size();
+    std::vector<std::function<ProcessRun()> > funs;
+    funs.reserve(ncom);
+    for (const auto& com : commands) {
+        funs.emplace_back([&com]() -> ProcessRun { return internal::run_process(com); });
+    }
+
+    ProcessTimings output;
+    output.runs.resize(ncom);
+    output.timings = time<ProcessRun>(
+        funs,
+        [&](const ProcessRun& res, std::size_t i) -> void {
+            output.runs[i].push_back(res);
+        },
+        opt.timing
+    );
+
+    if (opt.use_reported) {
+        for (std::size_t c = 0; c < ncom; ++c) {
+            auto& curout = output.timings[c];
+            const auto& curruns = output.runs[c];
+            for (std::size_t r = 0; r < curruns.size(); ++r) {
+                if (curruns[r].reported.empty()) {
+                    throw std::runtime_error("'" + commands[c].arguments[0] + "' did not report any times");
+                }
+                double total = 0;
+                for (const auto& rep : curruns[r].reported) {
+                    total += rep.second;
+                }
+                curout.times[r] = std::chrono::duration<double>(total);
+            }
+            compute_statistics(curout);
+        }
+    }
+
+    return output;
+}
+
+/**
+ * Collect the timings reported under a particular name by each run of a command.
+ * This is useful when a child process reports timings for multiple functions.
+ *
+ * @param timings Output of `time_processes()`.
+ * @param command Index of the command of interest.
+ * @param name Name of the reported timing.
+ *
+ * @return Timings for `name`.
+ * If a run reports `name` multiple times, the sum is used.
+ * Runs that do not report `name` are skipped.
+ */
+inline Timings reported_timings(const ProcessTimings& timings, std::size_t command, const std::string& name) {
+    Timings output;
+    const auto& curruns = timings.runs[command];
+    const auto& curiter = timings.timings[command].iterations;
+    for (std::size_t r = 0; r < curruns.size(); ++r) {
+        bool found = false;
+        double total = 0;
+        for (const auto& rep : curruns[r].reported) {
+            if (rep.first == name) {
+                found = true;
+                total += rep.second;
+            }
+        }
+        if (found) {
+            output.times.emplace_back(total);
+            if (r < curiter.size()) {
+                output.iterations.push_back(curiter[r]);
+            }
+        }
+    }
+    compute_statistics(output);
+    return output;
+}
+
+/**
+ * Report a timing to the parent process, for use in a child process that is run by `time_processes()`.
+ * This is a no-op if the current process was not started by `time_processes()`.
+ *
+ * @param name Name of the timing, e.g., the name of the function.
+ * This should not contain tabs or newlines.
+ * @param time Time in seconds.
+ *
+ * @return Whether the timing was reported.
+ */
+inline bool report_to_parent(const std::string& name, std::chrono::duration<double> time) {
+    const char* fdstr = std::getenv(internal::report_variable);
+    if (fdstr == NULL) {
+        return false;
+    }
+    const int fd = std::atoi(fdstr);
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%.17g", time.count());
+    const std::string line = name + "\t" + buffer + "\n";
+    return write(fd, line.c_str(), line.size()) == static_cast<ssize_t>(line.size());
+}
+
+/**
+ * Report the mean runtime of each function to the parent process, typically from the output of `time()` in the child.
+ *
+ * @param timings Timings for each function.
+ * @param names Name of each function, of length equal to `timings.size()`.
+ *
+ * @return Whether the timings were reported.
+ */
+inline bool report_to_parent(const std::vector<Timings>& timings, const std::vector<std::string>& names) {
+    bool okay = true;
+    for (std::size_t f = 0; f < timings.size(); ++f) {
+        okay = report_to_parent(names[f], timings[f].mean) && okay;
+    }
+    return okay;
+}
+
+}
+
+#endif
@@ -0,0 +1,405 @@
+#ifndef EZTIMER_ROOFLINE_HPP
+#define EZTIMER_ROOFLINE_HPP
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <ostream>
+#include <stdexcept>
+#include <algorithm>
+
+#include "eztimer.hpp"
+#include "probe.hpp"
+
+/**
+ * @file roofline.hpp
+ * @brief Place timed functions on a roofline plot.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Work performed by a single call to a function.
+ */
+struct RooflineWork {
+    /**
+     * Number of floating-point operations per call.
+     * A fused multiply-add counts as two operations.
+     */
+    double flops = 0;
+
+    /**
+     * Number of bytes transferred to and from main memory per call.
+     */
+    double bytes = 0;
+};
+
+/**
+ * @brief Options for `roofline()`.
+ */
+struct RooflineOptions {
+    /**
+     * Peak floating-point throughput of the machine, in operations per second.
+     * If not set, this is measured with `measure_peak_flops()`.
+     */
+    std::optional<double> peak_flops;
+
+    /**
+     * Peak memory bandwidth of the machine, in bytes per second.
+     * If not set, this is taken from the STREAM triad bandwidth in `profile`, or measured directly if `profile` is also not set.
+     */
+    std::optional<double> peak_bandwidth;
+
+    /**
+     * Profile of the current machine, typically from `cached_probe()`.
+     */
+    std::optional<MachineProfile> profile;
+
+    /**
+     * Number of floating-point operations for `measure_peak_flops()`.
+     */
+    std::size_t operations = 1 << 26;
+
+    /**
+     * Number of repeats for measuring the peaks, where the fastest repeat is used.
+     */
+    int repeats = 5;
+
+    /**
+     * Options for measuring the memory bandwidth, if neither `peak_bandwidth` nor `profile` is set.
+     */
+    ProbeOptions probe;
+};
+
+/**
+ * @brief Position of a function on the roofline.
+ */
+struct RooflinePoint {
+    /**
+     * Work per call, as supplied to `roofline()`.
+     */
+    RooflineWork work;
+
+    /**
+     * Arithmetic intensity, in floating-point operations per byte.
+     * This is infinite if `RooflineWork::bytes` is zero.
+     */
+    double intensity = 0;
+
+    /**
+     * Attained floating-point throughput, in operations per second.
+     */
+    double attained = 0;
+
+    /**
+     * Attained memory bandwidth, in bytes per second.
+     */
+    double bandwidth = 0;
+
+    /**
+     * Attainable floating-point throughput at this arithmetic intensity, in operations per second.
+     * This is the lesser of the peak throughput and the product of the peak bandwidth and `intensity`.
+     */
+    double attainable = 0;
+
+    /**
+     * Ratio of `attained` to `attainable`.
+     */
+    double efficiency = 0;
+
+    /**
+     * Whether the function is memory-bound, i.e., `intensity` is below the ridge point.
+     * Otherwise, the function is compute-bound.
+     */
+    bool memory_bound = false;
+};
+
+/**
+ * @brief Roofline for a set of functions.
+ */
+struct Roofline {
+    /**
+     * Peak floating-point throughput, in operations per second.
+     */
+    double peak_flops = 0;
+
+    /**
+     * Peak memory bandwidth, in bytes per second.
+     */
+    double peak_bandwidth = 0;
+
+    /**
+     * Arithmetic intensity at which the bandwidth and compute roofs meet, in floating-point operations per byte.
+     */
+    double ridge = 0;
+
+    /**
+     * Position of each function on the roofline.
+     */
+    std::vector<RooflinePoint> points;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+// Independent chains of multiply-adds so that the throughput, rather than the
+// latency, of the floating-point units is measured. Using an array allows the
+// compiler to vectorize across the chains.
+inline double peak_flops_kernel(std::size_t operations) {
+    constexpr std::size_t nchains = 32;
+    double acc[nchains];
+    for (std::size_t c = 0; c < nchains; ++c) {
+        acc[c] = c;
+    }
+    const double mult = 0.999999, add = 1e-7;
+    for (std::size_t i = 0; i < operations; i += 2 * nchains) {
+        for (std::size_t c = 0; c < nchains; ++c) {
+            acc[c] = acc[c] * mult + add;
+        }
+    }
+    double total = 0;
+    for (std::size_t c = 0; c < nchains; ++c) {
+        total += acc[c];
+    }
+    return total;
+}
+
+inline std::string xml_escape(const std::string& text) {
+    std::string output;
+    output.reserve(text.size());
+    for (auto c : text) {
+        switch (c) {
+            case '&': output += "&amp;"; break;
+            case '<': output += "&lt;"; break;
+            case '>': output += "&gt;"; break;
+            case '"': output += "&quot;"; break;
+            case '\'': output += "&apos;"; break;
+            default: output += c;
+        }
+    }
+    return output;
+}
+
+inline std::string csv_escape(const std::string& text) {
+    if (text.find_first_of(",\"\n") == std::string::npos) {
+        return text;
+    }
+    std::string output = "\"";
+    for (auto c : text) {
+        if (c == '"') {
+            output += '"';
+        }
+        output += c;
+    }
+    output += '"';
+    return output;
+}
+
+inline std::string roofline_name(const std::vector<std::string>& names, std::size_t i, std::size_t n) {
+    if (names.empty()) {
+        return std::to_string(i);
+    }
+    if (names.size() != n) {
+        throw std::runtime_error("length of 'names' should be equal to the number of points");
+    }
+    return names[i];
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Measure the peak floating-point throughput of a single core, using independent chains of double-precision multiply-adds.
+ * This is the throughput attainable by compiler-generated code with the current compilation flags, which may be lower than the theoretical peak if the compiler does not use the widest vector instructions.
+ *
+ * @param operations Number of floating-point operations in each repeat.
+ * @param repeats Number of repeats, where the fastest repeat is used.
+ *
+ * @return Peak throughput, in floating-point operations per second.
+ */
+inline double measure_peak_flops(std::size_t operations = 1 << 26, int repeats = 5) {
+    operations = std::max(operations, static_cast<std::size_t>(64));
+    double result = 0;
+    internal::peak_flops_kernel(operations / 10); // warming up.
+    const double seconds = internal::fastest_seconds(repeats, [&]() -> void { result += internal::peak_flops_kernel(operations); });
+    volatile double sink = result;
+    (void)sink;
+    return static_cast<double>(operations) / seconds;
+}
+
+/**
+ * Place each function on a roofline, to determine whether it is compute-bound or memory-bound and how close it is to the attainable performance.
+ * The work per call is declared by the user, e.g., by counting the operations and the unique bytes accessed by each function.
+ *
+ * @param timings Timings for each function, typically from `time()`.
+ * @param work Work per call for each function.
+ * This should have the same length as `timings`.
+ * @param opt Further options.
+ *
+ * @return The machine's peaks and the position of each function on the roofline.
+ */
+inline Roofline roofline(const std::vector<Timings>& timings, const std::vector<RooflineWork>& work, const RooflineOptions& opt = RooflineOptions()) {
+    if (timings.size() != work.size()) {
+        throw std::runtime_error("'timings' and 'work' should have the same length");
+    }
+
+    Roofline output;
+    if (opt.peak_flops.has_value()) {
+        output.peak_flops = *(opt.peak_flops);
+    } else {
+        output.peak_flops = measure_peak_flops(opt.operations, opt.repeats);
+    }
+
+    if (opt.peak_bandwidth.has_value()) {
+        output.peak_bandwidth = *(opt.peak_bandwidth);
+    } else if (opt.profile.has_value()) {
+        output.peak_bandwidth = opt.profile->triad_bandwidth;
+    } else {
+        MachineProfile profile;
+        internal::measure_bandwidth(profile, opt.probe);
+        output.peak_bandwidth = profile.triad_bandwidth;
+    }
+
+    if (!(output.peak_flops > 0) || !(output.peak_bandwidth > 0)) {
+        throw std::runtime_error("peak throughput and bandwidth should be positive");
+    }
+    output.ridge = output.peak_flops / output.peak_bandwidth;
+
+    output.points.reserve(work.size());
+    for (std::size_t i = 0; i < work.size(); ++i) {
+        const auto& curwork = work[i];
+        if (curwork.flops < 0 || curwork.bytes < 0) {
+            throw std::runtime_error("work should be non-negative");
+        }
+
+        RooflinePoint point;
+        point.work = curwork;
+        point.intensity = (curwork.bytes > 0 ? curwork.flops / curwork.bytes : std::numeric_limits<double>::infinity());
+        const double seconds = timings[i].mean.count();
+        point.attained = curwork.flops / seconds;
+        point.bandwidth = curwork.bytes / seconds;
+        point.attainable = (curwork.bytes > 0 ? std::min(output.peak_flops, output.peak_bandwidth * point.intensity) : output.peak_flops);
+        point.efficiency = (point.attainable > 0 ? point.attained / point.attainable : 0);
+        point.memory_bound = point.intensity < output.ridge;
+        output.points.push_back(point);
+    }
+
+    return output;
+}
+
+/**
+ * Write the roofline in CSV format, with one row per function.
+ * The header row contains `name`, `flops`, `bytes`, `intensity`, `attained`, `bandwidth`, `attainable`, `efficiency` and `bound`,
+ * where `bound` is either `memory` or `compute`.
+ *
+ * @param out Output stream.
+ * @param roof Roofline, typically from `roofline()`.
+ * @param names Name of each function.
+ * If empty, the index of each function is used instead.
+ */
+inline void write_roofline_csv(std::ostream& out, const Roofline& roof, const std::vector<std::string>& names = std::vector<std::string>()) {
+    const auto n = roof.points.size();
+    std::ostringstream buffer;
+    buffer.precision(std::numeric_limits<double>::max_digits10);
+    buffer << "name,flops,bytes,intensity,attained,bandwidth,attainable,efficiency,bound\n";
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto& point = roof.points[i];
+        buffer << internal::csv_escape(internal::roofline_name(names, i, n)) << ","
+            << point.work.flops << "," << point.work.bytes << "," << point.intensity << ","
+            << point.attained << "," << point.bandwidth << "," << point.attainable << "," << point.efficiency << ","
+            << (point.memory_bound ? "memory" : "compute") << "\n";
+    }
+    out << buffer.str();
+}
+
+/**
+ * Write the roofline as an SVG plot, with logarithmic axes for the arithmetic intensity and the floating-point throughput.
+ * Each function is drawn as a labelled point below the roof, which consists of the bandwidth slope and the compute ceiling.
+ * Functions with no memory traffic or no floating-point operations are not drawn.
+ *
+ * @param out Output stream.
+ * @param roof Roofline, typically from `roofline()`.
+ * @param names Name of each function.
+ * If empty, the index of each function is used instead.
+ */
+inline void write_roofline_svg(std::ostream& out, const Roofline& roof, const std::vector<std::string>& names = std::vector<std::string>()) {
+    const auto n = roof.points.size();
+    std::vector<std::string> labels;
+    labels.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        labels.push_back(internal::roofline_name(names, i, n));
+    }
+
+    // Choosing whole decades that cover the ridge, the points and the start of the roof.
+    double xlo = roof.ridge / 10, xhi = roof.ridge * 10, ylo = roof.peak_flops / 10;
+    for (const auto& point : roof.points) {
+        if (std::isfinite(point.intensity) && point.intensity > 0 && point.attained > 0) {
+            xlo = std::min(xlo, point.intensity / 2);
+            xhi = std::max(xhi, point.intensity * 2);
+            ylo = std::min(ylo, point.attained / 2);
+        }
+    }
+    ylo = std::min(ylo, roof.peak_bandwidth * xlo);
+    const double lxlo = std::floor(std::log10(xlo)), lxhi = std::ceil(std::log10(xhi));
+    const double lylo = std::floor(std::log10(ylo)), lyhi = std::ceil(std::log10(roof.peak_flops * 2));
+
+    constexpr double width = 640, height = 480, left = 80, right = 20, top = 40, bottom = 60;
+    auto xpos = [&](double x) -> double { return left + (std::log10(x) - lxlo) / (lxhi - lxlo) * (width - left - right); };
+    auto ypos = [&](double y) -> double { return height - bottom - (std::log10(y) - lylo) / (lyhi - lylo) * (height - top - bottom); };
+
+    std::ostringstream buffer;
+    buffer.precision(6);
+    buffer << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width << "\" height=\"" << height << "\" viewBox=\"0 0 " << width << " " << height << "\" font-family=\"sans-serif\" font-size=\"12\">\n";
+    buffer << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+    buffer << "<text x=\"" << width / 2 << "\" y=\"24\" text-anchor=\"middle\" font-size=\"16\">Roofline</text>\n";
+
+    // Grid lines and tick labels at each decade.
+    for (double d = lxlo; d <= lxhi; ++d) {
+        const double x = xpos(std::pow(10, d));
+        buffer << "<line x1=\"" << x << "\" y1=\"" << top << "\" x2=\"" << x << "\" y2=\"" << height - bottom << "\" stroke=\"#dddddd\"/>\n";
+        buffer << "<text x=\"" << x << "\" y=\"" << height - bottom + 16 << "\" text-anchor=\"middle\">1e" << d << "</text>\n";
+    }
+    for (double d = lylo; d <= lyhi; ++d) {
+        const double y = ypos(std::pow(10, d));
+        buffer << "<line x1=\"" << left << "\" y1=\"" << y << "\" x2=\"" << width - right << "\" y2=\"" << y << "\" stroke=\"#dddddd\"/>\n";
+        buffer << "<text x=\"" << left - 6 << "\" y=\"" << y + 4 << "\" text-anchor=\"end\">1e" << d << "</text>\n";
+    }
+    buffer << "<rect x=\"" << left << "\" y=\"" << top << "\" width=\"" << width - left - right << "\" height=\"" << height - top - bottom << "\" fill=\"none\" stroke=\"black\"/>\n";
+    buffer << "<text x=\"" << (left + width - right) / 2 << "\" y=\"" << height - 16 << "\" text-anchor=\"middle\">Arithmetic intensity (FLOP/byte)</text>\n";
+    buffer << "<text transform=\"translate(20," << (top + height - bottom) / 2 << ") rotate(-90)\" text-anchor=\"middle\">Performance (FLOP/s)</text>\n";
+
+    // The roof itself, from the left edge up the bandwidth slope to the ridge and then along the compute ceiling.
+    const double xmin = std::pow(10, lxlo), xmax = std::pow(10, lxhi);
+    buffer << "<polyline fill=\"none\" stroke=\"#1f77b4\" stroke-width=\"2\" points=\""
+        << xpos(xmin) << "," << ypos(roof.peak_bandwidth * xmin) << " "
+        << xpos(roof.ridge) << "," << ypos(roof.peak_flops) << " "
+        << xpos(xmax) << "," << ypos(roof.peak_flops) << "\"/>\n";
+    buffer << "<line x1=\"" << xpos(roof.ridge) << "\" y1=\"" << ypos(roof.peak_flops) << "\" x2=\"" << xpos(roof.ridge) << "\" y2=\"" << height - bottom << "\" stroke=\"#1f77b4\" stroke-dasharray=\"4,4\"/>\n";
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto& point = roof.points[i];
+        if (!std::isfinite(point.intensity) || !(point.intensity > 0) || !(point.attained > 0)) {
+            continue;
+        }
+        const double x = xpos(point.intensity), y = ypos(point.attained);
+        const char* colour = (point.memory_bound ? "#d62728" : "#2ca02c");
+        buffer << "<circle cx=\"" << x << "\" cy=\"" << y << "\" r=\"4\" fill=\"" << colour << "\">"
+            << "<title>" << internal::xml_escape(labels[i]) << ": " << point.efficiency * 100 << "% of attainable</title></circle>\n";
+        buffer << "<text x=\"" << x + 6 << "\" y=\"" << y - 6 << "\">" << internal::xml_escape(labels[i]) << "</text>\n";
+    }
+
+    buffer << "</svg>\n";
+    out << buffer.str();
+}
+
+}
+
+#endif
@@ -0,0 +1,425 @@
+#ifndef EZTIMER_SOAK_HPP
+#define EZTIMER_SOAK_HPP
+
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <algorithm>
+#include <functional>
+
+#include "eztimer.hpp"
+
+/**
+ * @file soak.hpp
+ * @brief Long-running soak tests with drift detection.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Options for `soak()`.
+ */
+struct SoakOptions {
+    /**
+     * Wall-clock duration of the soak test.
+     * Windows are started until this duration is exceeded, so the actual duration may be longer by up to one window.
+     */
+    std::chrono::duration<double> duration = std::chrono::duration<double>(60);
+
+    /**
+     * Number of iterations in each window.
+     * Each window is a separate call to `time()`, and only the summary statistics for each window are retained.
+     */
+    int window_iterations = 100;
+
+    /**
+     * Maximum number of windows to store for each function.
+     * Once exceeded, adjacent windows are merged in pairs, so that memory usage is bounded regardless of `duration`.
+     */
+    std::size_t max_windows = 1000;
+
+    /**
+     * Magnitude of drift to tolerate, as a difference in the mean log-time of each window.
+     * For example, the default of 0.01 ignores changes of roughly 1% in runtime.
+     */
+    double drift_tolerance = 0.01;
+
+    /**
+     * Threshold for the Page-Hinkley statistic, in units of the log-time.
+     * Larger values reduce false alarms but delay the detection of drift.
+     */
+    double drift_threshold = 0.1;
+
+    /**
+     * Further options to pass to `time()`.
+     * `Options::iterations` is ignored and replaced by `window_iterations`.
+     * `Options::burn_in` is only applied to the first window.
+     * `Options::seed` is incremented for each window so that the execution order differs across windows.
+     */
+    Options timing;
+};
+
+/**
+ * @brief Summary statistics for a window of calls to a function.
+ */
+struct SoakWindow {
+    /**
+     * Wall-clock time at the start of the window, relative to the start of `soak()`.
+     */
+    std::chrono::duration<double> start = std::chrono::duration<double>(0);
+
+    /**
+     * Wall-clock time at the end of the window, relative to the start of `soak()`.
+     */
+    std::chrono::duration<double> end = std::chrono::duration<double>(0);
+
+    /**
+     * Number of calls in the window.
+     */
+    std::size_t count = 0;
+
+    /**
+     * Mean time per call.
+     */
+    std::chrono::duration<double> mean = std::chrono::duration<double>(0);
+
+    /**
+     * Standard deviation of the time per call.
+     */
+    std::chrono::duration<double> sd = std::chrono::duration<double>(0);
+
+    /**
+     * Fastest call.
+     */
+    std::chrono::duration<double> min = std::chrono::duration<double>(0);
+
+    /**
+     * Slowest call.
+     */
+    std::chrono::duration<double> max = std::chrono::duration<double>(0);
+};
+
+/**
+ * @brief Shift in the runtime of a function during a soak test.
+ */
+struct Drift {
+    /**
+     * Estimated wall-clock time of the shift, relative to the start of `soak()`.
+     */
+    std::chrono::duration<double> when = std::chrono::duration<double>(0);
+
+    /**
+     * Wall-clock time at which the shift was detected, relative to the start of `soak()`.
+     */
+    std::chrono::duration<double> detected = std::chrono::duration<double>(0);
+
+    /**
+     * Geometric mean time per call before the shift, since the previous shift or the start of `soak()`.
+     */
+    std::chrono::duration<double> before = std::chrono::duration<double>(0);
+
+    /**
+     * Geometric mean time per call after the shift, until the next shift or the end of `soak()`.
+     */
+    std::chrono::duration<double> after = std::chrono::duration<double>(0);
+
+    /**
+     * Relative change in runtime, i.e., `after / before - 1`.
+     * Positive values indicate a slowdown.
+     */
+    double relative = 0;
+};
+
+/**
+ * @brief Results of a soak test for a function.
+ */
+struct SoakTimings {
+    /**
+     * Summary statistics for each window, ordered by time.
+     * Adjacent windows may have been merged, see `SoakOptions::max_windows`.
+     */
+    std::vector<SoakWindow> windows;
+
+    /**
+     * Shifts in runtime that were detected during the soak test, ordered by time.
+     */
+    std::vector<Drift> drifts;
+
+    /**
+     * Total number of calls, excluding burn-in.
+     */
+    std::size_t count = 0;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+// Two-sided Page-Hinkley test, with constant memory. Each observation is
+// associated with a label (e.g., a time), and the label of the last
+// observation before a change is reported with the change.
+class PageHinkley {
+public:
+    PageHinkley(double tolerance, double threshold) : my_tolerance(tolerance), my_threshold(threshold) {}
+
+    struct Change {
+        std::size_t before_count, after_count; // observations since the last reset, before and after the change.
+        double before_total, after_total;
+        double label; // label of the last observation before the change.
+    };
+
+    bool add(double x, double label, Change& change) {
+        ++my_count;
+        my_total += x;
+        const double mean = my_total / my_count;
+
+        my_up += x - mean - my_tolerance;
+        if (my_up <= my_up_min) {
+            my_up_min = my_up;
+            my_up_count = my_count;
+            my_up_total = my_total;
+            my_up_label = label;
+        }
+
+        my_down += x - mean + my_tolerance;
+        if (my_down >= my_down_max) {
+            my_down_max = my_down;
+            my_down_count = my_count;
+            my_down_total = my_total;
+            my_down_label = label;
+        }
+
+        std::size_t at_count;
+        double at_total, at_label;
+        if (my_up - my_up_min > my_threshold) {
+            at_count = my_up_count;
+            at_total = my_up_total;
+            at_label = my_up_label;
+        } else if (my_down_max - my_down > my_threshold) {
+            at_count = my_down_count;
+            at_total = my_down_total;
+            at_label = my_down_label;
+        } else {
+            return false;
+        }
+
+        change.before_count = at_count;
+        change.before_total = at_total;
+        change.after_count = my_count - at_count;
+        change.after_total = my_total - at_total;
+        change.label = at_label;
+        reset();
+        return true;
+    }
+
+    std::size_t count() const {
+        return my_count;
+    }
+
+    double total() const {
+        return my_total;
+    }
+
+private:
+    double my_tolerance, my_threshold;
+    std::size_t my_count = 0;
+    double my_total = 0;
+
+    double my_up = 0, my_up_min = 0, my_up_total = 0, my_up_label = 0;
+    std::size_t my_up_count = 0;
+    double my_down = 0, my_down_max = 0, my_down_total = 0, my_down_label = 0;
+    std::size_t my_down_count = 0;
+
+    void reset() {
+        my_count = 0;
+        my_total = 0;
+        my_up = my_up_min = my_up_total = my_up_label = 0;
+        my_up_count = 0;
+        my_down = my_down_max = my_down_total = my_down_label = 0;
+        my_down_count = 0;
+    }
+};
+
+// Non-positive times (e.g., below the clock resolution) are ignored as their
+// logarithms are not finite.
+inline std::optional<double> mean_log_time(const std::vector<std::chrono::duration<double> >& times) {
+    std::optional<double> output;
+    double total = 0;
+    std::size_t npositive = 0;
+    for (auto t : times) {
+        if (t.count() > 0) {
+            total += std::log(t.count());
+            ++npositive;
+        }
+    }
+    if (npositive) {
+        output = total / npositive;
+    }
+    return output;
+}
+
+inline SoakWindow merge_windows(const SoakWindow& left, const SoakWindow& right) {
+    SoakWindow output;
+    output.start = left.start;
+    output.end = right.end;
+    output.count = left.count + right.count;
+    if (output.count == 0) {
+        return output;
+    }
+    output.min = (left.count ? (right.count ? std::min(left.min, right.min) : left.min) : right.min);
+    output.max = std::max(left.max, right.max);
+
+    const double nl = left.count, nr = right.count;
+    const double ml = left.mean.count(), mr = right.mean.count();
+    const double mean = (nl * ml + nr * mr) / output.count;
+    output.mean = std::chrono::duration<double>(mean);
+    if (output.count > 1) {
+        const double sl = left.sd.count(), sr = right.sd.count();
+        double ss = (nl > 1 ? (nl - 1) * sl * sl : 0) + (nr > 1 ? (nr - 1) * sr * sr : 0);
+        ss += nl * (ml - mean) * (ml - mean) + nr * (mr - mean) * (mr - mean);
+        output.sd = std::chrono::duration<double>(std::sqrt(ss / (output.count - 1)));
+    }
+    return output;
+}
+
+inline void compact_windows(std::vector<SoakWindow>& windows) {
+    std::size_t kept = 0;
+    for (std::size_t w = 0; w < windows.size(); w += 2) {
+        if (w + 1 < windows.size()) {
+            windows[kept] = merge_windows(windows[w], windows[w + 1]);
+        } else {
+            windows[kept] = windows[w];
+        }
+        ++kept;
+    }
+    windows.resize(kept);
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Run the same schedule as `time()` for a wall-clock duration, to detect shifts in runtime that only appear after a long time (e.g., due to fragmentation or leaks).
+ * Calls are grouped into windows of `SoakOptions::window_iterations` iterations, and only the summary statistics for each window are retained.
+ *
+ * The mean log-time of each window is monitored with a two-sided Page-Hinkley test.
+ * When the cumulative deviation from the running mean exceeds `SoakOptions::drift_threshold`, a `Drift` is reported at the window where the deviation started.
+ * The test is then restarted from the next window, so that subsequent shifts are reported relative to the new runtime.
+ *
+ * @param funs Vector of functions to be timed, see `time()` for details.
+ * @param check Function that accepts a `Result_` and an index of `funs`, see `time()` for details.
+ * @param opt Further options.
+ *
+ * @return Vector of length equal to `funs.size()`, containing the soak results for each function.
+ *
+ * @tparam Result_ Result of each function call.
+ */
+template<typename Result_>
+std::vector<SoakTimings> soak(
+    const std::vector<std::function<Result_()> >& funs,
+    const std::function<void(const Result_&, std::size_t)>& check,
+    const SoakOptions& opt
+) {
+    const auto nfun = funs.size();
+    std::vector<SoakTimings> output(nfun);
+    std::vector<internal::PageHinkley> detectors(nfun, internal::PageHinkley(opt.drift_tolerance, opt.drift_threshold));
+
+    // Observations after the last change but before the detector was reset,
+    // which belong to the same segment as the detector's current observations.
+    std::vector<double> carry_total(nfun);
+    std::vector<std::size_t> carry_count(nfun);
+    auto set_relative = [](Drift& drift) -> void {
+        drift.relative = drift.after / drift.before - 1;
+    };
+    const std::size_t max_windows = std::max(opt.max_windows, static_cast<std::size_t>(2));
+
+    auto topt = opt.timing;
+    topt.iterations = std::max(opt.window_iterations, 1);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::size_t window = 0;
+    while (true) {
+        const std::chrono::duration<double> window_start = std::chrono::steady_clock::now() - start;
+        if (window_start >= opt.duration) {
+            break;
+        }
+
+        topt.burn_in = (window == 0 ? opt.timing.burn_in : 0);
+        topt.seed = opt.timing.seed + window;
+        auto timings = time<Result_>(funs, check, topt);
+        const std::chrono::duration<double> window_end = std::chrono::steady_clock::now() - start;
+        ++window;
+
+        for (std::size_t f = 0; f < nfun; ++f) {
+            const auto& times = timings[f].times;
+            auto& curout = output[f];
+            if (times.empty()) {
+                continue;
+            }
+
+            SoakWindow summary;
+            summary.start = window_start;
+            summary.end = window_end;
+            summary.count = times.size();
+            summary.mean = timings[f].mean;
+            summary.sd = timings[f].sd;
+            summary.min = *std::min_element(times.begin(), times.end());
+            summary.max = *std::max_element(times.begin(), times.end());
+            curout.count += summary.count;
+            curout.windows.push_back(summary);
+            if (curout.windows.size() > max_windows) {
+                internal::compact_windows(curout.windows);
+            }
+
+            const auto logmean = internal::mean_log_time(times);
+            if (!logmean.has_value()) {
+                continue;
+            }
+
+            // Labelling each window with its end, so that the location of a
+            // change can be reported as a time without storing every window.
+            internal::PageHinkley::Change change;
+            if (detectors[f].add(*logmean, window_end.count(), change)) {
+                Drift drift;
+                drift.when = std::chrono::duration<double>(change.label);
+                drift.detected = window_end;
+                const double before = (carry_total[f] + change.before_total) / (carry_count[f] + change.before_count);
+                drift.before = std::chrono::duration<double>(std::exp(before));
+                if (!curout.drifts.empty()) {
+                    auto& last = curout.drifts.back();
+                    last.after = drift.before;
+                    set_relative(last);
+                }
+
+                // Provisional estimate, updated at the next shift or at the end.
+                drift.after = std::chrono::duration<double>(std::exp(change.after_total / change.after_count));
+                set_relative(drift);
+                curout.drifts.push_back(drift);
+
+                carry_total[f] = change.after_total;
+                carry_count[f] = change.after_count;
+            }
+        }
+    }
+
+    for (std::size_t f = 0; f < nfun; ++f) {
+        auto& drifts = output[f].drifts;
+        if (!drifts.empty()) {
+            auto& last = drifts.back();
+            const auto& detector = detectors[f];
+            last.after = std::chrono::duration<double>(std::exp((carry_total[f] + detector.total()) / (carry_count[f] + detector.count())));
+            set_relative(last);
+        }
+    }
+
+    return output;
+}
+
+}
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef EZTIMER_STATS_HPP
+#define EZTIMER_STATS_HPP
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+
+/**
+ * @file stats.hpp
+ * @brief Statistical utilities.
+ */
+
+namespace eztimer {
+
+/**
+ * @cond
+ */
+namespace internal {
+
+// Acklam's rational approximation to the inverse of the standard normal CDF.
+inline double normal_quantile(double p) {
+    if (p <= 0) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    if (p >= 1) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    constexpr double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+    constexpr double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01 };
+    constexpr double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+    constexpr double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00 };
+    constexpr double plow = 0.02425;
+
+    if (p < plow) {
+        const double q = std::sqrt(-2 * std::log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+    if (p > 1 - plow) {
+        const double q = std::sqrt(-2 * std::log(1 - p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+    const double q = p - 0.5;
+    const double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+}
+
+inline double normal_cdf(double x) {
+    return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+// Exact for 1 and 2 degrees of freedom, otherwise we use the Cornish-Fisher
+// expansion around the normal quantile, which is accurate enough for CIs.
+inline double t_quantile(double p, double df) {
+    if (df == 1) {
+        return std::tan(3.14159265358979323846 * (p - 0.5));
+    }
+    if (df == 2) {
+        return (2 * p - 1) / std::sqrt(2 * p * (1 - p));
+    }
+
+    const double z = normal_quantile(p);
+    const double z2 = z * z, z3 = z2 * z, z5 = z3 * z2, z7 = z5 * z2, z9 = z7 * z2;
+    return z
+        + (z3 + z) / (4 * df)
+        + (5 * z5 + 16 * z3 + 3 * z) / (96 * df * df)
+        + (3 * z7 + 19 * z5 + 17 * z3 - 15 * z) / (384 * df * df * df)
+        + (79 * z9 + 776 * z7 + 1482 * z5 - 1920 * z3 - 945 * z) / (92160 * df * df * df * df);
+}
+
+// Type 7 quantile (i.e., R's default) of a sorted vector.
+template<typename Value_>
+double sorted_quantile(const std::vector<Value_>& sorted, double p) {
+    if (sorted.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double pos = p * (sorted.size() - 1);
+    const auto lower = static_cast<std::size_t>(std::floor(pos));
+    const auto upper = std::min(lower + 1, sorted.size() - 1);
+    const double frac = pos - lower;
+    return static_cast<double>(sorted[lower]) * (1 - frac) + static_cast<double>(sorted[upper]) * frac;
+}
+
+template<typename Value_>
+double mean(const std::vector<Value_>& x) {
+    double total = 0;
+    for (auto y : x) {
+        total += y;
+    }
+    return total / x.size();
+}
+
+template<typename Value_>
+double variance(const std::vector<Value_>& x, double mu) {
+    double total = 0;
+    for (auto y : x) {
+        const double delta = y - mu;
+        total += delta * delta;
+    }
+    return total / (x.size() - 1);
+}
+
+}
+/**
+ * @endcond
+ */
+
+}
+
+#endif
@@ -0,0 +1,659 @@
+#ifndef EZTIMER_STORE_HPP
+#define EZTIMER_STORE_HPP
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+
+#include "eztimer.hpp"
+#include "stats.hpp"
+#include "probe.hpp"
+
+/**
+ * @file store.hpp
+ * @brief Store timings across runs and analyze their history.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Entry in the index of a `ResultsStore`, describing the timings for one benchmark in one run.
+ */
+struct RunRecord {
+    /**
+     * Name of the benchmark.
+     */
+    std::string benchmark;
+
+    /**
+     * Identifier for the version of the code, e.g., a commit hash.
+     */
+    std::string commit;
+
+    /**
+     * Identifier for the machine, e.g., from `fingerprint_id()`.
+     */
+    std::string fingerprint;
+
+    /**
+     * Time at which the run was stored, in seconds since the Unix epoch.
+     */
+    long long timestamp = 0;
+
+    /**
+     * Number of timings.
+     */
+    std::size_t count = 0;
+
+    /**
+     * Mean of the timings, see `Timings::mean`.
+     */
+    std::chrono::duration<double> mean = std::chrono::duration<double>(0);
+
+    /**
+     * Standard deviation of the timings, see `Timings::sd`.
+     */
+    std::chrono::duration<double> sd = std::chrono::duration<double>(0);
+
+    /**
+     * Offset of the timings in the data file.
+     */
+    std::uint64_t offset = 0;
+};
+
+/**
+ * @brief Filter for `ResultsStore::query()`.
+ *
+ * Empty strings match all values.
+ */
+struct StoreQuery {
+    /**
+     * Name of the benchmark.
+     */
+    std::string benchmark;
+
+    /**
+     * Identifier for the version of the code.
+     */
+    std::string commit;
+
+    /**
+     * Identifier for the machine.
+     */
+    std::string fingerprint;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+constexpr char store_index_magic[8] = { 'E', 'Z', 'T', 'I', 'D', 'X', '0', '1' };
+constexpr char store_data_magic[8] = { 'E', 'Z', 'T', 'D', 'A', 'T', '0', '1' };
+
+template<typename Type_>
+void write_binary(std::ostream& out, const Type_& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(Type_));
+}
+
+inline void write_binary(std::ostream& out, const std::string& value) {
+    write_binary(out, static_cast<std::uint32_t>(value.size()));
+    out.write(value.data(), value.size());
+}
+
+template<typename Type_>
+bool read_binary(std::istream& in, Type_& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(Type_)));
+}
+
+inline bool read_binary(std::istream& in, std::string& value) {
+    std::uint32_t len;
+    if (!read_binary(in, len)) {
+        return false;
+    }
+    value.resize(len);
+    return static_cast<bool>(in.read(value.data(), len));
+}
+
+inline void check_magic(const std::filesystem::path& path, const char* magic) {
+    std::ifstream handle(path, std::ios::binary);
+    char buffer[8];
+    if (!handle.read(buffer, 8) || std::memcmp(buffer, magic, 8) != 0) {
+        throw std::runtime_error("'" + path.string() + "' is not a valid file for a results store");
+    }
+}
+
+inline void initialize_file(const std::filesystem::path& path, const char* magic) {
+    if (std::filesystem::exists(path)) {
+        check_magic(path, magic);
+        return;
+    }
+    std::ofstream handle(path, std::ios::binary);
+    handle.write(magic, 8);
+    if (!handle) {
+        throw std::runtime_error("failed to create '" + path.string() + "'");
+    }
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * @brief Append-only store of timings across runs.
+ *
+ * The store is a directory containing two binary files and a `profiles/` subdirectory:
+ *
+ * - `index.bin`, which contains a `RunRecord` for each stored run.
+ *   This is small enough to be fully loaded when the store is opened.
+ * - `data.bin`, which contains the individual timings for each run.
+ *   These are only read on request by `load()`.
+ * - `profiles/`, which contains the `MachineProfile` for each machine, if supplied with `save_profile()`.
+ *   Each profile is named after its `fingerprint_id()`, linking it to the `RunRecord::fingerprint` of each run.
+ *
+ * The binary files use a compact format in the native byte order, so stores should not be shared between machines with different endianness.
+ * Profiles are stored as tab-separated text, one file per machine.
+ * New runs are appended to the end of each binary file; existing runs are never modified.
+ * The data is written before the index, so an interrupted append does not leave a record that refers to missing data.
+ * An incomplete record at the end of the index is discarded when the store is opened, while a record that refers to invalid data causes an error.
+ * Concurrent appends from multiple processes are not supported.
+ */
+class ResultsStore {
+public:
+    /**
+     * @param directory Path to the directory containing the store.
+     * This is created if it does not already exist.
+     */
+    ResultsStore(std::filesystem::path directory) : my_directory(std::move(directory)) {
+        std::filesystem::create_directories(my_directory);
+        internal::initialize_file(index_path(), internal::store_index_magic);
+        internal::initialize_file(data_path(), internal::store_data_magic);
+
+        // Each record is validated against the file sizes, so that garbage
+        // lengths or offsets are not trusted.
+        const std::uint64_t index_size = std::filesystem::file_size(index_path());
+        const std::uint64_t data_size = std::filesystem::file_size(data_path());
+        std::uint64_t good_end = 8;
+
+        {
+            std::ifstream handle(index_path(), std::ios::binary);
+            handle.seekg(8);
+            auto read_string = [&](std::string& value) -> bool {
+                std::uint32_t len;
+                if (!internal::read_binary(handle, len)) {
+                    return false;
+                }
+                if (len > index_size - static_cast<std::uint64_t>(handle.tellg())) {
+                    return false;
+                }
+                value.resize(len);
+                return static_cast<bool>(handle.read(value.data(), len));
+            };
+
+            while (good_end < index_size) {
+                RunRecord record;
+                std::uint64_t count;
+                double mean, sd;
+                if (
+                    !read_string(record.benchmark) ||
+                    !read_string(record.commit) ||
+                    !read_string(record.fingerprint) ||
+                    !internal::read_binary(handle, record.timestamp) ||
+                    !internal::read_binary(handle, count) ||
+                    !internal::read_binary(handle, mean) ||
+                    !internal::read_binary(handle, sd) ||
+                    !internal::read_binary(handle, record.offset)
+                ) {
+                    break;
+                }
+                if (record.offset < 8 || record.offset > data_size || count > (data_size - record.offset) / sizeof(double)) {
+                    throw std::runtime_error("index record " + std::to_string(my_runs.size()) + " in '" + index_path().string() + "' refers to invalid data");
+                }
+                record.count = count;
+                record.mean = std::chrono::duration<double>(mean);
+                record.sd = std::chrono::duration<double>(sd);
+                my_runs.push_back(std::move(record));
+                good_end = handle.tellg();
+            }
+        }
+
+        // Discarding an incomplete record at the end of the index, e.g., from
+        // an interrupted append, so that later appends start at a record boundary.
+        if (good_end < index_size) {
+            std::filesystem::resize_file(index_path(), good_end);
+        }
+    }
+
+public:
+    /**
+     * Append the timings for a benchmark to the store.
+     *
+     * @param benchmark Name of the benchmark.
+     * @param commit Identifier for the version of the code, e.g., a commit hash.
+     * @param fingerprint Identifier for the machine, e.g., from `fingerprint_id()`.
+     * @param timings Timings for the benchmark, typically from `time()`.
+     * Only `Timings::times` and `Timings::iterations` are stored.
+     * @param timestamp Time of the run, in seconds since the Unix epoch.
+     * If negative, the current time is used.
+     *
+     * @return Record for the stored run, which is also added to `runs()`.
+     */
+    RunRecord append(const std::string& benchmark, const std::string& commit, const std::string& fingerprint, const Timings& timings, long long timestamp = -1) {
+        if (timestamp < 0) {
+            timestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        RunRecord record;
+        record.benchmark = benchmark;
+        record.commit = commit;
+        record.fingerprint = fingerprint;
+        record.timestamp = timestamp;
+        record.count = timings.times.size();
+        record.mean = timings.mean;
+        record.sd = timings.sd;
+
+        {
+            std::ofstream handle(data_path(), std::ios::binary | std::ios::app);
+            handle.seekp(0, std::ios::end);
+            record.offset = handle.tellp();
+            internal::write_binary(handle, static_cast<std::uint64_t>(timings.times.size()));
+            internal::write_binary(handle, static_cast<std::uint64_t>(timings.iterations.size()));
+            for (auto t : timings.times) {
+                internal::write_binary(handle, t.count());
+            }
+            for (auto i : timings.iterations) {
+                internal::write_binary(handle, static_cast<std::int32_t>(i));
+            }
+            if (!handle.flush()) {
+                throw std::runtime_error("failed to write to '" + data_path().string() + "'");
+            }
+        }
+
+        {
+            std::ofstream handle(index_path(), std::ios::binary | std::ios::app);
+            internal::write_binary(handle, record.benchmark);
+            internal::write_binary(handle, record.commit);
+            internal::write_binary(handle, record.fingerprint);
+            internal::write_binary(handle, record.timestamp);
+            internal::write_binary(handle, static_cast<std::uint64_t>(record.count));
+            internal::write_binary(handle, record.mean.count());
+            internal::write_binary(handle, record.sd.count());
+            internal::write_binary(handle, record.offset);
+            if (!handle.flush()) {
+                throw std::runtime_error("failed to write to '" + index_path().string() + "'");
+            }
+        }
+
+        my_runs.push_back(record);
+        return record;
+    }
+
+    /**
+     * Append the timings for multiple benchmarks from the same run to the store.
+     *
+     * @param benchmarks Names of the benchmarks.
+     * @param commit Identifier for the version of the code.
+     * @param fingerprint Identifier for the machine.
+     * @param timings Timings for each benchmark, typically from `time()`.
+     * This should have the same length as `benchmarks`.
+     * @param timestamp Time of the run, in seconds since the Unix epoch.
+     * If negative, the current time is used.
+     */
+    void append(const std::vector<std::string>& benchmarks, const std::string& commit, const std::string& fingerprint, const std::vector<Timings>& timings, long long timestamp = -1) {
+        if (benchmarks.size() != timings.size()) {
+            throw std::runtime_error("'benchmarks' and 'timings' should have the same length");
+        }
+        if (timestamp < 0) {
+            timestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+        for (std::size_t b = 0; b < benchmarks.size(); ++b) {
+            append(benchmarks[b], commit, fingerprint, timings[b], timestamp);
+        }
+    }
+
+public:
+    /**
+     * @return Records for all stored runs, in the order in which they were appended.
+     */
+    const std::vector<RunRecord>& runs() const {
+        return my_runs;
+    }
+
+    /**
+     * @param filter Filter on the runs.
+     * @return Records for all runs that match `filter`, in the order in which they were appended.
+     */
+    std::vector<RunRecord> query(const StoreQuery& filter) const {
+        std::vector<RunRecord> output;
+        for (const auto& run : my_runs) {
+            if (
+                (filter.benchmark.empty() || filter.benchmark == run.benchmark) &&
+                (filter.commit.empty() || filter.commit == run.commit) &&
+                (filter.fingerprint.empty() || filter.fingerprint == run.fingerprint)
+            ) {
+                output.push_back(run);
+            }
+        }
+        return output;
+    }
+
+    /**
+     * @return Names of all stored benchmarks, sorted alphabetically.
+     */
+    std::vector<std::string> benchmarks() const {
+        std::vector<std::string> output;
+        for (const auto& run : my_runs) {
+            output.push_back(run.benchmark);
+        }
+        std::sort(output.begin(), output.end());
+        output.erase(std::unique(output.begin(), output.end()), output.end());
+        return output;
+    }
+
+    /**
+     * @param record Record for a stored run, typically from `runs()` or `query()`.
+     * @return Timings for the run, with `Timings::times` and `Timings::iterations` filled from the store and the statistics recomputed.
+     */
+    Timings load(const RunRecord& record) const {
+        const std::uint64_t data_size = std::filesystem::file_size(data_path());
+        std::ifstream handle(data_path(), std::ios::binary);
+        handle.seekg(record.offset);
+
+        std::uint64_t ntimes, niterations;
+        if (record.offset < 8 || record.offset > data_size || !internal::read_binary(handle, ntimes) || !internal::read_binary(handle, niterations)) {
+            throw std::runtime_error("failed to read timings from '" + data_path().string() + "'");
+        }
+
+        // Checking the lengths against the record and the file size before
+        // allocating, so that corrupt data does not request arbitrary memory.
+        const std::uint64_t available = data_size - record.offset - 2 * sizeof(std::uint64_t);
+        if (
+            ntimes != record.count ||
+            (niterations != 0 && niterations != ntimes) ||
+            ntimes > available / sizeof(double) ||
+            niterations > (available - ntimes * sizeof(double)) / sizeof(std::int32_t)
+        ) {
+            throw std::runtime_error("timings at offset " + std::to_string(record.offset) + " in '" + data_path().string() + "' are inconsistent with the index");
+        }
+
+        Timings output;
+        output.times.reserve(ntimes);
+        for (std::uint64_t i = 0; i < ntimes; ++i) {
+            double val;
+            if (!internal::read_binary(handle, val)) {
+                throw std::runtime_error("failed to read timings from '" + data_path().string() + "'");
+            }
+            output.times.emplace_back(val);
+        }
+        output.iterations.reserve(niterations);
+        for (std::uint64_t i = 0; i < niterations; ++i) {
+            std::int32_t val;
+            if (!internal::read_binary(handle, val)) {
+                throw std::runtime_error("failed to read timings from '" + data_path().string() + "'");
+            }
+            output.iterations.push_back(val);
+        }
+
+        compute_statistics(output);
+        return output;
+    }
+
+    /**
+     * Save the profile of a machine in the store, replacing any existing profile with the same fingerprint.
+     * This is typically called alongside `append()` so that the timings can be interpreted in the context of the machine.
+     *
+     * @param profile Machine profile, typically from `probe_machine()` or `cached_probe()`.
+     */
+    void save_profile(const MachineProfile& profile) const {
+        const auto path = profile_path(fingerprint_id(profile.fingerprint));
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream handle(path);
+        write_machine_profile(handle, profile);
+        if (!handle.flush()) {
+            throw std::runtime_error("failed to write to '" + path.string() + "'");
+        }
+    }
+
+    /**
+     * @param fingerprint Identifier for the machine, see `RunRecord::fingerprint`.
+     * @return Profile of the machine, if it was saved with `save_profile()`.
+     */
+    std::optional<MachineProfile> profile(const std::string& fingerprint) const {
+        std::optional<MachineProfile> output;
+        std::ifstream handle(profile_path(fingerprint));
+        if (handle) {
+            output = read_machine_profile(handle);
+        }
+        return output;
+    }
+
+    /**
+     * @return Path to the directory containing the store.
+     */
+    const std::filesystem::path& directory() const {
+        return my_directory;
+    }
+
+private:
+    std::filesystem::path my_directory;
+    std::vector<RunRecord> my_runs;
+
+    std::filesystem::path index_path() const {
+        return my_directory / "index.bin";
+    }
+
+    std::filesystem::path data_path() const {
+        return my_directory / "data.bin";
+    }
+
+    std::filesystem::path profile_path(const std::string& fingerprint) const {
+        return my_directory / "profiles" / (fingerprint + ".tsv");
+    }
+};
+
+/**
+ * @brief Options for `analyze_history()`.
+ */
+struct HistoryOptions {
+    /**
+     * Penalty for each change point, in units of the chi-squared statistic for a shift in the mean log-time.
+     * If not positive, this defaults to `3 * log(n)` for `n` runs.
+     */
+    double penalty = 0;
+
+    /**
+     * Minimum relative change in runtime to report, e.g., 0.01 to ignore changes of less than 1%.
+     */
+    double min_relative = 0.01;
+
+    /**
+     * Minimum number of runs in each segment between change points.
+     */
+    std::size_t min_segment = 2;
+};
+
+/**
+ * @brief Shift in runtime between runs of a benchmark.
+ */
+struct HistoryChange {
+    /**
+     * Index of the first run after the shift, in `History::runs`.
+     */
+    std::size_t run = 0;
+
+    /**
+     * Geometric mean of the run means in the segment before the shift.
+     */
+    std::chrono::duration<double> before = std::chrono::duration<double>(0);
+
+    /**
+     * Geometric mean of the run means in the segment after the shift.
+     */
+    std::chrono::duration<double> after = std::chrono::duration<double>(0);
+
+    /**
+     * Relative change in runtime, i.e., `after / before - 1`.
+     * Positive values indicate a slowdown.
+     */
+    double relative = 0;
+};
+
+/**
+ * @brief History of a benchmark across stored runs.
+ */
+struct History {
+    /**
+     * Records for each run of the benchmark, in the order in which they were appended.
+     */
+    std::vector<RunRecord> runs;
+
+    /**
+     * Shifts in runtime across `runs`, ordered by `HistoryChange::run`.
+     */
+    std::vector<HistoryChange> changes;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+inline void segment_history(
+    const std::vector<double>& values,
+    std::size_t start,
+    std::size_t end,
+    double variance,
+    double penalty,
+    std::size_t min_segment,
+    std::vector<std::size_t>& splits)
+{
+    if (end - start < 2 * min_segment) {
+        return;
+    }
+
+    double total = 0;
+    for (std::size_t i = start; i < end; ++i) {
+        total += values[i];
+    }
+
+    double best = 0, left = 0;
+    std::size_t best_split = 0;
+    for (std::size_t i = start; i + min_segment <= end; ++i) {
+        const std::size_t nleft = i - start, nright = end - i;
+        if (nleft >= min_segment) {
+            const double delta = left / nleft - (total - left) / nright;
+            const double stat = static_cast<double>(nleft) * nright / (end - start) * delta * delta / variance;
+            if (stat > best) {
+                best = stat;
+                best_split = i;
+            }
+        }
+        left += values[i];
+    }
+
+    if (best <= penalty) {
+        return;
+    }
+    segment_history(values, start, best_split, variance, penalty, min_segment, splits);
+    splits.push_back(best_split);
+    segment_history(values, best_split, end, variance, penalty, min_segment, splits);
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Retrieve the history of a benchmark from the store, and detect the runs at which its runtime shifted.
+ * Change points are detected by binary segmentation of the log-transformed run means.
+ * The noise variance is estimated from the median absolute deviation of the differences between consecutive runs, which is robust to the shifts themselves.
+ * A split is accepted if its chi-squared statistic exceeds `HistoryOptions::penalty`, after which each side is recursively segmented.
+ *
+ * @param store Store of timings.
+ * @param filter Filter on the runs.
+ * `StoreQuery::benchmark` should be non-empty.
+ * `StoreQuery::fingerprint` should usually be set to avoid comparing runs from different machines.
+ * @param opt Further options.
+ *
+ * @return History of the benchmark.
+ */
+inline History analyze_history(const ResultsStore& store, const StoreQuery& filter, const HistoryOptions& opt = HistoryOptions()) {
+    if (filter.benchmark.empty()) {
+        throw std::runtime_error("benchmark name should be specified in the query");
+    }
+
+    History output;
+    output.runs = store.query(filter);
+    const auto n = output.runs.size();
+
+    // Flooring the means at the clock resolution, as zero or negative means
+    // (e.g., from calls below the resolution) do not have finite logarithms.
+    const double resolution = std::chrono::duration<double>(std::chrono::steady_clock::duration(1)).count();
+    std::vector<double> logged;
+    logged.reserve(n);
+    for (const auto& run : output.runs) {
+        logged.push_back(std::log(std::max(run.mean.count(), resolution)));
+    }
+
+    const std::size_t min_segment = std::max(opt.min_segment, static_cast<std::size_t>(1));
+    if (n < 2 * min_segment) {
+        return output;
+    }
+
+    std::vector<double> diffs;
+    diffs.reserve(n - 1);
+    for (std::size_t i = 1; i < n; ++i) {
+        diffs.push_back(std::abs(logged[i] - logged[i - 1]));
+    }
+    std::sort(diffs.begin(), diffs.end());
+    const double mad = internal::sorted_quantile(diffs, 0.5);
+
+    // Each difference has twice the variance of a single run. The floor
+    // avoids division by zero when most runs are identical.
+    double sd = mad / (0.6744897501960817 * std::sqrt(2.0));
+    sd = std::max(sd, 1e-6);
+
+    const double penalty = (opt.penalty > 0 ? opt.penalty : 3 * std::log(static_cast<double>(n)));
+    std::vector<std::size_t> splits;
+    internal::segment_history(logged, 0, n, sd * sd, penalty, min_segment, splits);
+
+    std::vector<std::size_t> bounds { 0 };
+    bounds.insert(bounds.end(), splits.begin(), splits.end());
+    bounds.push_back(n);
+    std::vector<double> segment_means;
+    for (std::size_t s = 1; s < bounds.size(); ++s) {
+        double total = 0;
+        for (std::size_t i = bounds[s - 1]; i < bounds[s]; ++i) {
+            total += logged[i];
+        }
+        segment_means.push_back(total / (bounds[s] - bounds[s - 1]));
+    }
+
+    for (std::size_t s = 0; s < splits.size(); ++s) {
+        HistoryChange change;
+        change.run = splits[s];
+        change.before = std::chrono::duration<double>(std::exp(segment_means[s]));
+        change.after = std::chrono::duration<double>(std::exp(segment_means[s + 1]));
+        change.relative = change.after / change.before - 1;
+        if (std::abs(change.relative) >= opt.min_relative) {
+            output.changes.push_back(change);
+        }
+    }
+
+    return output;
+}
+
+}
+
+#endif
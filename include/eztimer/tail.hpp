@@ -0,0 +1,373 @@
+#ifndef EZTIMER_TAIL_HPP
+#define EZTIMER_TAIL_HPP
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <algorithm>
+#include <fstream>
+#include <cmath>
+#include <atomic>
+
+#include "tail_options.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/time.h>
+#include <sys/resource.h>
+#define EZTIMER_HAS_RUSAGE
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#if (defined(__linux__) && defined(__GLIBC__) || defined(__APPLE__)) && (defined(__x86_64__) || defined(__aarch64__))
+#include <csignal>
+#include <signal.h>
+#include <execinfo.h>
+#include <cstdlib>
+#ifdef __linux__
+#include <ucontext.h>
+#endif
+#define EZTIMER_HAS_STACK_SAMPLING
+#endif
+
+/**
+ * @file tail.hpp
+ * @brief Capture diagnostics for slow calls.
+ *
+ * The public types are defined in `tail_options.hpp`.
+ * Platform-specific diagnostics are only collected where they are supported.
+ */
+
+namespace eztimer {
+
+/**
+ * @cond
+ */
+namespace internal {
+
+// P-squared algorithm of Jain and Chlamtac (1985) for a running quantile in
+// constant memory.
+class RunningQuantile {
+public:
+    RunningQuantile(double p) : my_p(p) {
+        my_increments[0] = 0;
+        my_increments[1] = p / 2;
+        my_increments[2] = p;
+        my_increments[3] = (1 + p) / 2;
+        my_increments[4] = 1;
+    }
+
+    void add(double x) {
+        if (my_count < 5) {
+            my_heights[my_count] = x;
+            ++my_count;
+            if (my_count == 5) {
+                std::sort(my_heights, my_heights + 5);
+                for (int i = 0; i < 5; ++i) {
+                    my_positions[i] = i + 1;
+                    my_desired[i] = 1 + 4 * my_increments[i];
+                }
+            }
+            return;
+        }
+        ++my_count;
+
+        int k;
+        if (x < my_heights[0]) {
+            my_heights[0] = x;
+            k = 0;
+        } else if (x >= my_heights[4]) {
+            my_heights[4] = x;
+            k = 3;
+        } else {
+            k = 0;
+            while (k < 3 && x >= my_heights[k + 1]) {
+                ++k;
+            }
+        }
+
+        for (int i = k + 1; i < 5; ++i) {
+            ++my_positions[i];
+        }
+        for (int i = 0; i < 5; ++i) {
+            my_desired[i] += my_increments[i];
+        }
+
+        for (int i = 1; i < 4; ++i) {
+            const double d = my_desired[i] - my_positions[i];
+            if ((d >= 1 && my_positions[i + 1] - my_positions[i] > 1) || (d <= -1 && my_positions[i - 1] - my_positions[i] < -1)) {
+                const int ds = (d > 0 ? 1 : -1);
+                const double candidate = parabolic(i, ds);
+                if (my_heights[i - 1] < candidate && candidate < my_heights[i + 1]) {
+                    my_heights[i] = candidate;
+                } else {
+                    my_heights[i] += ds * (my_heights[i + ds] - my_heights[i]) / (my_positions[i + ds] - my_positions[i]);
+                }
+                my_positions[i] += ds;
+            }
+        }
+    }
+
+    std::size_t count() const {
+        return my_count;
+    }
+
+    double estimate() const {
+        if (my_count >= 5) {
+            return my_heights[2];
+        }
+        if (my_count == 0) {
+            return 0;
+        }
+        double sorted[5];
+        std::copy(my_heights, my_heights + my_count, sorted);
+        std::sort(sorted, sorted + my_count);
+        return sorted[static_cast<std::size_t>(std::round(my_p * (my_count - 1)))];
+    }
+
+private:
+    double my_p;
+    std::size_t my_count = 0;
+    double my_heights[5];
+    double my_positions[5];
+    double my_desired[5];
+    double my_increments[5];
+
+    double parabolic(int i, int d) const {
+        const double np = my_positions[i + 1], n = my_positions[i], nm = my_positions[i - 1];
+        return my_heights[i] + d / (np - nm) * (
+            (n - nm + d) * (my_heights[i + 1] - my_heights[i]) / (np - n) +
+            (np - n - d) * (my_heights[i] - my_heights[i - 1]) / (n - nm)
+        );
+    }
+};
+
+#ifdef EZTIMER_HAS_STACK_SAMPLING
+inline std::uintptr_t interrupted_pc(const void* context) {
+    const auto uc = static_cast<const ucontext_t*>(context);
+#if defined(__linux__) && defined(__x86_64__)
+    return static_cast<std::uintptr_t>(uc->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__linux__)
+    return static_cast<std::uintptr_t>(uc->uc_mcontext.pc);
+#elif defined(__x86_64__)
+    return static_cast<std::uintptr_t>(uc->uc_mcontext->__ss.__rip);
+#else
+    return static_cast<std::uintptr_t>(uc->uc_mcontext->__ss.__pc);
+#endif
+}
+
+// The handler only reads the program counter from the signal context and
+// stores it in a lock-free atomic, both of which are async-signal-safe.
+// Symbolization is deferred until after the call has finished.
+struct StackSampler {
+    inline static volatile std::sig_atomic_t armed = 0;
+    inline static std::atomic<std::uintptr_t> pc{0};
+
+    static void handler(int, siginfo_t*, void* context) {
+        if (armed) {
+            pc.store(interrupted_pc(context), std::memory_order_relaxed);
+            armed = 0;
+        }
+    }
+
+    StackSampler() {
+        struct sigaction action;
+        action.sa_sigaction = handler;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART | SA_SIGINFO;
+        sigaction(SIGALRM, &action, &my_previous);
+    }
+
+    ~StackSampler() {
+        disarm();
+        sigaction(SIGALRM, &my_previous, NULL);
+    }
+
+    StackSampler(const StackSampler&) = delete;
+    StackSampler& operator=(const StackSampler&) = delete;
+
+    void arm(double seconds) {
+        pc.store(0, std::memory_order_relaxed);
+        armed = 1;
+        itimerval timer{};
+        const auto usec = std::max(1.0, std::ceil(seconds * 1e6));
+        timer.it_value.tv_sec = static_cast<long>(usec / 1e6);
+        timer.it_value.tv_usec = static_cast<long>(usec - timer.it_value.tv_sec * 1e6);
+        setitimer(ITIMER_REAL, &timer, NULL);
+    }
+
+    void disarm() {
+        armed = 0;
+        itimerval timer{};
+        setitimer(ITIMER_REAL, &timer, NULL);
+    }
+
+    std::vector<std::string> collect() const {
+        std::vector<std::string> output;
+        void* frame = reinterpret_cast<void*>(pc.load(std::memory_order_relaxed));
+        if (frame == NULL) {
+            return output;
+        }
+        char** symbols = backtrace_symbols(&frame, 1);
+        if (symbols == NULL) {
+            return output;
+        }
+        output.emplace_back(symbols[0]);
+        std::free(symbols);
+        return output;
+    }
+
+private:
+    struct sigaction my_previous;
+};
+#endif
+
+inline int current_cpu() {
+#ifdef __linux__
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+inline std::optional<double> cpu_frequency(int cpu) {
+    std::optional<double> output;
+#ifdef __linux__
+    if (cpu >= 0) {
+        std::ifstream handle("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq");
+        double khz;
+        if (handle >> khz) {
+            output = khz / 1000;
+        }
+    }
+#else
+    (void)cpu;
+#endif
+    return output;
+}
+
+class TailCapture {
+public:
+    TailCapture(const TailCaptureOptions& options, std::size_t nfun) : my_options(options), my_quantiles(nfun, RunningQuantile(options.quantile)) {
+#ifdef EZTIMER_HAS_STACK_SAMPLING
+        if (options.sample_stack) {
+            my_sampler.emplace();
+        }
+#endif
+    }
+
+    void before(std::size_t fun) {
+        const auto& quant = my_quantiles[fun];
+        my_active = quant.count() >= static_cast<std::size_t>(std::max(my_options.min_calls, 1));
+        if (!my_active) {
+            return;
+        }
+        my_threshold = quant.estimate();
+
+#ifdef EZTIMER_HAS_RUSAGE
+#ifdef __linux__
+        getrusage(RUSAGE_THREAD, &my_usage);
+#else
+        getrusage(RUSAGE_SELF, &my_usage);
+#endif
+#endif
+
+#ifdef EZTIMER_HAS_STACK_SAMPLING
+        if (my_sampler) {
+            my_sampler->arm(my_threshold);
+        }
+#endif
+    }
+
+    void after(
+        std::size_t fun,
+        std::chrono::duration<double> time,
+        std::size_t index,
+        int iteration,
+        const std::vector<long long>& counts,
+        std::vector<Outlier>& outliers
+    ) {
+        my_quantiles[fun].add(time.count());
+        if (!my_active) {
+            return;
+        }
+
+#ifdef EZTIMER_HAS_STACK_SAMPLING
+        if (my_sampler) {
+            my_sampler->disarm();
+        }
+#endif
+
+        if (time.count() <= my_threshold) {
+            return;
+        }
+
+        // Deciding whether to record this outlier, and where.
+        std::size_t target = outliers.size();
+        if (outliers.size() >= my_options.max_outliers) {
+            if (outliers.empty()) {
+                return;
+            }
+            auto fastest = std::min_element(outliers.begin(), outliers.end(), [](const Outlier& l, const Outlier& r) -> bool { return l.time < r.time; });
+            if (fastest->time >= time) {
+                return;
+            }
+            target = fastest - outliers.begin();
+        } else {
+            outliers.emplace_back();
+        }
+
+        auto& current = outliers[target];
+        current.index = index;
+        current.iteration = iteration;
+        current.time = time;
+        current.threshold = std::chrono::duration<double>(my_threshold);
+        current.counters = counts;
+
+#ifdef EZTIMER_HAS_RUSAGE
+        rusage usage;
+#ifdef __linux__
+        getrusage(RUSAGE_THREAD, &usage);
+#else
+        getrusage(RUSAGE_SELF, &usage);
+#endif
+        current.voluntary_switches = usage.ru_nvcsw - my_usage.ru_nvcsw;
+        current.involuntary_switches = usage.ru_nivcsw - my_usage.ru_nivcsw;
+#endif
+        current.cpu = current_cpu();
+        current.frequency = cpu_frequency(current.cpu);
+
+        current.stack.clear();
+#ifdef EZTIMER_HAS_STACK_SAMPLING
+        if (my_sampler) {
+            current.stack = my_sampler->collect();
+        }
+#endif
+    }
+
+private:
+    TailCaptureOptions my_options;
+    std::vector<RunningQuantile> my_quantiles;
+    bool my_active = false;
+    double my_threshold = 0;
+#ifdef EZTIMER_HAS_RUSAGE
+    rusage my_usage;
+#endif
+#ifdef EZTIMER_HAS_STACK_SAMPLING
+    std::optional<StackSampler> my_sampler;
+#endif
+};
+
+}
+/**
+ * @endcond
+ */
+
+}
+
+#endif
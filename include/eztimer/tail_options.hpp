@@ -0,0 +1,114 @@
+#ifndef EZTIMER_TAIL_OPTIONS_HPP
+#define EZTIMER_TAIL_OPTIONS_HPP
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
+/**
+ * @file tail_options.hpp
+ * @brief Options and results for capturing diagnostics for slow calls.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Options for capturing diagnostics for slow calls, see `Options::tail_capture`.
+ */
+struct TailCaptureOptions {
+    /**
+     * Quantile of the running distribution of times for each function.
+     * Calls that are slower than this quantile are recorded as outliers.
+     */
+    double quantile = 0.99;
+
+    /**
+     * Minimum number of calls for each function before any outliers are recorded.
+     * This ensures that the running quantile is reasonably accurate.
+     */
+    int min_calls = 50;
+
+    /**
+     * Maximum number of outliers to store for each function.
+     * Once this is reached, a new outlier replaces the fastest stored outlier if the former is slower.
+     */
+    std::size_t max_outliers = 100;
+
+    /**
+     * Whether to sample the location of a call once it exceeds the running quantile.
+     * This uses `setitimer()` with `ITIMER_REAL` and installs a handler for `SIGALRM` during `time()`, so it should not be used if the functions rely on either of these.
+     * The location is sampled for whichever thread receives the signal, usually the calling thread.
+     *
+     * The signal handler only records the interrupted program counter, as unwinding the stack (e.g., with `backtrace()`) is not async-signal-safe.
+     * The program counter is symbolized with `backtrace_symbols()` after the call has finished.
+     * Only supported on Linux (glibc) and macOS on x86-64 and 64-bit ARM; ignored elsewhere.
+     */
+    bool sample_stack = false;
+};
+
+/**
+ * @brief Diagnostics for a slow call.
+ */
+struct Outlier {
+    /**
+     * Index of the call in `Timings::times`.
+     */
+    std::size_t index = 0;
+
+    /**
+     * Iteration of the call, see `Timings::iterations`.
+     */
+    int iteration = 0;
+
+    /**
+     * Time taken by the call.
+     */
+    std::chrono::duration<double> time = std::chrono::duration<double>(0);
+
+    /**
+     * Running quantile at the time of the call, above which the call was considered to be an outlier.
+     */
+    std::chrono::duration<double> threshold = std::chrono::duration<double>(0);
+
+    /**
+     * Counts for each event in `Options::counters` during the call.
+     * Unavailable counters are set to zero.
+     */
+    std::vector<long long> counters;
+
+    /**
+     * Number of voluntary context switches during the call.
+     * On Linux, this only considers the calling thread; otherwise, it considers the entire process.
+     * This is always zero on platforms without `getrusage()`.
+     */
+    long voluntary_switches = 0;
+
+    /**
+     * Number of involuntary context switches during the call, see `voluntary_switches`.
+     */
+    long involuntary_switches = 0;
+
+    /**
+     * CPU on which the call finished, or -1 if this is not known.
+     */
+    int cpu = -1;
+
+    /**
+     * Frequency of `cpu` in MHz, read immediately after the call.
+     * This is only available on Linux with the `cpufreq` subsystem.
+     */
+    std::optional<double> frequency;
+
+    /**
+     * Symbolized location of the call once it exceeded `threshold`, see `TailCaptureOptions::sample_stack`.
+     * This contains a single frame for the instruction that was executing when the call was interrupted,
+     * and is empty if the location was not sampled.
+     */
+    std::vector<std::string> stack;
+};
+
+}
+
+#endif
@@ -0,0 +1,224 @@
+#ifndef EZTIMER_WORKERS_HPP
+#define EZTIMER_WORKERS_HPP
+
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+
+#include "eztimer.hpp"
+
+/**
+ * @file workers.hpp
+ * @brief Measure load imbalance across workers in parallel functions.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Per-worker busy time for a parallel function.
+ *
+ * Each worker calls `begin()` and `end()` around its share of the work, possibly multiple times per function call.
+ * Each worker has its own preallocated slot on a separate cache line, so workers can record their regions concurrently without synchronization or false sharing.
+ * A worker should only ever use its own slot.
+ */
+class WorkerRegions {
+public:
+    /**
+     * @param num_workers Number of workers.
+     */
+    WorkerRegions(int num_workers) : my_slots(num_workers) {}
+
+public:
+    /**
+     * Start a region of work.
+     * @param worker Index of the worker, less than `num_workers()`.
+     */
+    void begin(int worker) {
+        my_slots[worker].start = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * End the region of work that was started by the last call to `begin()` for the same worker.
+     * @param worker Index of the worker, less than `num_workers()`.
+     */
+    void end(int worker) {
+        auto& slot = my_slots[worker];
+        slot.busy += std::chrono::steady_clock::now() - slot.start;
+    }
+
+    /**
+     * Set the busy time of all workers to zero.
+     */
+    void reset() {
+        for (auto& slot : my_slots) {
+            slot.busy = std::chrono::steady_clock::duration::zero();
+        }
+    }
+
+    /**
+     * @return Number of workers.
+     */
+    int num_workers() const {
+        return my_slots.size();
+    }
+
+    /**
+     * @param worker Index of the worker, less than `num_workers()`.
+     * @return Total time spent in regions by `worker` since the last `reset()`.
+     */
+    std::chrono::duration<double> busy(int worker) const {
+        return std::chrono::duration_cast<std::chrono::duration<double> >(my_slots[worker].busy);
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::duration busy = std::chrono::steady_clock::duration::zero();
+    };
+    std::vector<Slot> my_slots;
+};
+
+/**
+ * @brief Timings and load imbalance for each function.
+ */
+struct ImbalanceTimings {
+    /**
+     * Timings for the function, as reported by `time()`.
+     */
+    Timings timings;
+
+    /**
+     * Imbalance ratio for each run of the function, parallel to `Timings::times`.
+     * This is defined as the maximum busy time across workers divided by the mean busy time, where a value of 1 indicates perfect balance.
+     */
+    std::vector<double> imbalance;
+
+    /**
+     * Index of the critical worker (i.e., the worker with the longest busy time) for each run, parallel to `Timings::times`.
+     */
+    std::vector<int> critical_worker;
+
+    /**
+     * Idle fraction for each run, parallel to `Timings::times`.
+     * This is defined as the proportion of the total worker time (i.e., number of workers multiplied by the wall time) that was not spent in any region.
+     */
+    std::vector<double> idle_fraction;
+
+    /**
+     * Mean of `imbalance`.
+     */
+    double mean_imbalance = 0;
+
+    /**
+     * Mean of `idle_fraction`.
+     */
+    double mean_idle_fraction = 0;
+};
+
+/**
+ * Time parallel functions and measure the load imbalance across their workers for each call.
+ * This can distinguish slowdowns due to poor scheduling (i.e., a straggling worker) from slowdowns in the computation itself.
+ *
+ * Each function is supplied with its own `WorkerRegions`, which is reset before each iteration in `Options::setup`.
+ * Busy times are collected in the `check` step, so neither the reset nor the collection are included in the timings.
+ *
+ * @param funs Vector of functions to be timed.
+ * Each function accepts a `WorkerRegions` in which its workers should record their regions of work.
+ * @param check Function that accepts a `Result_` and an index of `funs`, see `time()` for details.
+ * @param num_workers Number of workers in each function.
+ * @param opt Further options.
+ *
+ * @return Vector of length equal to `funs.size()`, containing the timings and load imbalance for each function.
+ *
+ * @tparam Result_ Result of each function call.
+ */
+template<typename Result_>
+std::vector<ImbalanceTimings> time_imbalance(
+    const std::vector<std::function<Result_(WorkerRegions&)> >& funs,
+    const std::function<void(const Result_&, std::size_t)>& check,
+    int num_workers,
+    const Options& opt
+) {
+    const auto nfun = funs.size();
+    std::vector<WorkerRegions> regions(nfun, WorkerRegions(num_workers));
+
+    std::vector<std::function<Result_()> > wrapped;
+    wrapped.reserve(nfun);
+    for (std::size_t f = 0; f < nfun; ++f) {
+        const auto& curfun = funs[f];
+        auto& curregions = regions[f];
+        wrapped.emplace_back([&curfun, &curregions]() -> Result_ { return curfun(curregions); });
+    }
+
+    auto topt = opt;
+    topt.setup = [&]() -> void {
+        for (auto& reg : regions) {
+            reg.reset();
+        }
+        if (opt.setup) {
+            opt.setup();
+        }
+    };
+
+    std::vector<ImbalanceTimings> output(nfun);
+    std::vector<std::vector<std::vector<double> > > busy(nfun);
+    auto timings = time<Result_>(
+        wrapped,
+        [&](const Result_& res, std::size_t i) -> void {
+            std::vector<double> current;
+            current.reserve(num_workers);
+            for (int w = 0; w < num_workers; ++w) {
+                current.push_back(regions[i].busy(w).count());
+            }
+            busy[i].push_back(std::move(current));
+            check(res, i);
+        },
+        topt
+    );
+
+    for (std::size_t f = 0; f < nfun; ++f) {
+        auto& curout = output[f];
+        curout.timings = std::move(timings[f]);
+        const auto& curbusy = busy[f];
+        const auto nruns = curbusy.size();
+        curout.imbalance.reserve(nruns);
+        curout.critical_worker.reserve(nruns);
+        curout.idle_fraction.reserve(nruns);
+
+        for (std::size_t r = 0; r < nruns; ++r) {
+            const auto& current = curbusy[r];
+            double total = 0, maxed = 0;
+            int critical = 0;
+            for (int w = 0; w < num_workers; ++w) {
+                total += current[w];
+                if (current[w] > maxed) {
+                    maxed = current[w];
+                    critical = w;
+                }
+            }
+
+            const double mean = total / num_workers;
+            curout.imbalance.push_back(mean > 0 ? maxed / mean : 1);
+            curout.critical_worker.push_back(critical);
+
+            const double available = curout.timings.times[r].count() * num_workers;
+            curout.idle_fraction.push_back(available > 0 ? std::max(0.0, 1 - total / available) : 0);
+
+            curout.mean_imbalance += curout.imbalance.back();
+            curout.mean_idle_fraction += curout.idle_fraction.back();
+        }
+
+        if (nruns) {
+            curout.mean_imbalance /= nruns;
+            curout.mean_idle_fraction /= nruns;
+        }
+    }
+
+    return output;
+}
+
+}
+
+#endif
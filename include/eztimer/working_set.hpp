@@ -0,0 +1,230 @@
+#ifndef EZTIMER_WORKING_SET_HPP
+#define EZTIMER_WORKING_SET_HPP
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <algorithm>
+#include <functional>
+
+#include "eztimer.hpp"
+#include "probe.hpp"
+
+/**
+ * @file working_set.hpp
+ * @brief Sweep the working set size of a function to locate cache cliffs.
+ */
+
+namespace eztimer {
+
+/**
+ * @brief Options for `sweep_working_set()`.
+ */
+struct WorkingSetOptions {
+    /**
+     * Smallest size to pass to each factory, in elements.
+     */
+    std::size_t min_size = 1 << 8;
+
+    /**
+     * Largest size to pass to each factory, in elements.
+     */
+    std::size_t max_size = 1 << 22;
+
+    /**
+     * Multiplicative step between consecutive sizes.
+     */
+    double step = 2;
+
+    /**
+     * Number of bytes in the working set for each element, used to compare sizes to the cache sizes in `profile`.
+     */
+    double bytes_per_element = 8;
+
+    /**
+     * Minimum ratio of the per-element costs between consecutive plateaus for a cliff to be reported.
+     */
+    double cliff_ratio = 1.3;
+
+    /**
+     * Profile of the current machine, typically from `cached_probe()`.
+     * If set, cliffs are annotated with the cache level with the closest capacity.
+     */
+    std::optional<MachineProfile> profile;
+
+    /**
+     * Further options to pass to `time()` at each size.
+     */
+    Options timing;
+};
+
+/**
+ * @brief Cliff in the per-element cost of a function.
+ */
+struct WorkingSetCliff {
+    /**
+     * Largest size before the per-element cost increases, in elements.
+     */
+    std::size_t size = 0;
+
+    /**
+     * Working set corresponding to `size`, in bytes.
+     */
+    double bytes = 0;
+
+    /**
+     * Per-element cost before the cliff.
+     */
+    std::chrono::duration<double> before = std::chrono::duration<double>(0);
+
+    /**
+     * Per-element cost after the cliff, once the cost stops increasing.
+     */
+    std::chrono::duration<double> after = std::chrono::duration<double>(0);
+
+    /**
+     * Index of the matching cache level in `MachineProfile::cache_sizes`, i.e., the level whose capacity is closest to `bytes` and within a factor of 2.
+     * This is not set if `WorkingSetOptions::profile` is not set or no level matches.
+     * Cliffs that do not match any cache level are often caused by exhausting the reach of the TLB.
+     */
+    std::optional<std::size_t> cache_level;
+
+    /**
+     * Name of the matching cache level (e.g., `"L2"`), or an empty string if `cache_level` is not set.
+     */
+    std::string annotation;
+};
+
+/**
+ * @brief Per-element cost of a function across working set sizes.
+ */
+struct WorkingSetCurve {
+    /**
+     * Sizes passed to the factory, in elements.
+     */
+    std::vector<std::size_t> sizes;
+
+    /**
+     * Timings at each size in `sizes`.
+     */
+    std::vector<Timings> timings;
+
+    /**
+     * Mean time per element at each size in `sizes`.
+     */
+    std::vector<std::chrono::duration<double> > per_element;
+
+    /**
+     * Cliffs in `per_element`, ordered by size.
+     */
+    std::vector<WorkingSetCliff> cliffs;
+};
+
+/**
+ * @cond
+ */
+namespace internal {
+
+inline void find_working_set_cliffs(WorkingSetCurve& curve, const WorkingSetOptions& opt) {
+    curve.cliffs.clear();
+    std::vector<double> costs;
+    costs.reserve(curve.per_element.size());
+    for (auto cost : curve.per_element) {
+        costs.push_back(cost.count());
+    }
+
+    for (const auto& cliff : find_cliffs(costs, opt.cliff_ratio)) {
+        WorkingSetCliff current;
+        current.size = curve.sizes[cliff.before];
+        current.bytes = current.size * opt.bytes_per_element;
+        current.before = std::chrono::duration<double>(cliff.plateau);
+        current.after = curve.per_element[cliff.after];
+
+        // Matching to the cache level with the closest capacity, within a factor of 2.
+        if (opt.profile.has_value()) {
+            const auto& caches = opt.profile->cache_sizes;
+            double best = std::log(2.0);
+            for (std::size_t c = 0; c < caches.size(); ++c) {
+                const double distance = std::abs(std::log(current.bytes / static_cast<double>(caches[c])));
+                if (distance <= best) {
+                    best = distance;
+                    current.cache_level = c;
+                }
+            }
+            if (current.cache_level.has_value()) {
+                current.annotation = "L" + std::to_string(*(current.cache_level) + 1);
+            }
+        }
+
+        curve.cliffs.push_back(std::move(current));
+    }
+}
+
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Time functions over a geometric sequence of working set sizes, and locate the sizes at which the per-element cost increases, e.g., when the working set no longer fits in a cache level.
+ * At each size, each factory is called to create a function for that size, and all functions are timed together with `time()`.
+ * Creation of the functions is not included in the timings.
+ *
+ * @param factories Vector of factories.
+ * Each factory should accept a size (in elements) and return a function that processes a working set of that size.
+ * The returned function should return a value that depends on the computation of interest, see `time()` for details.
+ * @param check Function that accepts a `Result_` and an index of `factories`, see `time()` for details.
+ * @param opt Further options.
+ *
+ * @return Vector of length equal to `factories.size()`, containing the curve for each factory.
+ *
+ * @tparam Result_ Result of each function call.
+ */
+template<typename Result_>
+std::vector<WorkingSetCurve> sweep_working_set(
+    const std::vector<std::function<std::function<Result_()>(std::size_t)> >& factories,
+    const std::function<void(const Result_&, std::size_t)>& check,
+    const WorkingSetOptions& opt
+) {
+    const auto nfun = factories.size();
+    std::vector<WorkingSetCurve> output(nfun);
+
+    // Skipping repeated sizes when the step is small and the sizes are rounded down.
+    std::vector<std::size_t> sizes;
+    const double step = std::max(opt.step, 1.01);
+    for (double size = std::max(opt.min_size, static_cast<std::size_t>(1)); size <= static_cast<double>(opt.max_size); size *= step) {
+        const auto elements = static_cast<std::size_t>(size);
+        if (sizes.empty() || sizes.back() != elements) {
+            sizes.push_back(elements);
+        }
+    }
+
+    for (auto elements : sizes) {
+        std::vector<std::function<Result_()> > funs;
+        funs.reserve(nfun);
+        for (const auto& factory : factories) {
+            funs.push_back(factory(elements));
+        }
+
+        auto timings = time<Result_>(funs, check, opt.timing);
+        for (std::size_t f = 0; f < nfun; ++f) {
+            auto& curout = output[f];
+            curout.sizes.push_back(elements);
+            curout.per_element.push_back(timings[f].mean / static_cast<double>(elements));
+            curout.timings.push_back(std::move(timings[f]));
+        }
+    }
+
+    for (auto& curout : output) {
+        internal::find_working_set_cliffs(curout, opt);
+    }
+
+    return output;
+}
+
+}
+
+#endif
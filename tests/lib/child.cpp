@@ -0,0 +1,41 @@
+#include "eztimer/process.hpp"
+
+#include <thread>
+#include <string>
+#include <cstdlib>
+#include <iostream>
+
+// Test executable for process.hpp, which sleeps for a specified number of
+// milliseconds and reports some timings to the parent.
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        return 1;
+    }
+    int ms = std::atoi(argv[1]);
+    const char* extra = std::getenv("EZTIMER_TEST_SLEEP");
+    if (extra) {
+        ms += std::atoi(extra);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+
+    // A reported time of '-' is replaced by the sleep time.
+    for (int i = 2; i + 1 < argc; i += 2) {
+        const std::string reported = argv[i + 1];
+        const double seconds = (reported == "-" ? ms / 1000.0 : std::atof(reported.c_str()));
+        eztimer::report_to_parent(argv[i], std::chrono::duration<double>(seconds));
+    }
+
+    // Reporting the length of an environment variable's value as the time,
+    // to check what the child actually sees.
+    const char* inspect = std::getenv("EZTIMER_TEST_INSPECT");
+    if (inspect) {
+        const char* value = std::getenv(inspect);
+        eztimer::report_to_parent(inspect, std::chrono::duration<double>(value ? std::string(value).size() : 0));
+    }
+
+    const char* env = std::getenv("EZTIMER_TEST_FAIL");
+    if (env && std::string(env) == "1") {
+        return 1;
+    }
+    return 0;
+}
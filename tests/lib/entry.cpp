@@ -0,0 +1,10 @@
+// Both builds export the same symbols, so that we can check that each
+// library resolves its own copy of 'internal_version()'.
+
+int internal_version() {
+    return EZTIMER_TEST_VERSION;
+}
+
+extern "C" int eztimer_test_entry() {
+    return internal_version();
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/alignment.hpp"
+
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+
+TEST(Alignment, Basic) {
+    std::vector<double> x(1000);
+    std::iota(x.begin(), x.end(), 0);
+    std::vector<int> y(50, 1);
+
+    std::vector<std::pair<const void*, std::size_t> > buffers;
+    buffers.emplace_back(x.data(), x.size() * sizeof(double));
+    buffers.emplace_back(y.data(), y.size() * sizeof(int));
+
+    std::vector<std::function<double(const std::vector<void*>&)> > funs;
+    funs.emplace_back([&](const std::vector<void*>& ptrs) -> double {
+        const double* ptr = static_cast<const double*>(ptrs[0]);
+        return std::accumulate(ptr, ptr + x.size(), 0.0);
+    });
+    funs.emplace_back([&](const std::vector<void*>& ptrs) -> double {
+        const int* ptr = static_cast<const int*>(ptrs[1]);
+        return std::accumulate(ptr, ptr + y.size(), 0.0);
+    });
+
+    eztimer::AlignmentOptions opt;
+    opt.offsets = std::vector<std::size_t>{ 0, 8, 64, 4064 };
+
+    auto output = eztimer::time_alignments<double>(
+        buffers,
+        funs,
+        [&](const double& res, std::size_t i) -> void {
+            EXPECT_EQ(res, (i == 0 ? 499500 : 50));
+        },
+        opt
+    );
+
+    EXPECT_EQ(output.offsets, opt.offsets);
+    ASSERT_EQ(output.timings.size(), opt.offsets.size());
+    for (const auto& current : output.timings) {
+        ASSERT_EQ(current.size(), funs.size());
+        for (const auto& curout : current) {
+            EXPECT_EQ(curout.times.size(), opt.timing.iterations);
+        }
+    }
+
+    ASSERT_EQ(output.best.size(), funs.size());
+    ASSERT_EQ(output.worst.size(), funs.size());
+    for (std::size_t f = 0; f < funs.size(); ++f) {
+        EXPECT_LE(output.timings[output.best[f]][f].mean, output.timings[output.worst[f]][f].mean);
+        EXPECT_GE(output.sensitivity[f], 1);
+    }
+}
+
+TEST(Alignment, Placement) {
+    std::vector<unsigned char> x(100, 1);
+    std::vector<std::pair<const void*, std::size_t> > buffers;
+    buffers.emplace_back(x.data(), x.size());
+
+    eztimer::AlignmentOptions opt;
+    opt.offsets = std::vector<std::size_t>{ 0, 1, 64, 4095 };
+    opt.timing.iterations = 1;
+    opt.timing.burn_in = 0;
+
+    std::vector<std::function<std::uintptr_t(const std::vector<void*>&)> > funs;
+    funs.emplace_back([&](const std::vector<void*>& ptrs) -> std::uintptr_t {
+        EXPECT_EQ(*static_cast<const unsigned char*>(ptrs[0]), 1);
+        return reinterpret_cast<std::uintptr_t>(ptrs[0]);
+    });
+
+    std::vector<std::size_t> observed;
+    eztimer::time_alignments<std::uintptr_t>(
+        buffers,
+        funs,
+        [&](const std::uintptr_t& res, std::size_t) -> void {
+            observed.push_back(res % opt.page_size);
+        },
+        opt
+    );
+
+    std::sort(observed.begin(), observed.end());
+    EXPECT_EQ(observed, opt.offsets);
+}
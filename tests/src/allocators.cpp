@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/allocators.hpp"
+
+#include <cstdlib>
+
+TEST(Allocators, Basic) {
+    eztimer::Command command;
+    command.arguments = std::vector<std::string>{ EZTIMER_TEST_CHILD, "0", "foo", "0.5", "bar", "0.25" };
+
+    // We don't have an actual allocator library to test with, so we just
+    // preload an innocuous library to check that the machinery works.
+    eztimer::AllocatorOptions opt;
+    opt.process.timing.iterations = 3;
+    auto output = eztimer::compare_allocators(command, { EZTIMER_TEST_LIBRARY_V1 }, opt);
+
+    ASSERT_EQ(output.allocators.size(), 2);
+    EXPECT_EQ(output.allocators[0], "");
+    EXPECT_EQ(output.allocators[1], EZTIMER_TEST_LIBRARY_V1);
+    EXPECT_EQ(output.functions, std::vector<std::string>({ "foo", "bar" }));
+
+    ASSERT_EQ(output.timings.size(), 2);
+    ASSERT_EQ(output.comparisons.size(), 2);
+    ASSERT_EQ(output.speedups.size(), 2);
+    ASSERT_EQ(output.overall.size(), 2);
+    for (std::size_t a = 0; a < 2; ++a) {
+        ASSERT_EQ(output.timings[a].size(), 2);
+        EXPECT_DOUBLE_EQ(output.timings[a][0].mean.count(), 0.5);
+        EXPECT_DOUBLE_EQ(output.timings[a][1].mean.count(), 0.25);
+        EXPECT_EQ(output.processes.timings[a].times.size(), 3);
+
+        ASSERT_EQ(output.speedups[a].size(), 2);
+        EXPECT_DOUBLE_EQ(output.speedups[a][0], 1);
+        EXPECT_EQ(output.comparisons[a][0].pairs, 3);
+        EXPECT_EQ(output.overall[a].pairs, 3);
+
+        EXPECT_GT(output.max_rss[a], 0);
+        EXPECT_GT(output.minor_faults[a], 0);
+    }
+}
+
+TEST(Allocators, Override) {
+    // Existing preload variables in the command are replaced.
+    eztimer::Command command;
+    command.arguments = std::vector<std::string>{ EZTIMER_TEST_CHILD, "0" };
+    eztimer::AllocatorOptions opt;
+    command.environment.emplace_back(opt.preload_variable, "/this/does/not/exist.so");
+    command.environment.emplace_back("EZTIMER_TEST_FAIL", "0");
+
+    opt.process.timing.iterations = 1;
+    opt.process.timing.burn_in = 0;
+    auto output = eztimer::compare_allocators(command, { EZTIMER_TEST_LIBRARY_V2 }, opt);
+    EXPECT_TRUE(output.functions.empty());
+    EXPECT_EQ(output.processes.timings[1].times.size(), 1);
+}
+
+TEST(Allocators, DefaultWithoutPreload) {
+    // The default allocator ignores preloads from the command and the parent.
+    eztimer::AllocatorOptions opt;
+    eztimer::Command command;
+    command.arguments = std::vector<std::string>{ EZTIMER_TEST_CHILD, "0" };
+    command.environment.emplace_back(opt.preload_variable, EZTIMER_TEST_LIBRARY_V1);
+    command.environment.emplace_back("EZTIMER_TEST_INSPECT", opt.preload_variable);
+
+    const char* previous = std::getenv(opt.preload_variable.c_str());
+    const std::string saved = (previous ? previous : "");
+    setenv(opt.preload_variable.c_str(), EZTIMER_TEST_LIBRARY_V1, 1);
+
+    opt.process.timing.iterations = 1;
+    opt.process.timing.burn_in = 0;
+    auto output = eztimer::compare_allocators(command, { EZTIMER_TEST_LIBRARY_V2 }, opt);
+
+    if (previous) {
+        setenv(opt.preload_variable.c_str(), saved.c_str(), 1);
+    } else {
+        unsetenv(opt.preload_variable.c_str());
+    }
+
+    ASSERT_EQ(output.functions, std::vector<std::string>{ opt.preload_variable });
+    EXPECT_EQ(output.timings[0][0].mean.count(), 0);
+    EXPECT_EQ(output.timings[1][0].mean.count(), std::string(EZTIMER_TEST_LIBRARY_V2).size());
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/attribution.hpp"
+#include "utils.hpp"
+
+#include <random>
+
+TEST(Attribution, Basic) {
+    auto timings = counter_driven_timings(500);
+    auto attr = eztimer::attribute_counters(timings);
+
+    EXPECT_EQ(attr.samples, 500);
+    ASSERT_EQ(attr.marginal_cost.size(), 4);
+    EXPECT_NEAR(attr.marginal_cost[0], 5e-8, 1e-9);
+    EXPECT_NEAR(attr.marginal_cost[1], 2e-6, 1e-7);
+    EXPECT_TRUE(std::isnan(attr.marginal_cost[2])); // unavailable.
+    EXPECT_TRUE(std::isnan(attr.marginal_cost[3])); // constant.
+    EXPECT_NEAR(attr.intercept, 1e-5, 1e-7);
+
+    EXPECT_GT(attr.total_r_squared, 0.99);
+    EXPECT_LE(attr.total_r_squared, 1);
+    EXPECT_GT(attr.r_squared[0], attr.r_squared[1]);
+    EXPECT_NEAR(attr.r_squared[0] + attr.r_squared[1], attr.total_r_squared, 0.05); // as the counters are independent.
+}
+
+TEST(Attribution, Collinear) {
+    auto timings = counter_driven_timings(100);
+    timings.counters[2] = timings.counters[0];
+    for (auto& x : timings.counters[2]) {
+        x *= 2;
+    }
+
+    auto attr = eztimer::attribute_counters(timings);
+    EXPECT_FALSE(std::isnan(attr.marginal_cost[0]));
+    EXPECT_FALSE(std::isnan(attr.r_squared[2]));
+    EXPECT_TRUE(std::isnan(attr.marginal_cost[2]));
+    EXPECT_NEAR(attr.r_squared[0], attr.r_squared[2], 1e-8);
+}
+
+TEST(Attribution, Empty) {
+    eztimer::Timings timings;
+    timings.counters.resize(2);
+    auto attr = eztimer::attribute_counters(timings);
+    EXPECT_EQ(attr.samples, 0);
+    EXPECT_EQ(attr.marginal_cost.size(), 2);
+    EXPECT_TRUE(std::isnan(attr.intercept));
+
+    // Works with counters from an actual run, though they may be unavailable.
+    eztimer::Options opt;
+    opt.iterations = 20;
+    opt.counters = std::vector<eztimer::Counter>{ eztimer::Counter::PAGE_FAULTS, eztimer::Counter::CYCLES };
+    std::vector<std::function<double()> > funs;
+    funs.emplace_back([]() -> double {
+        std::vector<double> x(10000, 1);
+        return x.back();
+    });
+    auto output = eztimer::time<double>(funs, [](const double&, std::size_t) -> void {}, opt);
+    auto attr2 = eztimer::attribute_counters(output[0]);
+    EXPECT_EQ(attr2.samples, 20);
+    EXPECT_EQ(attr2.r_squared.size(), 2);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/calibration.hpp"
+
+#include <thread>
+#include <set>
+
+TEST(Calibration, RandomCycle) {
+    std::mt19937_64 rng(10);
+    auto cycle = eztimer::internal::random_cycle(1000, rng);
+
+    // Checking that we visit every element exactly once before returning to the start.
+    std::set<std::size_t> visited;
+    std::size_t current = 0;
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(visited.insert(current).second);
+        current = cycle[current];
+    }
+    EXPECT_EQ(current, 0);
+    EXPECT_EQ(eztimer::internal::pointer_chase(cycle, 1000), 0);
+    EXPECT_NE(eztimer::internal::pointer_chase(cycle, 999), 0);
+}
+
+TEST(Calibration, Basic) {
+    std::vector<std::function<int()> > funs;
+    funs.emplace_back([]() -> int {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        return 1;
+    });
+    funs.emplace_back([]() -> int {
+        std::this_thread::sleep_for(std::chrono::milliseconds(4));
+        return 2;
+    });
+
+    eztimer::CalibrationOptions opt;
+    opt.operations = 1 << 16;
+    opt.buffer_size = 1 << 20;
+    opt.loads = 1 << 14;
+    opt.timing.iterations = 5;
+
+    std::vector<int> checked(2);
+    auto res = eztimer::time_calibrated<int>(funs, [&](const int& x, std::size_t i) -> void {
+        EXPECT_EQ(x, static_cast<int>(i + 1));
+        ++checked[i];
+    }, opt);
+
+    EXPECT_EQ(checked[0], 5);
+    EXPECT_EQ(checked[1], 5);
+
+    ASSERT_EQ(res.timings.size(), 2);
+    ASSERT_EQ(res.reference.size(), 4);
+    ASSERT_EQ(res.kernels.size(), 4);
+    for (const auto& ref : res.reference) {
+        EXPECT_EQ(ref.times.size(), 5);
+        EXPECT_GT(ref.mean.count(), 0);
+    }
+
+    double logsum = 0;
+    for (const auto& ref : res.reference) {
+        logsum += std::log(ref.mean.count());
+    }
+    EXPECT_NEAR(res.reference_unit.count(), std::exp(logsum / 4), 1e-12);
+
+    ASSERT_EQ(res.normalized.size(), 2);
+    EXPECT_NEAR(res.normalized[0], res.timings[0].mean / res.reference_unit, 1e-8);
+    EXPECT_GT(res.normalized[1], res.normalized[0]);
+    ASSERT_EQ(res.relative.size(), 2);
+    ASSERT_EQ(res.relative[1].size(), 4);
+    EXPECT_NEAR(res.relative[1][2], res.timings[1].mean / res.reference[2].mean, 1e-8);
+}
+
+TEST(Calibration, Subset) {
+    std::vector<std::function<int()> > funs;
+    funs.emplace_back([]() -> int { return 1; });
+
+    eztimer::CalibrationOptions opt;
+    opt.kernels = { eztimer::ReferenceKernel::INTEGER };
+    opt.operations = 1 << 10;
+    opt.timing.iterations = 3;
+    auto res = eztimer::time_calibrated<int>(funs, [](const int&, std::size_t) -> void {}, opt);
+    ASSERT_EQ(res.reference.size(), 1);
+    EXPECT_NEAR(res.reference_unit.count(), res.reference[0].mean.count(), 1e-12);
+    EXPECT_NEAR(res.normalized[0], res.relative[0][0], 1e-12);
+}
+
+struct CalibrationTracked {
+    CalibrationTracked() = default;
+    CalibrationTracked(int v) : value(v) {}
+    CalibrationTracked(const CalibrationTracked& other) : value(other.value) { ++copies; }
+    CalibrationTracked(CalibrationTracked&& other) : value(other.value) { ++copies; }
+    CalibrationTracked& operator=(const CalibrationTracked&) = default;
+    CalibrationTracked& operator=(CalibrationTracked&&) = default;
+    int value = 0;
+    inline static int copies = 0;
+};
+
+TEST(Calibration, Unwrapped) {
+    std::vector<std::function<CalibrationTracked()> > funs;
+    funs.emplace_back([]() -> CalibrationTracked { return CalibrationTracked(1); });
+    funs.emplace_back([]() -> CalibrationTracked { return CalibrationTracked(2); });
+
+    eztimer::CalibrationOptions opt;
+    opt.kernels = { eztimer::ReferenceKernel::INTEGER };
+    opt.operations = 1 << 10;
+    opt.timing.iterations = 10;
+
+    // The user's results should be handled exactly as in time(), without any extra copies or moves.
+    std::function<void(const CalibrationTracked&, std::size_t)> check = [](const CalibrationTracked& x, std::size_t i) -> void {
+        EXPECT_EQ(x.value, static_cast<int>(i + 1));
+    };
+    CalibrationTracked::copies = 0;
+    eztimer::time<CalibrationTracked>(funs, check, opt.timing);
+    const int direct = CalibrationTracked::copies;
+
+    CalibrationTracked::copies = 0;
+    auto res = eztimer::time_calibrated<CalibrationTracked>(funs, check, opt);
+    EXPECT_EQ(CalibrationTracked::copies, direct);
+    EXPECT_EQ(res.timings[0].times.size(), 10);
+}
+
+TEST(Calibration, NotDefaultConstructible) {
+    struct Wrapper {
+        Wrapper(int v) : value(v) {}
+        int value;
+    };
+    std::vector<std::function<Wrapper()> > funs;
+    funs.emplace_back([]() -> Wrapper { return Wrapper(5); });
+
+    eztimer::CalibrationOptions opt;
+    opt.kernels = { eztimer::ReferenceKernel::INTEGER };
+    opt.operations = 1 << 10;
+    opt.timing.iterations = 3;
+
+    int checked = 0;
+    auto res = eztimer::time_calibrated<Wrapper>(funs, [&](const Wrapper& x, std::size_t) -> void {
+        EXPECT_EQ(x.value, 5);
+        ++checked;
+    }, opt);
+    EXPECT_EQ(checked, 3);
+    ASSERT_EQ(res.reference.size(), 1);
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/columnar.hpp"
+#include "utils.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+class ColumnarTest : public ::testing::Test {
+protected:
+    std::filesystem::path path;
+
+    void SetUp() {
+        path = std::filesystem::temp_directory_path() / ("eztimer-columnar-" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()) + ".bin");
+    }
+
+    void TearDown() {
+        std::filesystem::remove(path);
+    }
+};
+
+TEST_F(ColumnarTest, Basic) {
+    std::vector<eztimer::Timings> timings { random_timings(101, 1, 2), random_timings(7, 2, 2), random_timings(0, 3, 0) };
+    timings[1].counters[1].clear(); // mimicking an unavailable counter.
+    timings[1].cpus.clear();
+
+    eztimer::ColumnarOptions opt;
+    opt.names = { "foo", "bar", "empty" };
+    opt.metadata = { { "commit", "abc123" }, { "fingerprint", "0123456789abcdef" } };
+    opt.counters = { eztimer::Counter::CYCLES, eztimer::Counter::PAGE_FAULTS };
+    eztimer::write_columnar(path, timings, opt);
+
+    eztimer::ColumnarReader reader(path);
+    ASSERT_EQ(reader.size(), 3);
+    EXPECT_EQ(reader.metadata(), opt.metadata);
+    auto counters = reader.counters();
+    ASSERT_EQ(counters.size(), 2);
+    EXPECT_EQ(*(counters[0]), eztimer::Counter::CYCLES);
+    EXPECT_EQ(*(counters[1]), eztimer::Counter::PAGE_FAULTS);
+
+    for (std::size_t f = 0; f < timings.size(); ++f) {
+        const auto& expected = timings[f];
+        const auto& summary = reader.summary(f);
+        EXPECT_EQ(summary.name, opt.names[f]);
+        EXPECT_EQ(summary.count, expected.times.size());
+        EXPECT_EQ(summary.mean, expected.mean.count());
+        EXPECT_EQ(summary.sd, expected.sd.count());
+        if (!expected.times.empty()) {
+            EXPECT_EQ(summary.min, std::min_element(expected.times.begin(), expected.times.end())->count());
+            EXPECT_EQ(summary.max, std::max_element(expected.times.begin(), expected.times.end())->count());
+        }
+
+        auto times = reader.times(f);
+        ASSERT_EQ(times.size(), expected.times.size());
+        for (std::size_t i = 0; i < times.size(); ++i) {
+            EXPECT_EQ(times[i], expected.times[i].count());
+        }
+        if (!times.empty()) {
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(times.data()) % 8, 0);
+        }
+
+        auto iterations = reader.iterations(f);
+        EXPECT_EQ(std::vector<int>(iterations.begin(), iterations.end()), expected.iterations);
+        auto cpus = reader.cpus(f);
+        EXPECT_EQ(std::vector<int>(cpus.begin(), cpus.end()), expected.cpus);
+
+        auto loaded = reader.load(f);
+        EXPECT_EQ(loaded.times, expected.times);
+        EXPECT_EQ(loaded.iterations, expected.iterations);
+        EXPECT_EQ(loaded.cpus, expected.cpus);
+        EXPECT_EQ(loaded.mean, expected.mean);
+        ASSERT_EQ(loaded.counters.size(), 2);
+        for (std::size_t c = 0; c < expected.counters.size(); ++c) {
+            auto column = reader.counter(f, c);
+            EXPECT_EQ(std::vector<long long>(column.begin(), column.end()), expected.counters[c]);
+            EXPECT_EQ(loaded.counters[c], expected.counters[c]);
+        }
+    }
+
+    EXPECT_TRUE(reader.counter(1, 1).empty());
+    EXPECT_TRUE(reader.counter(2, 0).empty());
+    EXPECT_ANY_THROW(reader.times(3));
+
+    // Moving the reader preserves the views.
+    auto first = reader.times(0)[0];
+    eztimer::ColumnarReader moved(std::move(reader));
+    EXPECT_EQ(moved.times(0)[0], first);
+}
+
+TEST_F(ColumnarTest, Defaults) {
+    std::vector<eztimer::Timings> timings { random_timings(5, 1, 1), random_timings(3, 2, 1) };
+    eztimer::write_columnar(path, timings);
+
+    eztimer::ColumnarReader reader(path);
+    EXPECT_EQ(reader.summary(0).name, "0");
+    EXPECT_EQ(reader.summary(1).name, "1");
+    EXPECT_TRUE(reader.metadata().empty());
+    auto counters = reader.counters();
+    ASSERT_EQ(counters.size(), 1);
+    EXPECT_FALSE(counters[0].has_value());
+    EXPECT_EQ(reader.counter(1, 0).size(), 3);
+}
+
+TEST_F(ColumnarTest, Profile) {
+    std::vector<eztimer::Timings> timings { random_timings(5, 1, 0) };
+    eztimer::write_columnar(path, timings);
+    EXPECT_FALSE(eztimer::ColumnarReader(path).profile().has_value());
+
+    eztimer::ColumnarOptions opt;
+    opt.metadata = { { "commit", "abc123" } };
+    opt.profile = eztimer::MachineProfile();
+    opt.profile->fingerprint.cpu_model = "fancy";
+    opt.profile->triad_bandwidth = 5e9;
+    eztimer::write_columnar(path, timings, opt);
+
+    eztimer::ColumnarReader reader(path);
+    ASSERT_EQ(reader.metadata().size(), 2);
+    EXPECT_EQ(reader.metadata()[0].first, "commit");
+    auto profile = reader.profile();
+    ASSERT_TRUE(profile.has_value());
+    EXPECT_EQ(profile->fingerprint.cpu_model, "fancy");
+    EXPECT_EQ(profile->triad_bandwidth, 5e9);
+    EXPECT_EQ(reader.times(0).size(), 5);
+}
+
+TEST_F(ColumnarTest, Errors) {
+    std::vector<eztimer::Timings> timings { random_timings(5, 1, 0) };
+    eztimer::ColumnarOptions opt;
+    opt.names = { "a", "b" };
+    EXPECT_ANY_THROW(eztimer::write_columnar(path, timings, opt));
+
+    opt.names.clear();
+    opt.counters = { eztimer::Counter::CYCLES };
+    timings[0].counters.resize(2);
+    EXPECT_ANY_THROW(eztimer::write_columnar(path, timings, opt));
+
+    EXPECT_ANY_THROW(eztimer::ColumnarReader(path.string() + ".missing"));
+
+    {
+        std::ofstream handle(path, std::ios::binary);
+        handle << "not a columnar file";
+    }
+    EXPECT_ANY_THROW(eztimer::ColumnarReader reader(path));
+
+    // Truncating a valid file.
+    eztimer::write_columnar(path, { random_timings(100, 1, 0) });
+    const auto full = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, full - 16);
+    EXPECT_ANY_THROW(eztimer::ColumnarReader reader(path));
+    std::filesystem::resize_file(path, 20);
+    EXPECT_ANY_THROW(eztimer::ColumnarReader reader(path));
+
+    // Corrupting the number of functions or counters, which should be reported as a truncated header instead of attempting a huge allocation.
+    auto corrupt = [&](std::uint64_t position) -> void {
+        eztimer::write_columnar(path, { random_timings(100, 1, 0) });
+        std::fstream handle(path, std::ios::binary | std::ios::in | std::ios::out);
+        handle.seekp(position);
+        const std::uint32_t garbage = 0xFFFFFFFF;
+        handle.write(reinterpret_cast<const char*>(&garbage), sizeof(garbage));
+    };
+    for (std::uint64_t position : { 12, 16 }) {
+        corrupt(position);
+        try {
+            eztimer::ColumnarReader reader(path);
+            FAIL() << "expected an error for a corrupt header";
+        } catch (std::runtime_error& e) {
+            EXPECT_NE(std::string(e.what()).find("truncated header"), std::string::npos);
+        }
+    }
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/compare.hpp"
+#include "utils.hpp"
+
+#include <thread>
+#include <random>
+
+TEST(ComparePaired, Basic) {
+    auto first = mock_timings({ 1, 2, 3, 4, 5 });
+    auto second = mock_timings({ 2.1, 3.9, 6.2, 8, 9.8 });
+    auto comp = eztimer::compare_paired(first, second);
+    EXPECT_EQ(comp.pairs, 5);
+    EXPECT_NEAR(comp.ratio, 2, 0.05);
+    EXPECT_LT(comp.lower, comp.ratio);
+    EXPECT_GT(comp.upper, comp.ratio);
+    EXPECT_TRUE(comp.significant);
+
+    // Symmetric when flipped.
+    auto flipped = eztimer::compare_paired(second, first);
+    EXPECT_NEAR(flipped.ratio, 1 / comp.ratio, 1e-8);
+    EXPECT_NEAR(flipped.lower, 1 / comp.upper, 1e-8);
+    EXPECT_TRUE(flipped.significant);
+
+    // Not significant if there's no consistent difference.
+    auto noisy = mock_timings({ 1.1, 1.9, 3.2, 3.8, 5.1 });
+    auto comp2 = eztimer::compare_paired(first, noisy);
+    EXPECT_FALSE(comp2.significant);
+}
+
+TEST(ComparePaired, Iterations) {
+    // Pairing is done by iteration index, so skipped iterations are ignored.
+    auto first = mock_timings({ 1, 2, 3 }, { 0, 1, 2 });
+    auto second = mock_timings({ 6, 2 }, { 2, 0 });
+    auto comp = eztimer::compare_paired(first, second);
+    EXPECT_EQ(comp.pairs, 2);
+    EXPECT_DOUBLE_EQ(comp.ratio, 2);
+    EXPECT_DOUBLE_EQ(comp.lower, 2);
+    EXPECT_DOUBLE_EQ(comp.upper, 2);
+}
+
+TEST(ComparePaired, Empty) {
+    auto comp = eztimer::compare_paired(mock_timings({}), mock_timings({ 1 }));
+    EXPECT_EQ(comp.pairs, 0);
+    EXPECT_TRUE(std::isnan(comp.ratio));
+
+    auto comp1 = eztimer::compare_paired(mock_timings({ 1 }), mock_timings({ 2 }));
+    EXPECT_EQ(comp1.pairs, 1);
+    EXPECT_EQ(comp1.ratio, 2);
+    EXPECT_TRUE(std::isnan(comp1.lower));
+    EXPECT_FALSE(comp1.significant);
+}
+
+TEST(ComparePaired, Timed) {
+    std::vector<std::function<int()> > funs;
+    funs.emplace_back([]() -> int {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        return 0;
+    });
+    funs.emplace_back([]() -> int {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return 0;
+    });
+
+    eztimer::Options opt;
+    auto output = eztimer::time<int>(funs, [](const int&, std::size_t) -> void {}, opt);
+    for (const auto& curout : output) {
+        ASSERT_EQ(curout.iterations.size(), curout.times.size());
+        for (int i = 0; i < opt.iterations; ++i) {
+            EXPECT_EQ(curout.iterations[i], i);
+        }
+    }
+
+    auto comp = eztimer::compare_paired(output[0], output[1]);
+    EXPECT_EQ(comp.pairs, opt.iterations);
+    EXPECT_GT(comp.ratio, 1);
+}
+
+TEST(CompareDistributions, Same) {
+    auto first = tailed_timings(1000, 0, 0, 1);
+    auto second = tailed_timings(1000, 0, 0, 2);
+    auto comp = eztimer::compare_distributions(first, second);
+    EXPECT_LT(comp.ks_statistic, 0.1);
+    EXPECT_GT(comp.ks_pvalue, 0.01);
+    EXPECT_FALSE(comp.different);
+    EXPECT_FALSE(comp.tail_regression);
+
+    ASSERT_EQ(comp.shifts.size(), 11);
+    for (const auto& shift : comp.shifts) {
+        EXPECT_LE(shift.lower, shift.difference);
+        EXPECT_GE(shift.upper, shift.difference);
+        EXPECT_LT(std::abs(shift.difference.count()), 0.02);
+    }
+}
+
+TEST(CompareDistributions, TailRegression) {
+    // Median is unchanged but the tail is fattened.
+    auto first = tailed_timings(2000, 0, 0, 1);
+    auto second = tailed_timings(2000, 0.08, 2, 2);
+    auto comp = eztimer::compare_distributions(first, second);
+    EXPECT_TRUE(comp.tail_regression);
+
+    const auto& median = comp.shifts[4];
+    EXPECT_EQ(median.quantile, 0.5);
+    EXPECT_LT(std::abs(median.difference.count()), 0.02);
+
+    const auto& p99 = comp.shifts.back();
+    EXPECT_EQ(p99.quantile, 0.99);
+    EXPECT_GT(p99.difference.count(), 0.5);
+    EXPECT_TRUE(p99.significant);
+
+    // Flipping it around is an improvement, not a regression.
+    auto flipped = eztimer::compare_distributions(second, first);
+    EXPECT_FALSE(flipped.tail_regression);
+    EXPECT_LT(flipped.shifts.back().difference.count(), -0.5);
+}
+
+TEST(CompareDistributions, KolmogorovSmirnov) {
+    auto first = mock_timings({ 1, 2, 3, 4 });
+    auto second = mock_timings({ 3, 4, 5, 6 });
+    auto comp = eztimer::compare_distributions(first, second);
+    EXPECT_DOUBLE_EQ(comp.ks_statistic, 0.5);
+
+    auto shifted = tailed_timings(500, 0, 0, 1);
+    for (auto& t : shifted.times) {
+        t *= 1.2;
+    }
+    auto comp2 = eztimer::compare_distributions(tailed_timings(500, 0, 0, 2), shifted);
+    EXPECT_GT(comp2.ks_statistic, 0.9);
+    EXPECT_LT(comp2.ks_pvalue, 1e-10);
+    EXPECT_TRUE(comp2.different);
+}
+
+TEST(CompareDistributions, Empty) {
+    auto comp = eztimer::compare_distributions(mock_timings({}), mock_timings({ 1 }));
+    EXPECT_TRUE(std::isnan(comp.ks_statistic));
+    EXPECT_TRUE(comp.shifts.empty());
+
+    eztimer::DistributionOptions opt;
+    opt.bootstrap = 0;
+    auto comp2 = eztimer::compare_distributions(mock_timings({ 1, 2 }), mock_timings({ 2, 3 }), opt);
+    ASSERT_EQ(comp2.shifts.size(), opt.quantiles.size());
+    EXPECT_DOUBLE_EQ(comp2.shifts[4].difference.count(), 1);
+    EXPECT_TRUE(std::isnan(comp2.shifts[4].lower.count()));
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/console.hpp"
+#include "utils.hpp"
+
+#include <random>
+#include <sstream>
+
+static std::vector<std::string> split_lines(const std::string& text) {
+    std::vector<std::string> output;
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        output.push_back(line);
+    }
+    return output;
+}
+
+TEST(Console, DisplayWidth) {
+    EXPECT_EQ(eztimer::internal::display_width("abc"), 3);
+    EXPECT_EQ(eztimer::internal::display_width("3.00 µs"), 7);
+    EXPECT_EQ(eztimer::internal::display_width("▁▂█"), 3);
+}
+
+TEST(Console, Sparkline) {
+    std::vector<double> values { 1, 1, 1, 1, 10, 100 };
+    EXPECT_EQ(eztimer::internal::sparkline(values, 0, 2, 4, false), "@ --");
+    EXPECT_EQ(eztimer::internal::sparkline(values, 0, 2, 4, true), "█ ▃▃");
+    EXPECT_EQ(eztimer::internal::sparkline({ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 100 }, 0, 2, 2, false), "@."); // outliers are still visible.
+
+    // All values in a single bin if the range is empty.
+    EXPECT_EQ(eztimer::internal::sparkline({ 1, 1 }, 0, 0, 3, false), "@  ");
+}
+
+TEST(Console, Basic) {
+    std::vector<eztimer::Timings> timings { lognormal_timings(200, 1e-3, 0.1, 1), lognormal_timings(200, 5e-4, 0.1, 2), lognormal_timings(200, 2e-3, 0.1, 3), lognormal_timings(200, 1e-3, 0.1, 4) };
+
+    eztimer::ConsoleOptions opt;
+    opt.names = { "baseline_impl", "fast", "slow", "same" };
+    opt.colour = false;
+
+    std::stringstream out;
+    eztimer::write_console_report(out, timings, opt);
+    auto lines = split_lines(out.str());
+    ASSERT_GE(lines.size(), 5);
+
+    // All rows are aligned up to the histogram.
+    const auto header_width = eztimer::internal::display_width(lines[0].substr(0, lines[0].find("    Histogram")));
+    EXPECT_EQ(lines[0].rfind("Function", 0), 0);
+    for (std::size_t r = 1; r <= 4; ++r) {
+        const auto& line = lines[r];
+        EXPECT_EQ(line.rfind(opt.names[r - 1], 0), 0);
+        EXPECT_EQ(eztimer::internal::display_width(line.substr(0, line.find("│"))), header_width + 4);
+    }
+
+    // Durations use the shared formatter.
+    for (std::size_t r = 1; r <= 4; ++r) {
+        EXPECT_NE(lines[r].find(eztimer::internal::format_duration(timings[r - 1].mean.count(), 3, true)), std::string::npos);
+    }
+
+    EXPECT_NE(lines[1].find("baseline"), std::string::npos);
+    EXPECT_NE(lines[2].find("2.0"), std::string::npos);
+    EXPECT_NE(lines[2].find("▲"), std::string::npos);
+    EXPECT_NE(lines[3].find("0.5"), std::string::npos);
+    EXPECT_NE(lines[3].find("▼"), std::string::npos);
+    EXPECT_NE(lines[4].find("≈"), std::string::npos);
+    EXPECT_EQ(out.str().find("\033["), std::string::npos);
+}
+
+TEST(Console, Options) {
+    std::vector<eztimer::Timings> timings { lognormal_timings(50, 1e-3, 0.1, 1), lognormal_timings(50, 5e-4, 0.1, 2) };
+
+    eztimer::ConsoleOptions opt;
+    opt.colour = true;
+    opt.unicode = false;
+    opt.bins = 0;
+    opt.baseline = 1;
+
+    std::stringstream out;
+    eztimer::write_console_report(out, timings, opt);
+    auto contents = out.str();
+    EXPECT_NE(contents.find("\033[31m-\033[0m"), std::string::npos); // the first function is slower than the baseline.
+    EXPECT_EQ(contents.find("Histogram"), std::string::npos);
+    for (auto c : contents) {
+        EXPECT_EQ(static_cast<unsigned char>(c) & 0x80, 0);
+    }
+
+    // No colour when writing to a non-terminal stream.
+    opt.colour.reset();
+    std::stringstream plain;
+    eztimer::write_console_report(plain, timings, opt);
+    EXPECT_EQ(plain.str().find("\033["), std::string::npos);
+}
+
+TEST(Console, Errors) {
+    std::vector<eztimer::Timings> timings { lognormal_timings(10, 1e-3, 0.1, 1) };
+    std::stringstream out;
+
+    eztimer::ConsoleOptions opt;
+    opt.names = { "a", "b" };
+    EXPECT_ANY_THROW(eztimer::write_console_report(out, timings, opt));
+
+    opt.names.clear();
+    opt.baseline = 2;
+    EXPECT_ANY_THROW(eztimer::write_console_report(out, timings, opt));
+
+    // Empty timings are handled gracefully.
+    std::vector<eztimer::Timings> empty(2);
+    opt.baseline = 0;
+    eztimer::write_console_report(out, empty, opt);
+    EXPECT_NE(out.str().find("-"), std::string::npos);
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/environment_sweep.hpp"
+
+#include <sstream>
+
+TEST(EnvironmentSweep, Basic) {
+    eztimer::Command command;
+    command.arguments = std::vector<std::string>{ EZTIMER_TEST_CHILD, "0", "foo", "-", "bar", "0.5" };
+    command.environment.emplace_back("EZTIMER_TEST_SLEEP", "1000"); // replaced by the grid.
+
+    std::vector<std::pair<std::string, std::vector<std::string> > > grid;
+    grid.emplace_back("EZTIMER_TEST_SLEEP", std::vector<std::string>{ "20", "1", "10" });
+    grid.emplace_back("EZTIMER_TEST_FAIL", std::vector<std::string>{ "0", "2" });
+
+    eztimer::ProcessOptions opt;
+    opt.timing.iterations = 2;
+    auto output = eztimer::sweep_environment(command, grid, opt);
+
+    EXPECT_EQ(output.variables, std::vector<std::string>({ "EZTIMER_TEST_SLEEP", "EZTIMER_TEST_FAIL" }));
+    ASSERT_EQ(output.settings.size(), 6);
+    EXPECT_EQ(output.settings[0], std::vector<std::string>({ "20", "0" }));
+    EXPECT_EQ(output.settings[1], std::vector<std::string>({ "1", "0" }));
+    EXPECT_EQ(output.settings[5], std::vector<std::string>({ "10", "2" }));
+
+    EXPECT_EQ(output.functions, std::vector<std::string>({ "foo", "bar" }));
+    ASSERT_EQ(output.timings.size(), 6);
+    for (std::size_t s = 0; s < 6; ++s) {
+        EXPECT_DOUBLE_EQ(output.timings[s][0].mean.count(), std::stoi(output.settings[s][0]) / 1000.0);
+        EXPECT_DOUBLE_EQ(output.timings[s][1].mean.count(), 0.5);
+    }
+
+    ASSERT_EQ(output.best.size(), 2);
+    EXPECT_EQ(output.settings[output.best[0]][0], "1");
+    EXPECT_EQ(output.best[1], 0); // all ties, so the first is chosen.
+    EXPECT_EQ(output.settings[output.best_process][0], "1");
+
+    std::stringstream stream;
+    eztimer::write_environment_sweep(stream, output);
+    std::string line;
+    std::getline(stream, line);
+    EXPECT_EQ(line, "EZTIMER_TEST_SLEEP,EZTIMER_TEST_FAIL,function,iterations,mean,sd");
+    std::getline(stream, line);
+    EXPECT_EQ(line.rfind("20,0,,2,", 0), 0);
+    std::getline(stream, line);
+    EXPECT_EQ(line.rfind("20,0,foo,2,0.02,0", 0), 0);
+
+    std::size_t nlines = 3;
+    while (std::getline(stream, line)) {
+        ++nlines;
+    }
+    EXPECT_EQ(nlines, 1 + 6 * 3);
+}
+
+TEST(EnvironmentSweep, Escape) {
+    EXPECT_EQ(eztimer::internal::escape_csv("foo"), "foo");
+    EXPECT_EQ(eztimer::internal::escape_csv("foo,bar"), "\"foo,bar\"");
+    EXPECT_EQ(eztimer::internal::escape_csv("foo\"bar"), "\"foo\"\"bar\"");
+}
@@ -89,3 +89,104 @@ TEST_F(EztimerTest, CapTotal) {
     // Should be >= 2, but again, the macos runner is a bit too relaxed with its timings.
     EXPECT_GE(num_tasks, 1);
 }
+
+TEST_F(EztimerTest, Counters) {
+    eztimer::Options opt;
+    opt.counters = std::vector<eztimer::Counter>{ eztimer::Counter::CYCLES, eztimer::Counter::CONTEXT_SWITCHES };
+    auto output = eztimer::time(funs, check, opt);
+
+    eztimer::CounterSet counters(opt.counters);
+    for (const auto& curout : output) {
+        ASSERT_EQ(curout.counters.size(), opt.counters.size());
+        for (std::size_t c = 0; c < opt.counters.size(); ++c) {
+            if (counters.available(c)) {
+                EXPECT_EQ(curout.counters[c].size(), curout.times.size());
+            } else {
+                EXPECT_TRUE(curout.counters[c].empty());
+            }
+        }
+    }
+}
+
+TEST_F(EztimerTest, RecordCpu) {
+    eztimer::Options opt;
+    opt.iterations = 3;
+    auto output = eztimer::time(funs, check, opt);
+    for (const auto& curout : output) {
+        EXPECT_TRUE(curout.cpus.empty());
+    }
+
+    opt.record_cpu = true;
+    output = eztimer::time(funs, check, opt);
+    for (const auto& curout : output) {
+        ASSERT_EQ(curout.cpus.size(), curout.times.size());
+        for (auto cpu : curout.cpus) {
+#ifdef __linux__
+            EXPECT_GE(cpu, 0);
+#else
+            EXPECT_EQ(cpu, -1);
+#endif
+        }
+    }
+}
+
+TEST(Eztimer, TailCapture) {
+    std::vector<std::function<int()> > funs;
+    int counter = 0;
+    funs.emplace_back([&]() -> int {
+        ++counter;
+        // Every 10th call is slow.
+        std::this_thread::sleep_for(std::chrono::microseconds(counter % 10 == 0 ? 5000 : 100));
+        return 0;
+    });
+
+    eztimer::Options opt;
+    opt.iterations = 100;
+    opt.counters = std::vector<eztimer::Counter>{ eztimer::Counter::CONTEXT_SWITCHES };
+    opt.tail_capture = eztimer::TailCaptureOptions();
+    opt.tail_capture->quantile = 0.8;
+    opt.tail_capture->min_calls = 20;
+    opt.tail_capture->max_outliers = 5;
+    opt.tail_capture->sample_stack = true;
+
+    auto output = eztimer::time<int>(funs, [](const int&, std::size_t) -> void {}, opt);
+    const auto& outliers = output[0].outliers;
+    EXPECT_EQ(outliers.size(), 5);
+
+    for (std::size_t o = 0; o < outliers.size(); ++o) {
+        const auto& out = outliers[o];
+        if (o) {
+            EXPECT_GT(out.index, outliers[o - 1].index);
+        }
+        EXPECT_GE(out.index, 19);
+        EXPECT_EQ(out.time, output[0].times[out.index]);
+        EXPECT_EQ(out.iteration, output[0].iterations[out.index]);
+        EXPECT_GT(out.time, out.threshold);
+        EXPECT_GT(out.time.count(), 0.004);
+        EXPECT_EQ(out.counters.size(), 1);
+        EXPECT_GE(out.voluntary_switches, 0);
+#ifdef __linux__
+        EXPECT_GE(out.cpu, 0);
+#endif
+#ifdef EZTIMER_HAS_STACK_SAMPLING
+        EXPECT_EQ(out.stack.size(), 1);
+#endif
+    }
+}
+
+TEST(Eztimer, RunningQuantile) {
+    eztimer::internal::RunningQuantile quant(0.9);
+    EXPECT_EQ(quant.estimate(), 0);
+    quant.add(5);
+    quant.add(1);
+    quant.add(3);
+    EXPECT_EQ(quant.count(), 3);
+    EXPECT_EQ(quant.estimate(), 5);
+
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> dist;
+    for (int i = 0; i < 10000; ++i) {
+        quant.add(dist(rng));
+    }
+    EXPECT_NEAR(quant.estimate(), 0.9, 0.02);
+}
@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/fingerprint.hpp"
+
+TEST(Fingerprint, Basic) {
+    auto fp = eztimer::machine_fingerprint();
+    EXPECT_FALSE(fp.hostname.empty());
+    EXPECT_FALSE(fp.os.empty());
+    EXPECT_GT(fp.memory, 0);
+
+    auto id = eztimer::fingerprint_id(fp);
+    EXPECT_EQ(id.size(), 16);
+    EXPECT_EQ(id, eztimer::fingerprint_id(eztimer::machine_fingerprint()));
+
+    // Any change gives a different identifier.
+    auto alt = fp;
+    alt.cpus += 1;
+    EXPECT_NE(id, eztimer::fingerprint_id(alt));
+
+    auto alt2 = fp;
+    alt2.hostname += "x";
+    EXPECT_NE(id, eztimer::fingerprint_id(alt2));
+
+    // Fields do not run into each other.
+    eztimer::Fingerprint left, right;
+    left.hostname = "ab";
+    right.hostname = "a";
+    right.cpu_model = "b";
+    EXPECT_NE(eztimer::fingerprint_id(left), eztimer::fingerprint_id(right));
+}
@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/format.hpp"
+
+#include <limits>
+
+TEST(Format, Duration) {
+    EXPECT_EQ(eztimer::internal::format_duration(2.5, 3, true), "2.50 s");
+    EXPECT_EQ(eztimer::internal::format_duration(0.0125, 3, true), "12.5 ms");
+    EXPECT_EQ(eztimer::internal::format_duration(3e-6, 3, true), "3.00 µs");
+    EXPECT_EQ(eztimer::internal::format_duration(3e-6, 3, false), "3.00 us");
+    EXPECT_EQ(eztimer::internal::format_duration(4.5e-7, 3, true), "450 ns");
+
+    // Units are chosen after rounding.
+    EXPECT_EQ(eztimer::internal::format_duration(9.996e-7, 3, true), "1.00 µs");
+    EXPECT_EQ(eztimer::internal::format_duration(0.99996, 4), "1.000 s");
+    EXPECT_EQ(eztimer::internal::format_duration(9.994e-7, 3), "999 ns");
+    EXPECT_EQ(eztimer::internal::format_duration(1234.5, 3), "1235 s");
+    EXPECT_EQ(eztimer::internal::format_duration(0, 3), "0.00 ns");
+    EXPECT_EQ(eztimer::internal::format_duration(1e-5, 1), "10 us");
+    EXPECT_EQ(eztimer::internal::format_duration(std::numeric_limits<double>::quiet_NaN(), 3, true), "-");
+}
+
+TEST(Format, ReportPrecision) {
+    // As used in the HTML tables and tooltips, and by eztimer-history.
+    EXPECT_EQ(eztimer::internal::format_duration(2.5, 4), "2.500 s");
+    EXPECT_EQ(eztimer::internal::format_duration(0.0125, 4), "12.50 ms");
+    EXPECT_EQ(eztimer::internal::format_duration(3e-6, 4), "3.000 us");
+    EXPECT_EQ(eztimer::internal::format_duration(4.5e-8, 4), "45.00 ns");
+
+    // As used in the HTML axis ticks, which are powers of 10.
+    EXPECT_EQ(eztimer::internal::format_duration(1e-7, 1), "100 ns");
+    EXPECT_EQ(eztimer::internal::format_duration(1e-6, 1), "1 us");
+    EXPECT_EQ(eztimer::internal::format_duration(1e-2, 1), "10 ms");
+    EXPECT_EQ(eztimer::internal::format_duration(10, 1), "10 s");
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/html.hpp"
+#include "utils.hpp"
+
+#include <random>
+#include <sstream>
+
+TEST(Html, Downsample) {
+    eztimer::Timings timings;
+    for (int i = 0; i < 10; ++i) {
+        timings.times.emplace_back(i + 1);
+        timings.iterations.push_back(i + 5);
+    }
+
+    auto full = eztimer::internal::downsample(timings, 100);
+    ASSERT_EQ(full.mean.size(), 10);
+    EXPECT_EQ(full.iterations.front(), 5);
+    EXPECT_EQ(full.min, full.max);
+    EXPECT_EQ(full.min, full.mean);
+
+    auto reduced = eztimer::internal::downsample(timings, 3);
+    ASSERT_EQ(reduced.mean.size(), 3);
+    EXPECT_EQ(reduced.iterations, std::vector<int>({ 5, 8, 11 }));
+    EXPECT_EQ(reduced.min, std::vector<double>({ 1, 4, 7 }));
+    EXPECT_EQ(reduced.max, std::vector<double>({ 3, 6, 10 }));
+    EXPECT_DOUBLE_EQ(reduced.mean[0], 2);
+    EXPECT_DOUBLE_EQ(reduced.mean[2], 8.5);
+
+    // Falling back to the position if there are no iterations.
+    timings.iterations.clear();
+    auto positional = eztimer::internal::downsample(timings, 5);
+    EXPECT_EQ(positional.iterations, std::vector<int>({ 0, 2, 4, 6, 8 }));
+
+    EXPECT_TRUE(eztimer::internal::downsample(eztimer::Timings(), 10).mean.empty());
+}
+
+TEST(Html, Basic) {
+    std::vector<eztimer::Timings> timings { lognormal_timings(100, 1e-3, 0.1, 1), lognormal_timings(100, 5e-4, 0.1, 2), lognormal_timings(100, 1e-3, 0.1, 3) };
+
+    eztimer::HtmlReportOptions opt;
+    opt.title = "Sorting <benchmarks>";
+    opt.names = { "std::sort", "radix & friends", "heap" };
+    eztimer::MachineProfile profile;
+    profile.copy_bandwidth = 123456;
+    opt.profile = profile;
+
+    std::stringstream out;
+    eztimer::write_html_report(out, timings, opt);
+    auto contents = out.str();
+
+    EXPECT_EQ(contents.rfind("<!DOCTYPE html>", 0), 0);
+
+    // Summary tables use the shared duration formatter.
+    EXPECT_NE(contents.find("<td>" + eztimer::internal::format_duration(timings[1].mean.count(), 4) + "</td>"), std::string::npos);
+    EXPECT_NE(contents.find("<td>" + eztimer::internal::format_duration(timings[1].sd.count(), 4) + "</td>"), std::string::npos);
+    EXPECT_NE(contents.find("</html>"), std::string::npos);
+    EXPECT_NE(contents.find("<title>Sorting &lt;benchmarks&gt;</title>"), std::string::npos);
+    EXPECT_NE(contents.find("radix &amp; friends"), std::string::npos);
+
+    // No external assets.
+    EXPECT_EQ(contents.find("<script"), std::string::npos);
+    EXPECT_EQ(contents.find("<link"), std::string::npos);
+    EXPECT_EQ(contents.find("src="), std::string::npos);
+
+    EXPECT_NE(contents.find("<h2>Distributions</h2>"), std::string::npos);
+    EXPECT_NE(contents.find("<h2>Time series</h2>"), std::string::npos);
+    EXPECT_NE(contents.find("<h2>Speedups</h2>"), std::string::npos);
+    EXPECT_NE(contents.find("<h2>Environment</h2>"), std::string::npos);
+    EXPECT_NE(contents.find(eztimer::fingerprint_id(eztimer::machine_fingerprint())), std::string::npos);
+    EXPECT_NE(contents.find("copy_bandwidth\t123456"), std::string::npos);
+    EXPECT_EQ(contents.find("<h2>Roofline</h2>"), std::string::npos);
+
+    // The second function is twice as fast, which should be significant.
+    EXPECT_NE(contents.find("<tr class=\"significant\"><td>radix &amp; friends</td>"), std::string::npos);
+    auto start = contents.find("<h2>Speedups</h2>");
+    auto speedups = contents.substr(start, contents.find("</table>", start) - start);
+    EXPECT_EQ(speedups.find("<td>std::sort</td>"), std::string::npos); // baseline is not in its own table.
+    EXPECT_NE(speedups.find("<td>heap</td>"), std::string::npos);
+}
+
+TEST(Html, Roofline) {
+    std::vector<eztimer::Timings> timings { lognormal_timings(10, 1e-3, 0.1, 1) };
+
+    eztimer::HtmlReportOptions opt;
+    opt.names = { "axpy" };
+    eztimer::RooflineOptions ropt;
+    ropt.peak_flops = 1e10;
+    ropt.peak_bandwidth = 1e9;
+    opt.roofline = eztimer::roofline(timings, { eztimer::RooflineWork{ 1e6, 1e6 } }, ropt);
+
+    std::stringstream out;
+    eztimer::write_html_report(out, timings, opt);
+    auto contents = out.str();
+    EXPECT_NE(contents.find("<h2>Roofline</h2>"), std::string::npos);
+    EXPECT_NE(contents.find(">axpy</text>"), std::string::npos);
+    EXPECT_EQ(contents.find("<h2>Speedups</h2>"), std::string::npos);
+}
+
+TEST(Html, Large) {
+    std::vector<eztimer::Timings> timings { lognormal_timings(1000000, 1e-6, 0.1, 1), lognormal_timings(1000000, 2e-6, 0.1, 2) };
+
+    eztimer::HtmlReportOptions opt;
+    opt.max_points = 200;
+    std::stringstream out;
+    eztimer::write_html_report(out, timings, opt);
+
+    // The size of the report is independent of the number of timings.
+    EXPECT_LT(out.str().size(), 100000);
+}
+
+TEST(Html, Errors) {
+    std::vector<eztimer::Timings> timings { lognormal_timings(10, 1e-3, 0.1, 1) };
+    std::stringstream out;
+
+    eztimer::HtmlReportOptions opt;
+    opt.names = { "a", "b" };
+    EXPECT_ANY_THROW(eztimer::write_html_report(out, timings, opt));
+
+    opt.names.clear();
+    opt.baseline = 1;
+    EXPECT_ANY_THROW(eztimer::write_html_report(out, timings, opt));
+}
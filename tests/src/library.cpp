@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/library.hpp"
+#include "eztimer/compare.hpp"
+
+TEST(SharedLibrary, Basic) {
+    eztimer::SharedLibrary lib1(EZTIMER_TEST_LIBRARY_V1);
+    EXPECT_EQ(lib1.path(), EZTIMER_TEST_LIBRARY_V1);
+    auto fun1 = lib1.function<int>("eztimer_test_entry");
+    EXPECT_EQ(fun1(), 1);
+
+    eztimer::SharedLibrary lib2(EZTIMER_TEST_LIBRARY_V2);
+    auto fun2 = lib2.function<int>("eztimer_test_entry");
+    EXPECT_EQ(fun2(), 2);
+
+    // First library is still resolving its own symbols.
+    EXPECT_EQ(fun1(), 1);
+}
+
+TEST(SharedLibrary, Errors) {
+    EXPECT_ANY_THROW(eztimer::SharedLibrary("./does_not_exist.so"));
+
+    eztimer::SharedLibrary lib(EZTIMER_TEST_LIBRARY_V1);
+    EXPECT_ANY_THROW(lib.symbol("this_symbol_does_not_exist"));
+}
+
+TEST(SharedLibrary, Timing) {
+    std::function<int()> fun;
+    {
+        // Functions keep the library alive after it goes out of scope.
+        auto funs = eztimer::load_functions<int>({ EZTIMER_TEST_LIBRARY_V1, EZTIMER_TEST_LIBRARY_V2 }, "eztimer_test_entry");
+        ASSERT_EQ(funs.size(), 2);
+
+        eztimer::Options opt;
+        auto output = eztimer::time<int>(
+            funs,
+            [](const int& res, std::size_t i) -> void {
+                EXPECT_EQ(res, static_cast<int>(i + 1));
+            },
+            opt
+        );
+
+        auto comp = eztimer::compare_paired(output[0], output[1]);
+        EXPECT_EQ(comp.pairs, opt.iterations);
+        EXPECT_GT(comp.ratio, 0);
+        fun = funs[0];
+    }
+    EXPECT_EQ(fun(), 1);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/linear.hpp"
+
+TEST(Linear, Fit) {
+    eztimer::LinearTimings lt;
+    for (int i = 1; i <= 20; ++i) {
+        lt.batch_sizes.push_back(i);
+        const double noise = (i % 2 ? 1e-3 : -1e-3);
+        lt.timings.times.emplace_back(0.5 + 2 * i + noise);
+    }
+    // Adding an outlier that only affects the OLS fit.
+    lt.batch_sizes.push_back(10);
+    lt.timings.times.emplace_back(100);
+
+    eztimer::internal::fit_linear(lt, 0.95);
+    EXPECT_NEAR(lt.theil_sen_slope.count(), 2, 1e-3);
+    EXPECT_NEAR(lt.theil_sen_intercept.count(), 0.5, 1e-2);
+    EXPECT_LT(lt.lower, lt.slope);
+    EXPECT_GT(lt.upper, lt.slope);
+    EXPECT_LT(lt.r_squared, 1);
+
+    // Without the outlier, everything is close to exact.
+    lt.batch_sizes.pop_back();
+    lt.timings.times.pop_back();
+    eztimer::internal::fit_linear(lt, 0.95);
+    EXPECT_NEAR(lt.slope.count(), 2, 1e-3);
+    EXPECT_NEAR(lt.intercept.count(), 0.5, 1e-2);
+    EXPECT_GT(lt.r_squared, 0.999);
+    EXPECT_LT(lt.lower.count(), 2);
+    EXPECT_GT(lt.upper.count(), 2);
+}
+
+TEST(Linear, Degenerate) {
+    eztimer::LinearTimings lt;
+    eztimer::internal::fit_linear(lt, 0.95);
+    EXPECT_TRUE(std::isnan(lt.slope.count()));
+
+    lt.batch_sizes = std::vector<int>{ 1, 1 };
+    lt.timings.times.emplace_back(1);
+    lt.timings.times.emplace_back(2);
+    eztimer::internal::fit_linear(lt, 0.95);
+    EXPECT_TRUE(std::isnan(lt.slope.count()));
+
+    lt.batch_sizes = std::vector<int>{ 1, 2 };
+    eztimer::internal::fit_linear(lt, 0.95);
+    EXPECT_DOUBLE_EQ(lt.slope.count(), 1);
+    EXPECT_TRUE(std::isnan(lt.lower.count())); // not enough degrees of freedom.
+}
+
+TEST(Linear, Timing) {
+    std::vector<int> calls(2);
+    std::vector<std::function<int()> > funs;
+    funs.emplace_back([&]() -> int {
+        ++calls[0];
+        return 0;
+    });
+    funs.emplace_back([&]() -> int {
+        ++calls[1];
+        volatile double sum = 0;
+        for (int i = 0; i < 1000; ++i) {
+            sum = sum + i;
+        }
+        return 1;
+    });
+
+    int checked = 0;
+    int setups = 0;
+    eztimer::LinearOptions opt;
+    opt.step = 2;
+    opt.timing.iterations = 20;
+    opt.timing.setup = [&]() -> void { ++setups; };
+    auto output = eztimer::time_linear<int>(
+        funs,
+        [&](const int& res, std::size_t i) -> void {
+            EXPECT_EQ(res, static_cast<int>(i));
+            ++checked;
+        },
+        opt
+    );
+
+    EXPECT_EQ(setups, opt.timing.iterations + opt.timing.burn_in);
+    EXPECT_EQ(checked, opt.timing.iterations * 2);
+    const int expected_calls = opt.timing.burn_in * opt.step + opt.step * opt.timing.iterations * (opt.timing.iterations + 1) / 2;
+    EXPECT_EQ(calls[0], expected_calls);
+    EXPECT_EQ(calls[1], expected_calls);
+
+    ASSERT_EQ(output.size(), 2);
+    for (const auto& curout : output) {
+        ASSERT_EQ(curout.batch_sizes.size(), opt.timing.iterations);
+        for (int i = 0; i < opt.timing.iterations; ++i) {
+            EXPECT_EQ(curout.batch_sizes[i], (i + 1) * opt.step);
+        }
+        EXPECT_FALSE(std::isnan(curout.slope.count()));
+        EXPECT_FALSE(std::isnan(curout.theil_sen_slope.count()));
+    }
+    EXPECT_GT(output[1].theil_sen_slope, output[0].theil_sen_slope);
+}
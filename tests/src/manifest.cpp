@@ -0,0 +1,363 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/manifest.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <numeric>
+
+static eztimer::Manifest parse_string(const std::string& contents) {
+    std::istringstream in(contents);
+    return eztimer::parse_manifest(in);
+}
+
+static std::string slurp(const std::filesystem::path& path) {
+    std::ifstream handle(path);
+    std::stringstream buffer;
+    buffer << handle.rdbuf();
+    return buffer.str();
+}
+
+static eztimer::BenchmarkRegistry mock_registry() {
+    eztimer::BenchmarkRegistry registry;
+    registry.add<long long>(
+        "sum",
+        [](const eztimer::BenchmarkParameters& params) -> std::function<long long()> {
+            auto n = params.get_integer("n");
+            auto step = params.get_integer("step", 1);
+            return [n, step]() -> long long {
+                long long total = 0;
+                for (long long i = 0; i < n; i += step) {
+                    total += i;
+                }
+                return total;
+            };
+        },
+        [](const long long& x) -> void {
+            if (x < 0) {
+                throw std::runtime_error("negative sum");
+            }
+        }
+    );
+    registry.add<int>(
+        "constant",
+        [](const eztimer::BenchmarkParameters&) -> std::function<int()> {
+            return []() -> int { return 1; };
+        }
+    );
+    return registry;
+}
+
+TEST(Manifest, Parameters) {
+    eztimer::BenchmarkParameters params({ { "n", "100" }, { "x", "0.5" }, { "name", "foo" }, { "bad", "12abc" } });
+    EXPECT_TRUE(params.has("n"));
+    EXPECT_FALSE(params.has("m"));
+    EXPECT_EQ(params.get("name"), "foo");
+    EXPECT_EQ(params.get("m", "bar"), "bar");
+    EXPECT_EQ(params.get_integer("n"), 100);
+    EXPECT_EQ(params.get_number("x"), 0.5);
+    EXPECT_EQ(params.get_integer("m", 5), 5);
+    EXPECT_EQ(params.get_number("m", 1.5), 1.5);
+    EXPECT_ANY_THROW(params.get("m"));
+    EXPECT_ANY_THROW(params.get_integer("bad"));
+    EXPECT_ANY_THROW(params.get_number("name"));
+}
+
+TEST(Manifest, Registry) {
+    auto registry = mock_registry();
+    EXPECT_TRUE(registry.has("sum"));
+    EXPECT_FALSE(registry.has("product"));
+    EXPECT_EQ(registry.names(), std::vector<std::string>({ "constant", "sum" }));
+    EXPECT_ANY_THROW(registry.add<int>("constant", [](const eztimer::BenchmarkParameters&) -> std::function<int()> { return []() -> int { return 0; }; }));
+
+    eztimer::Options opt;
+    opt.iterations = 3;
+    std::vector<eztimer::BenchmarkParameters> settings {
+        eztimer::BenchmarkParameters(std::vector<std::pair<std::string, std::string> >{ { "n", "5" } }),
+        eztimer::BenchmarkParameters(std::vector<std::pair<std::string, std::string> >{ { "n", "50" } })
+    };
+    auto timings = registry.run("sum", settings, opt);
+    ASSERT_EQ(timings.size(), 2);
+    EXPECT_EQ(timings[0].times.size(), 3);
+    EXPECT_ANY_THROW(registry.run("product", settings, opt));
+
+    // Checks are applied to each result.
+    registry.add<long long>(
+        "failing",
+        [](const eztimer::BenchmarkParameters&) -> std::function<long long()> { return []() -> long long { return -1; }; },
+        [](const long long& x) -> void {
+            if (x < 0) {
+                throw std::runtime_error("negative");
+            }
+        }
+    );
+    EXPECT_ANY_THROW(registry.run("failing", settings, opt));
+}
+
+TEST(Manifest, Parse) {
+    auto manifest = parse_string(R"(
+# Comment.
+[benchmark big_sum]
+function = sum
+iterations = 7
+param.n = 10, 20, 30
+param.step = 1,2
+counters = cycles, page_faults
+
+; Another comment.
+[defaults]
+iterations = 3
+burn_in = 0
+seed = 42
+max_time_per_function = 0.5
+
+[benchmark constant]
+enabled = false
+record_cpu = yes
+
+[output]
+console = off
+csv = results.csv
+html = report-{benchmark}.html
+commit = abc123
+)");
+
+    EXPECT_EQ(manifest.defaults.iterations, 3);
+    EXPECT_EQ(manifest.defaults.burn_in, 0);
+    EXPECT_EQ(manifest.defaults.seed, 42);
+    EXPECT_EQ(manifest.defaults.max_time_per_function->count(), 0.5);
+    EXPECT_FALSE(manifest.defaults.max_time_total.has_value());
+
+    ASSERT_EQ(manifest.benchmarks.size(), 2);
+    const auto& first = manifest.benchmarks[0];
+    EXPECT_EQ(first.name, "big_sum");
+    EXPECT_EQ(first.function, "sum");
+    EXPECT_TRUE(first.enabled);
+    EXPECT_EQ(first.options.iterations, 7);
+    EXPECT_EQ(first.options.burn_in, 0); // defaults are applied even if they come later.
+    EXPECT_EQ(first.options.seed, 42);
+    EXPECT_EQ(first.options.counters, std::vector<eztimer::Counter>({ eztimer::Counter::CYCLES, eztimer::Counter::PAGE_FAULTS }));
+    ASSERT_EQ(first.parameters.size(), 2);
+    EXPECT_EQ(first.parameters[0].first, "n");
+    EXPECT_EQ(first.parameters[0].second, std::vector<std::string>({ "10", "20", "30" }));
+    EXPECT_EQ(first.parameters[1].first, "step");
+    EXPECT_EQ(first.parameters[1].second, std::vector<std::string>({ "1", "2" }));
+
+    const auto& second = manifest.benchmarks[1];
+    EXPECT_EQ(second.name, "constant");
+    EXPECT_EQ(second.function, "constant");
+    EXPECT_FALSE(second.enabled);
+    EXPECT_TRUE(second.options.record_cpu);
+    EXPECT_EQ(second.options.iterations, 3);
+    EXPECT_TRUE(second.parameters.empty());
+
+    const auto& outputs = manifest.outputs;
+    EXPECT_FALSE(outputs.console);
+    EXPECT_EQ(*(outputs.csv), "results.csv");
+    EXPECT_EQ(*(outputs.html), "report-{benchmark}.html");
+    EXPECT_FALSE(outputs.columnar.has_value());
+    EXPECT_FALSE(outputs.store.has_value());
+    EXPECT_EQ(outputs.commit, "abc123");
+}
+
+static std::string parse_error(const std::string& contents) {
+    try {
+        parse_string(contents);
+    } catch (std::exception& e) {
+        return e.what();
+    }
+    return "";
+}
+
+TEST(Manifest, ParseErrors) {
+    EXPECT_NE(parse_error("[defaults]\niterations = 3\nitertions = 5\n").find("line 3: unknown key 'itertions'"), std::string::npos);
+    EXPECT_NE(parse_error("\n[foo]\n").find("line 2: unknown section [foo]"), std::string::npos);
+    EXPECT_NE(parse_error("iterations = 3\n").find("line 1"), std::string::npos);
+    EXPECT_NE(parse_error("[defaults]\niterations\n").find("line 2"), std::string::npos);
+    EXPECT_NE(parse_error("[defaults]\niterations = many\n").find("should be a number"), std::string::npos);
+    EXPECT_NE(parse_error("[defaults]\niterations = -1\n").find("non-negative"), std::string::npos);
+    EXPECT_NE(parse_error("[defaults]\ncounters = cycles, bogus\n").find("unknown counter 'bogus'"), std::string::npos);
+    EXPECT_NE(parse_error("[output]\nconsole = maybe\n").find("boolean"), std::string::npos);
+    EXPECT_NE(parse_error("[benchmark a]\n[benchmark a]\n").find("line 2: duplicate"), std::string::npos);
+    EXPECT_NE(parse_error("[benchmark a]\nparam.n = ,\n").find("no values"), std::string::npos);
+    EXPECT_NE(parse_error("[benchmark ]\n").find("no name"), std::string::npos);
+    EXPECT_NE(parse_error("[defaults\n").find("unterminated"), std::string::npos);
+    EXPECT_ANY_THROW(eztimer::read_manifest("does-not-exist.ini"));
+}
+
+class ManifestRunTest : public ::testing::Test {
+protected:
+    std::filesystem::path dir;
+
+    void SetUp() {
+        dir = std::filesystem::temp_directory_path() / ("eztimer-manifest-" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+    }
+
+    void TearDown() {
+        std::filesystem::remove_all(dir);
+    }
+};
+
+TEST_F(ManifestRunTest, Basic) {
+    auto manifest = parse_string(R"(
+[defaults]
+iterations = 5
+
+[benchmark grid]
+function = sum
+param.n = 100, 1000
+param.step = 1, 2, 3
+
+[benchmark constant]
+
+[benchmark disabled]
+function = constant
+enabled = false
+)");
+
+    auto& outputs = manifest.outputs;
+    outputs.csv = dir / "results.csv";
+    outputs.html = dir / "report-{benchmark}.html";
+    outputs.columnar = dir / "results.bin";
+    outputs.store = dir / "store";
+    outputs.commit = "deadbeef";
+
+    auto registry = mock_registry();
+    std::stringstream console;
+    auto results = eztimer::run_manifest(manifest, registry, {}, console);
+
+    ASSERT_EQ(results.size(), 2);
+    const auto& grid = results[0];
+    EXPECT_EQ(grid.benchmark, "grid");
+    ASSERT_EQ(grid.names.size(), 6);
+    EXPECT_EQ(grid.names[0], "grid[n=100,step=1]");
+    EXPECT_EQ(grid.names[1], "grid[n=1000,step=1]"); // first parameter changes fastest.
+    EXPECT_EQ(grid.names[5], "grid[n=1000,step=3]");
+    EXPECT_EQ(grid.settings[3].get_integer("step"), 2);
+    for (const auto& t : grid.timings) {
+        EXPECT_EQ(t.times.size(), 5);
+    }
+
+    const auto& constant = results[1];
+    EXPECT_EQ(constant.names, std::vector<std::string>({ "constant" }));
+    EXPECT_TRUE(constant.settings[0].values().empty());
+
+    auto printed = console.str();
+    EXPECT_NE(printed.find("== grid =="), std::string::npos);
+    EXPECT_NE(printed.find("grid[n=1000,step=3]"), std::string::npos);
+    EXPECT_NE(printed.find("== constant =="), std::string::npos);
+    EXPECT_EQ(printed.find("disabled"), std::string::npos);
+
+    auto csv = slurp(dir / "results.csv");
+    EXPECT_EQ(csv.rfind("benchmark,instance,parameters,runs,mean,sd\n", 0), 0);
+    EXPECT_NE(csv.find("grid,\"grid[n=100,step=1]\",n=100;step=1,5,"), std::string::npos);
+    EXPECT_NE(csv.find("constant,constant,,5,"), std::string::npos);
+
+    EXPECT_TRUE(std::filesystem::exists(dir / "report-grid.html"));
+    EXPECT_TRUE(std::filesystem::exists(dir / "report-constant.html"));
+    EXPECT_NE(slurp(dir / "report-grid.html").find("grid[n=1000,step=2]"), std::string::npos);
+
+    eztimer::ColumnarReader reader(dir / "results.bin");
+    ASSERT_EQ(reader.size(), 7);
+    EXPECT_EQ(reader.summary(6).name, "constant");
+    EXPECT_EQ(reader.metadata()[0], std::make_pair(std::string("commit"), std::string("deadbeef")));
+
+    eztimer::ResultsStore store(dir / "store");
+    auto stored = store.benchmarks();
+    EXPECT_EQ(stored.size(), 7);
+    EXPECT_NE(std::find(stored.begin(), stored.end(), "grid[n=100,step=3]"), stored.end());
+}
+
+TEST_F(ManifestRunTest, Profile) {
+    auto manifest = parse_string("[benchmark constant]\niterations = 2\n[output]\nconsole = false\nprofile = cache.tsv\n");
+    EXPECT_EQ(*(manifest.outputs.profile), "cache.tsv");
+
+    // Using a cached profile for the current machine, to avoid probing it.
+    eztimer::MachineProfile profile;
+    profile.fingerprint = eztimer::machine_fingerprint();
+    profile.copy_bandwidth = 1234;
+    manifest.outputs.profile = dir / "cache.tsv";
+    {
+        std::ofstream handle(*(manifest.outputs.profile));
+        eztimer::write_machine_profile(handle, profile);
+    }
+
+    manifest.outputs.html = dir / "report.html";
+    manifest.outputs.columnar = dir / "results.bin";
+    manifest.outputs.store = dir / "store";
+    auto registry = mock_registry();
+    eztimer::run_manifest(manifest, registry);
+
+    EXPECT_NE(slurp(dir / "report.html").find("Machine profile"), std::string::npos);
+    eztimer::ColumnarReader reader(dir / "results.bin");
+    ASSERT_TRUE(reader.profile().has_value());
+    EXPECT_EQ(reader.profile()->copy_bandwidth, 1234);
+    eztimer::ResultsStore store(dir / "store");
+    auto saved = store.profile(store.runs()[0].fingerprint);
+    ASSERT_TRUE(saved.has_value());
+    EXPECT_EQ(saved->copy_bandwidth, 1234);
+}
+
+TEST_F(ManifestRunTest, Selection) {
+    auto manifest = parse_string(R"(
+[defaults]
+iterations = 2
+
+[benchmark first]
+function = constant
+
+[benchmark second]
+function = constant
+enabled = false
+
+[benchmark missing]
+function = product
+enabled = false
+
+[output]
+console = false
+html = combined.html
+)");
+    manifest.outputs.html = dir / "combined.html";
+
+    auto registry = mock_registry();
+    std::stringstream console;
+    auto results = eztimer::run_manifest(manifest, registry, { "second" }, console);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0].benchmark, "second");
+    EXPECT_TRUE(console.str().empty());
+    EXPECT_TRUE(std::filesystem::exists(dir / "combined.html"));
+
+    EXPECT_ANY_THROW(eztimer::run_manifest(manifest, registry, { "third" }, console));
+    EXPECT_ANY_THROW(eztimer::run_manifest(manifest, registry, { "first", "missing" }, console)); // unregistered functions are caught before running.
+
+    // Errors in the parameters are propagated.
+    auto bad = parse_string("[benchmark sum]\nparam.n = lots\n[output]\nconsole = false\n");
+    EXPECT_ANY_THROW(eztimer::run_manifest(bad, registry, {}, console));
+}
+
+TEST_F(ManifestRunTest, Main) {
+    const auto path = dir / "manifest.ini";
+    {
+        std::ofstream handle(path);
+        handle << "[benchmark sum]\niterations = 2\nparam.n = 10\n[benchmark constant]\niterations = 2\n[output]\nconsole = false\ncsv = " << (dir / "out.csv").string() << "\n";
+    }
+
+    auto registry = mock_registry();
+    const std::string pstr = path.string();
+    const char* argv[] = { "bench", pstr.c_str(), "--only", "sum" };
+    EXPECT_EQ(eztimer::manifest_main(4, argv, registry), 0);
+    auto csv = slurp(dir / "out.csv");
+    EXPECT_NE(csv.find("sum[n=10]"), std::string::npos);
+    EXPECT_EQ(csv.find("constant"), std::string::npos);
+
+    const char* missing[] = { "bench" };
+    EXPECT_EQ(eztimer::manifest_main(1, missing, registry), 1);
+    const char* extra[] = { "bench", pstr.c_str(), "other" };
+    EXPECT_EQ(eztimer::manifest_main(3, extra, registry), 1);
+    const char* noonly[] = { "bench", pstr.c_str(), "--only" };
+    EXPECT_EQ(eztimer::manifest_main(3, noonly, registry), 1);
+}
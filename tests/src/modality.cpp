@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/modality.hpp"
+#include "utils.hpp"
+
+#include <random>
+#include <string>
+#include <algorithm>
+
+TEST(Modality, Unimodal) {
+    auto res = eztimer::detect_modes(mixture_timings({ 1e-3 }, { 1 }, 1000));
+    EXPECT_EQ(res.kde_modes, 1);
+    EXPECT_FALSE(res.multimodal);
+    EXPECT_TRUE(res.warning.empty());
+    ASSERT_FALSE(res.modes.empty());
+
+    double total = 0;
+    for (const auto& mode : res.modes) {
+        total += mode.weight;
+    }
+    EXPECT_NEAR(total, 1, 1e-8);
+}
+
+TEST(Modality, Bimodal) {
+    auto res = eztimer::detect_modes(mixture_timings({ 1e-3, 2e-3 }, { 0.7, 0.3 }, 2000));
+    EXPECT_EQ(res.kde_modes, 2);
+    EXPECT_TRUE(res.multimodal);
+    EXPECT_FALSE(res.warning.empty());
+
+    ASSERT_EQ(res.modes.size(), 2);
+    EXPECT_NEAR(res.modes[0].location.count(), 1e-3, 1e-4);
+    EXPECT_NEAR(res.modes[0].weight, 0.7, 0.05);
+    EXPECT_NEAR(res.modes[1].location.count(), 2e-3, 2e-4);
+    EXPECT_NEAR(res.modes[1].weight, 0.3, 0.05);
+    EXPECT_NEAR(res.modes[1].log_sd, 0.02, 0.005);
+}
+
+TEST(Modality, Trimodal) {
+    auto res = eztimer::detect_modes(mixture_timings({ 1, 2, 4 }, { 1, 1, 1 }, 3000));
+    EXPECT_EQ(res.kde_modes, 3);
+    EXPECT_TRUE(res.multimodal);
+    ASSERT_EQ(res.modes.size(), 3);
+    EXPECT_NEAR(res.modes[2].location.count(), 4, 0.2);
+}
+
+TEST(Modality, Sparse) {
+    // Few timings with an extreme value, such that some fitted components don't account for a single timing.
+    bool disagree = false;
+    for (int seed = 0; seed < 50; ++seed) {
+        auto timings = mixture_timings({ 1e-3, 1.5e-3, 3e-3 }, { 0.45, 0.45, 0.1 }, 12, seed);
+        timings.times.emplace_back(1);
+        auto res = eztimer::detect_modes(timings);
+
+        double total = 0;
+        for (const auto& mode : res.modes) {
+            total += mode.weight;
+        }
+        EXPECT_NEAR(total, 1, 1e-8);
+
+        // The warning should not report more modes than the density estimate.
+        if (res.multimodal) {
+            const auto nmodes = std::min(res.kde_modes, res.modes.size());
+            EXPECT_EQ(res.warning.find("timings have " + std::to_string(nmodes) + " modes"), 0);
+            disagree = disagree || res.kde_modes != res.modes.size();
+        }
+    }
+    EXPECT_TRUE(disagree);
+}
+
+TEST(Modality, Edge) {
+    eztimer::Timings empty;
+    auto res = eztimer::detect_modes(empty);
+    EXPECT_EQ(res.kde_modes, 0);
+    EXPECT_TRUE(res.modes.empty());
+
+    eztimer::Timings constant;
+    for (int i = 0; i < 10; ++i) {
+        constant.times.emplace_back(2);
+    }
+    auto res2 = eztimer::detect_modes(constant);
+    EXPECT_EQ(res2.kde_modes, 1);
+    ASSERT_EQ(res2.modes.size(), 1);
+    EXPECT_DOUBLE_EQ(res2.modes[0].location.count(), 2);
+    EXPECT_FALSE(res2.multimodal);
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/outliers.hpp"
+#include "utils.hpp"
+
+TEST(Outliers, Basic) {
+    // Q1 = 10, Q3 = 12, IQR = 2.
+    std::vector<double> times{ 10, 10, 10, 11, 11, 11, 12, 12, 12 };
+    times.push_back(1);   // low severe.
+    times.push_back(6.5); // low mild.
+    times.push_back(16);  // high mild.
+    times.push_back(100); // high severe.
+    auto summary = eztimer::classify_outliers(mock_timings(times));
+
+    EXPECT_EQ(summary.low_severe, 1);
+    EXPECT_EQ(summary.low_mild, 1);
+    EXPECT_EQ(summary.high_mild, 1);
+    EXPECT_EQ(summary.high_severe, 1);
+    EXPECT_DOUBLE_EQ(summary.proportion, 4.0 / 13);
+
+    EXPECT_DOUBLE_EQ(summary.low_severe_fence.count(), 4);
+    EXPECT_DOUBLE_EQ(summary.low_mild_fence.count(), 7);
+    EXPECT_DOUBLE_EQ(summary.high_mild_fence.count(), 15);
+    EXPECT_DOUBLE_EQ(summary.high_severe_fence.count(), 18);
+    EXPECT_DOUBLE_EQ(summary.median.count(), 11);
+
+    EXPECT_EQ(summary.effect, eztimer::OutlierEffect::SEVERE);
+    EXPECT_TRUE(summary.unreliable);
+    EXPECT_FALSE(summary.warning.empty());
+    EXPECT_GT(summary.variance_fraction, 0.9);
+
+    // Robust summaries only exclude the severe outliers.
+    EXPECT_NEAR(summary.robust_mean.count(), (99 + 6.5 + 16) / 11, 1e-8);
+    EXPECT_GT(summary.robust_sd.count(), 0);
+}
+
+TEST(Outliers, Clean) {
+    auto summary = eztimer::classify_outliers(mock_timings({ 1, 2, 3, 4, 5, 6 }));
+    EXPECT_EQ(summary.low_severe + summary.low_mild + summary.high_mild + summary.high_severe, 0);
+    EXPECT_EQ(summary.proportion, 0);
+    EXPECT_EQ(summary.variance_fraction, 0);
+    EXPECT_EQ(summary.effect, eztimer::OutlierEffect::UNAFFECTED);
+    EXPECT_FALSE(summary.unreliable);
+    EXPECT_TRUE(summary.warning.empty());
+    EXPECT_DOUBLE_EQ(summary.robust_mean.count(), 3.5);
+}
+
+TEST(Outliers, Empty) {
+    auto summary = eztimer::classify_outliers(mock_timings({}));
+    EXPECT_EQ(summary.proportion, 0);
+    EXPECT_EQ(summary.effect, eztimer::OutlierEffect::UNAFFECTED);
+
+    auto single = eztimer::classify_outliers(mock_timings({ 5 }));
+    EXPECT_EQ(single.robust_mean.count(), 5);
+    EXPECT_EQ(single.robust_sd.count(), 0);
+}
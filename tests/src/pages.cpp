@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/pages.hpp"
+
+#include <cstring>
+#include <numeric>
+
+TEST(PageBuffer, Allocation) {
+    for (auto pol : { eztimer::PagePolicy::SMALL, eztimer::PagePolicy::TRANSPARENT_HUGE, eztimer::PagePolicy::EXPLICIT_HUGE }) {
+        eztimer::PageBuffer buffer(10000, pol);
+        EXPECT_EQ(buffer.size(), 10000);
+        std::memset(buffer.data(), 1, buffer.size());
+        EXPECT_EQ(static_cast<unsigned char*>(buffer.data())[9999], 1);
+
+        if (pol == eztimer::PagePolicy::SMALL) {
+            EXPECT_EQ(buffer.policy(), pol);
+        } else if (buffer.policy() != eztimer::PagePolicy::SMALL) {
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.data()) % (2 * 1024 * 1024), 0);
+        }
+
+        // Checking that moves work correctly.
+        auto moved = std::move(buffer);
+        EXPECT_EQ(static_cast<unsigned char*>(moved.data())[0], 1);
+    }
+}
+
+TEST(PageBuffer, Fallback) {
+    // Explicit huge pages are usually not reserved, but if they are, we
+    // should get them; otherwise we should fall back to something usable.
+    eztimer::PageBuffer buffer(1, eztimer::PagePolicy::EXPLICIT_HUGE);
+    EXPECT_NE(buffer.data(), nullptr);
+    static_cast<unsigned char*>(buffer.data())[0] = 2;
+}
+
+TEST(PagePolicy, Timing) {
+    const std::size_t n = 100000;
+    std::vector<std::function<double(void*, std::size_t)> > funs;
+    funs.emplace_back([](void* ptr, std::size_t bytes) -> double {
+        const double* x = static_cast<const double*>(ptr);
+        return std::accumulate(x, x + bytes / sizeof(double), 0.0);
+    });
+
+    eztimer::PagePolicyOptions opt;
+    auto output = eztimer::time_page_policies<double>(
+        n * sizeof(double),
+        [](void* ptr, std::size_t bytes) -> void {
+            double* x = static_cast<double*>(ptr);
+            std::fill_n(x, bytes / sizeof(double), 1.0);
+        },
+        funs,
+        [&](const double& res, std::size_t i) -> void {
+            EXPECT_EQ(i, 0);
+            EXPECT_EQ(res, n);
+        },
+        opt
+    );
+
+    EXPECT_EQ(output.requested, opt.policies);
+    EXPECT_EQ(output.obtained.size(), opt.policies.size());
+    EXPECT_EQ(output.obtained[0], eztimer::PagePolicy::SMALL);
+
+    ASSERT_EQ(output.timings.size(), opt.policies.size());
+    ASSERT_EQ(output.relative.size(), opt.policies.size());
+    ASSERT_EQ(output.tlb_misses.size(), opt.policies.size());
+    for (std::size_t p = 0; p < opt.policies.size(); ++p) {
+        ASSERT_EQ(output.timings[p].size(), 1);
+        const auto& curout = output.timings[p][0];
+        EXPECT_EQ(curout.times.size(), opt.timing.iterations);
+        ASSERT_EQ(curout.counters.size(), 1);
+        if (output.tlb_misses[p][0].has_value()) {
+            EXPECT_EQ(curout.counters[0].size(), opt.timing.iterations);
+        } else {
+            EXPECT_TRUE(curout.counters[0].empty());
+        }
+        EXPECT_GT(output.relative[p][0], 0);
+    }
+    EXPECT_EQ(output.relative[0][0], 1);
+}
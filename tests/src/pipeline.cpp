@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/pipeline.hpp"
+
+#include <thread>
+
+TEST(SpscQueue, Basic) {
+    eztimer::internal::SpscQueue<int> queue(2);
+    EXPECT_EQ(queue.size(), 0);
+
+    int x = 1;
+    EXPECT_TRUE(queue.push(x));
+    x = 2;
+    EXPECT_TRUE(queue.push(x));
+    x = 3;
+    EXPECT_FALSE(queue.push(x));
+    EXPECT_EQ(queue.size(), 2);
+
+    int y;
+    EXPECT_TRUE(queue.pop(y));
+    EXPECT_EQ(y, 1);
+    EXPECT_TRUE(queue.push(x));
+    EXPECT_TRUE(queue.pop(y));
+    EXPECT_EQ(y, 2);
+    EXPECT_TRUE(queue.pop(y));
+    EXPECT_EQ(y, 3);
+    EXPECT_FALSE(queue.pop(y));
+    EXPECT_EQ(queue.size(), 0);
+}
+
+TEST(SpscQueue, Threaded) {
+    eztimer::internal::SpscQueue<int> queue(4);
+    const int n = 10000;
+    std::thread producer([&]() -> void {
+        for (int i = 0; i < n; ++i) {
+            int x = i;
+            while (!queue.push(x)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (int i = 0; i < n; ++i) {
+        int y;
+        while (!queue.pop(y)) {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(y, i);
+    }
+    producer.join();
+}
+
+TEST(Pipeline, Basic) {
+    std::vector<std::function<void(double&)> > stages;
+    stages.emplace_back([](double& x) -> void { x += 1; });
+    stages.emplace_back([](double& x) -> void {
+        // Making this stage the obvious bottleneck.
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        x *= 2;
+    });
+    stages.emplace_back([](double& x) -> void { x -= 1; });
+
+    eztimer::PipelineOptions opt;
+    opt.num_items = 200;
+    opt.queue_depths = std::vector<std::size_t>{ 1, 8 };
+    opt.batch_sizes = std::vector<std::size_t>{ 1, 10 };
+    opt.timing.iterations = 2;
+
+    std::vector<std::size_t> counts(opt.num_items);
+    auto output = eztimer::time_pipeline<double>(
+        [](std::size_t i) -> double { return i; },
+        stages,
+        [&](const double& x, std::size_t i) -> void {
+            EXPECT_EQ(x, (i + 1.0) * 2 - 1);
+            ++counts[i];
+        },
+        opt
+    );
+
+    const std::size_t nconfigs = 4;
+    const std::size_t nruns = nconfigs * (opt.timing.iterations + opt.timing.burn_in);
+    for (auto c : counts) {
+        EXPECT_EQ(c, nruns);
+    }
+
+    ASSERT_EQ(output.configurations.size(), nconfigs);
+    EXPECT_EQ(output.configurations[0].queue_depth, 1);
+    EXPECT_EQ(output.configurations[0].batch_size, 1);
+    EXPECT_EQ(output.configurations[3].queue_depth, 8);
+    EXPECT_EQ(output.configurations[3].batch_size, 10);
+
+    ASSERT_EQ(output.timings.size(), nconfigs);
+    ASSERT_EQ(output.stages.size(), nconfigs);
+    for (std::size_t c = 0; c < nconfigs; ++c) {
+        EXPECT_EQ(output.timings[c].times.size(), opt.timing.iterations);
+        EXPECT_GT(output.throughput[c], 0);
+        EXPECT_LE(output.throughput[c], output.throughput[output.best]);
+        EXPECT_EQ(output.bottleneck[c], 1);
+
+        ASSERT_EQ(output.stages[c].size(), stages.size());
+        EXPECT_EQ(output.stages[c][0].occupancy, 0);
+        EXPECT_GE(output.stages[c][1].service_time, 1e-4);
+        for (const auto& stat : output.stages[c]) {
+            EXPECT_GE(stat.busy_fraction, 0);
+            EXPECT_LE(stat.busy_fraction, 1);
+            EXPECT_LE(stat.occupancy, output.configurations[c].queue_depth);
+        }
+    }
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/planning.hpp"
+#include "utils.hpp"
+
+#include <random>
+#include <limits>
+#include <thread>
+
+TEST(Planning, Unpaired) {
+    std::vector<eztimer::Timings> pilot { lognormal_timings(1000, 1e-3, 0.05, 1), lognormal_timings(1000, 1e-3, 0.01, 2) };
+    eztimer::PlanningOptions opt;
+    auto plan = eztimer::plan_iterations(pilot, opt);
+
+    ASSERT_EQ(plan.log_sd.size(), 2);
+    EXPECT_NEAR(plan.log_sd[0], 0.05, 0.005);
+    EXPECT_NEAR(plan.log_sd[1], 0.01, 0.001);
+
+    // Closed-form normal approximation is 2 * (z_a + z_b)^2 * (sd / log(1.02))^2 ~= 100.
+    EXPECT_GT(plan.required[0], 90);
+    EXPECT_LT(plan.required[0], 115);
+    EXPECT_LT(plan.required[1], plan.required[0]);
+    EXPECT_EQ(plan.iterations, plan.required[0]);
+    EXPECT_NEAR(plan.estimated_time.count(), 2e-3 * plan.iterations, 2e-4 * plan.iterations);
+    EXPECT_TRUE(plan.feasible);
+    EXPECT_TRUE(plan.warning.empty());
+
+    // Larger effects need fewer iterations.
+    opt.effect = 0.1;
+    auto plan2 = eztimer::plan_iterations(pilot, opt);
+    EXPECT_LT(plan2.iterations, plan.iterations);
+    EXPECT_GE(plan2.iterations, 2);
+
+    // More power needs more iterations.
+    opt.effect = 0.02;
+    opt.power = 0.95;
+    auto plan3 = eztimer::plan_iterations(pilot, opt);
+    EXPECT_GT(plan3.iterations, plan.iterations);
+}
+
+TEST(Planning, Paired) {
+    auto base = lognormal_timings(1000, 1e-3, 0.05, 1);
+    auto other = base;
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> noise(0, 0.01);
+    for (auto& t : other.times) {
+        t *= std::exp(noise(rng));
+    }
+
+    eztimer::PlanningOptions opt;
+    opt.baseline = 0;
+    auto plan = eztimer::plan_iterations(std::vector<eztimer::Timings>{ base, other }, opt);
+    EXPECT_EQ(plan.required[0], 0);
+    EXPECT_EQ(plan.log_sd[0], 0);
+    EXPECT_NEAR(plan.log_sd[1], 0.01, 0.001);
+
+    // Pairing cancels out the shared noise, so fewer iterations are needed.
+    opt.baseline.reset();
+    auto unpaired = eztimer::plan_iterations(std::vector<eztimer::Timings>{ base, other }, opt);
+    EXPECT_LT(plan.iterations, unpaired.iterations);
+
+    opt.baseline = 2;
+    EXPECT_ANY_THROW(eztimer::plan_iterations(std::vector<eztimer::Timings>{ base, other }, opt));
+}
+
+TEST(Planning, Infeasible) {
+    std::vector<eztimer::Timings> pilot { lognormal_timings(100, 1, 0.1, 1) };
+    eztimer::PlanningOptions opt;
+    opt.timing.max_time_total = std::chrono::duration<double>(10);
+    auto plan = eztimer::plan_iterations(pilot, opt);
+    EXPECT_FALSE(plan.feasible);
+    EXPECT_NE(plan.warning.find("max_time_total"), std::string::npos);
+
+    opt.timing.max_time_total.reset();
+    opt.timing.max_time_per_function = std::chrono::duration<double>(10);
+    auto plan2 = eztimer::plan_iterations(pilot, opt);
+    EXPECT_FALSE(plan2.feasible);
+    EXPECT_NE(plan2.warning.find("max_time_per_function"), std::string::npos);
+
+    std::vector<eztimer::Timings> tiny { lognormal_timings(1, 1, 0.1, 1) };
+    EXPECT_ANY_THROW(eztimer::plan_iterations(tiny, opt));
+}
+
+TEST(Planning, Invalid) {
+    // Zero durations from a coarse clock should give a clear error instead of a NaN standard deviation.
+    auto zeroed = lognormal_timings(100, 1e-3, 0.1, 1);
+    zeroed.times[10] = std::chrono::duration<double>(0);
+    eztimer::PlanningOptions opt;
+    std::vector<eztimer::Timings> pilot { zeroed };
+    EXPECT_ANY_THROW(eztimer::plan_iterations(pilot, opt));
+
+    opt.baseline = 0;
+    pilot.push_back(lognormal_timings(100, 1e-3, 0.1, 2));
+    EXPECT_ANY_THROW(eztimer::plan_iterations(pilot, opt));
+
+    // Effects that are too small to be detected in a representable number of iterations.
+    EXPECT_ANY_THROW(eztimer::internal::required_sample_size(1, 1e-12, 0.05, 0.8, false));
+    EXPECT_ANY_THROW(eztimer::internal::required_sample_size(std::numeric_limits<double>::infinity(), 0.02, 0.05, 0.8, false));
+    EXPECT_EQ(eztimer::internal::required_sample_size(0, 0.02, 0.05, 0.8, false), 2);
+}
+
+TEST(Planning, Run) {
+    std::vector<std::function<int()> > funs;
+    funs.emplace_back([]() -> int {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return 1;
+    });
+    funs.emplace_back([]() -> int {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        return 2;
+    });
+
+    eztimer::PlanningOptions opt;
+    opt.effect = 0.5;
+    opt.pilot.iterations = 5;
+    opt.run = true;
+    auto plan = eztimer::plan_iterations<int>(funs, [](const int&, std::size_t) -> void {}, opt);
+
+    ASSERT_EQ(plan.pilot.size(), 2);
+    EXPECT_EQ(plan.pilot[0].times.size(), 5);
+    EXPECT_GE(plan.iterations, 2);
+    ASSERT_EQ(plan.timings.size(), 2);
+    EXPECT_EQ(plan.timings[0].times.size(), static_cast<std::size_t>(plan.iterations));
+    EXPECT_EQ(plan.timings[1].times.size(), static_cast<std::size_t>(plan.iterations));
+}
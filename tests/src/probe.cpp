@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/probe.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+static eztimer::ProbeOptions small_options() {
+    eztimer::ProbeOptions opt;
+    opt.min_size = 4 << 10;
+    opt.max_size = 1 << 20;
+    opt.step = 2;
+    opt.loads = 1 << 14;
+    opt.repeats = 1;
+    opt.bandwidth_size = 1 << 20;
+    return opt;
+}
+
+TEST(Probe, LineCycle) {
+    std::mt19937_64 rng(42);
+    auto cycle = eztimer::internal::line_cycle(4096, 64, rng);
+    ASSERT_EQ(cycle.size(), 512);
+
+    // Every line is visited once, at its first element.
+    std::vector<int> visited(64);
+    std::size_t current = 0;
+    for (int i = 0; i < 64; ++i) {
+        EXPECT_EQ(current % 8, 0);
+        ++visited[current / 8];
+        current = cycle[current];
+    }
+    EXPECT_EQ(current, 0);
+    EXPECT_EQ(std::count(visited.begin(), visited.end(), 1), 64);
+}
+
+TEST(Probe, DetectCacheLevels) {
+    eztimer::MachineProfile profile;
+    const std::vector<double> latencies { 1, 1, 1, 1.1, 1.4, 2.5, 4, 4.1, 4.2, 4.3, 12, 40, 80, 85, 90 };
+    for (std::size_t i = 0; i < latencies.size(); ++i) {
+        profile.sizes.push_back(static_cast<std::size_t>(4096) << i);
+        profile.latencies.emplace_back(latencies[i] * 1e-9);
+    }
+
+    eztimer::internal::detect_cache_levels(profile, 1.5);
+    ASSERT_EQ(profile.cache_sizes.size(), 2);
+    EXPECT_EQ(profile.cache_sizes[0], 4096u << 3); // 1.4 is already on the way up.
+    EXPECT_EQ(profile.cache_sizes[1], 4096u << 9);
+    ASSERT_EQ(profile.cache_latencies.size(), 3);
+    EXPECT_DOUBLE_EQ(profile.cache_latencies[0].count(), 1e-9);
+    EXPECT_DOUBLE_EQ(profile.cache_latencies[1].count(), 4.1e-9);
+    EXPECT_DOUBLE_EQ(profile.cache_latencies[2].count(), 90e-9);
+
+    // Flat curves have no cache levels.
+    eztimer::MachineProfile flat;
+    flat.sizes = { 1, 2, 3 };
+    flat.latencies.resize(3, std::chrono::duration<double>(1));
+    eztimer::internal::detect_cache_levels(flat, 1.5);
+    EXPECT_TRUE(flat.cache_sizes.empty());
+    EXPECT_EQ(flat.cache_latencies.size(), 1);
+}
+
+TEST(Probe, Basic) {
+    auto profile = eztimer::probe_machine(small_options());
+    EXPECT_GT(profile.timer_overhead.count(), 0);
+    EXPECT_GT(profile.timer_resolution.count(), 0);
+    EXPECT_LE(profile.timer_resolution, profile.timer_overhead);
+
+    ASSERT_EQ(profile.sizes.size(), 9);
+    EXPECT_EQ(profile.sizes.front(), 4096);
+    EXPECT_EQ(profile.sizes.back(), 1 << 20);
+    ASSERT_EQ(profile.latencies.size(), 9);
+    for (auto lat : profile.latencies) {
+        EXPECT_GT(lat.count(), 0);
+    }
+    EXPECT_EQ(profile.cache_latencies.size(), profile.cache_sizes.size() + 1);
+
+    EXPECT_GT(profile.copy_bandwidth, 0);
+    EXPECT_GT(profile.scale_bandwidth, 0);
+    EXPECT_GT(profile.add_bandwidth, 0);
+    EXPECT_GT(profile.triad_bandwidth, 0);
+}
+
+TEST(Probe, ReadWrite) {
+    eztimer::MachineProfile profile;
+    profile.fingerprint = eztimer::machine_fingerprint();
+    profile.timer_resolution = std::chrono::duration<double>(1e-9);
+    profile.timer_overhead = std::chrono::duration<double>(2.5e-8);
+    profile.sizes = { 4096, 8192 };
+    profile.latencies = { std::chrono::duration<double>(1e-9), std::chrono::duration<double>(1.5e-9) };
+    profile.cache_sizes = { 4096 };
+    profile.cache_latencies = { std::chrono::duration<double>(1e-9), std::chrono::duration<double>(8e-8) };
+    profile.copy_bandwidth = 1e10;
+    profile.scale_bandwidth = 2e10;
+    profile.add_bandwidth = 3e10;
+    profile.triad_bandwidth = 4e10;
+
+    std::stringstream buffer;
+    eztimer::write_machine_profile(buffer, profile);
+    auto roundtrip = eztimer::read_machine_profile(buffer);
+
+    EXPECT_EQ(eztimer::fingerprint_id(roundtrip.fingerprint), eztimer::fingerprint_id(profile.fingerprint));
+    EXPECT_EQ(roundtrip.timer_resolution, profile.timer_resolution);
+    EXPECT_EQ(roundtrip.timer_overhead, profile.timer_overhead);
+    EXPECT_EQ(roundtrip.sizes, profile.sizes);
+    EXPECT_EQ(roundtrip.latencies, profile.latencies);
+    EXPECT_EQ(roundtrip.cache_sizes, profile.cache_sizes);
+    EXPECT_EQ(roundtrip.cache_latencies, profile.cache_latencies);
+    EXPECT_EQ(roundtrip.copy_bandwidth, profile.copy_bandwidth);
+    EXPECT_EQ(roundtrip.triad_bandwidth, profile.triad_bandwidth);
+
+    std::stringstream invalid("latency\tfoo\n");
+    EXPECT_ANY_THROW(eztimer::read_machine_profile(invalid));
+}
+
+TEST(Probe, Cached) {
+    auto path = std::filesystem::temp_directory_path() / "eztimer-probe-test" / "profile.txt";
+    std::filesystem::remove_all(path.parent_path());
+
+    auto first = eztimer::cached_probe(path, small_options());
+    EXPECT_TRUE(std::filesystem::exists(path));
+
+    // Modifying the cache to check that it's being used.
+    auto modified = first;
+    modified.copy_bandwidth = 12345;
+    {
+        std::ofstream handle(path);
+        eztimer::write_machine_profile(handle, modified);
+    }
+    auto second = eztimer::cached_probe(path, small_options());
+    EXPECT_EQ(second.copy_bandwidth, 12345);
+
+    // Re-probing if the fingerprint doesn't match.
+    modified.fingerprint.hostname += "_other";
+    {
+        std::ofstream handle(path);
+        eztimer::write_machine_profile(handle, modified);
+    }
+    auto third = eztimer::cached_probe(path, small_options());
+    EXPECT_NE(third.copy_bandwidth, 12345);
+    EXPECT_EQ(third.fingerprint.hostname, first.fingerprint.hostname);
+
+    std::filesystem::remove_all(path.parent_path());
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/process.hpp"
+#include "eztimer/compare.hpp"
+
+TEST(Process, WallTime) {
+    std::vector<eztimer::Command> commands(2);
+    commands[0].arguments = std::vector<std::string>{ EZTIMER_TEST_CHILD, "1" };
+    commands[1].arguments = std::vector<std::string>{ EZTIMER_TEST_CHILD, "20" };
+
+    eztimer::ProcessOptions opt;
+    opt.timing.iterations = 5;
+    auto output = eztimer::time_processes(commands, opt);
+
+    ASSERT_EQ(output.timings.size(), 2);
+    ASSERT_EQ(output.runs.size(), 2);
+    for (std::size_t c = 0; c < 2; ++c) {
+        EXPECT_EQ(output.timings[c].times.size(), opt.timing.iterations);
+        ASSERT_EQ(output.runs[c].size(), opt.timing.iterations);
+        for (const auto& run : output.runs[c]) {
+            EXPECT_GT(run.max_rss, 0);
+            EXPECT_TRUE(run.reported.empty());
+        }
+    }
+
+    EXPECT_GT(output.timings[1].times.front().count(), 0.02);
+    auto comp = eztimer::compare_paired(output.timings[0], output.timings[1]);
+    EXPECT_EQ(comp.pairs, opt.timing.iterations);
+    EXPECT_GT(comp.ratio, 1);
+}
+
+TEST(Process, Reported) {
+    std::vector<eztimer::Command> commands(2);
+    commands[0].arguments = std::vector<std::string>{ EZTIMER_TEST_CHILD, "0", "foo", "0.5", "bar", "0.25" };
+    commands[1].arguments = std::vector<std::string>{ EZTIMER_TEST_CHILD, "0", "foo", "1.5", "foo", "0.5" };
+
+    eztimer::ProcessOptions opt;
+    opt.timing.iterations = 3;
+    opt.use_reported = true;
+    auto output = eztimer::time_processes(commands, opt);
+
+    EXPECT_DOUBLE_EQ(output.timings[0].mean.count(), 0.75);
+    EXPECT_DOUBLE_EQ(output.timings[1].mean.count(), 2);
+    EXPECT_EQ(output.timings[0].sd.count(), 0);
+    ASSERT_EQ(output.runs[0][0].reported.size(), 2);
+    EXPECT_EQ(output.runs[0][0].reported[0].first, "foo");
+    EXPECT_EQ(output.runs[0][0].reported[1].first, "bar");
+
+    auto foo0 = eztimer::reported_timings(output, 0, "foo");
+    EXPECT_EQ(foo0.times.size(), 3);
+    EXPECT_DOUBLE_EQ(foo0.mean.count(), 0.5);
+    EXPECT_EQ(foo0.iterations, output.timings[0].iterations);
+
+    auto foo1 = eztimer::reported_timings(output, 1, "foo");
+    EXPECT_DOUBLE_EQ(foo1.mean.count(), 2);
+
+    auto bar1 = eztimer::reported_timings(output, 1, "bar");
+    EXPECT_TRUE(bar1.times.empty());
+
+    // Fails if nothing was reported.
+    commands[0].arguments.resize(2);
+    EXPECT_ANY_THROW(eztimer::time_processes(commands, opt));
+}
+
+TEST(Process, Environment) {
+    std::vector<eztimer::Command> commands(1);
+    commands[0].arguments = std::vector<std::string>{ EZTIMER_TEST_CHILD, "0" };
+    commands[0].environment.emplace_back("EZTIMER_TEST_FAIL", "1");
+
+    eztimer::ProcessOptions opt;
+    opt.timing.iterations = 1;
+    EXPECT_ANY_THROW(eztimer::time_processes(commands, opt));
+
+    commands[0].environment.back().second = "0";
+    EXPECT_NO_THROW(eztimer::time_processes(commands, opt));
+
+    commands[0].arguments[0] = "./this_program_does_not_exist";
+    EXPECT_ANY_THROW(eztimer::time_processes(commands, opt));
+}
+
+TEST(Process, NoParent) {
+    // Not started by time_processes(), so nothing happens.
+    EXPECT_FALSE(eztimer::report_to_parent("foo", std::chrono::duration<double>(1)));
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/roofline.hpp"
+#include "utils.hpp"
+
+#include <sstream>
+
+TEST(Roofline, Basic) {
+    eztimer::RooflineOptions opt;
+    opt.peak_flops = 1e10;
+    opt.peak_bandwidth = 1e9;
+
+    std::vector<eztimer::Timings> timings { mean_timings(1e-3), mean_timings(2e-3), mean_timings(1e-3) };
+    std::vector<eztimer::RooflineWork> work(3);
+    work[0].flops = 1e6; // intensity of 1, attainable of 1e9.
+    work[0].bytes = 1e6;
+    work[1].flops = 1e7; // intensity of 100, attainable of 1e10.
+    work[1].bytes = 1e5;
+    work[2].flops = 1e6; // no memory traffic.
+
+    auto roof = eztimer::roofline(timings, work, opt);
+    EXPECT_EQ(roof.peak_flops, 1e10);
+    EXPECT_EQ(roof.peak_bandwidth, 1e9);
+    EXPECT_DOUBLE_EQ(roof.ridge, 10);
+    ASSERT_EQ(roof.points.size(), 3);
+
+    const auto& first = roof.points[0];
+    EXPECT_DOUBLE_EQ(first.intensity, 1);
+    EXPECT_DOUBLE_EQ(first.attained, 1e9);
+    EXPECT_DOUBLE_EQ(first.bandwidth, 1e9);
+    EXPECT_DOUBLE_EQ(first.attainable, 1e9);
+    EXPECT_DOUBLE_EQ(first.efficiency, 1);
+    EXPECT_TRUE(first.memory_bound);
+
+    const auto& second = roof.points[1];
+    EXPECT_DOUBLE_EQ(second.intensity, 100);
+    EXPECT_DOUBLE_EQ(second.attained, 5e9);
+    EXPECT_DOUBLE_EQ(second.attainable, 1e10);
+    EXPECT_DOUBLE_EQ(second.efficiency, 0.5);
+    EXPECT_FALSE(second.memory_bound);
+
+    const auto& third = roof.points[2];
+    EXPECT_TRUE(std::isinf(third.intensity));
+    EXPECT_DOUBLE_EQ(third.attainable, 1e10);
+    EXPECT_FALSE(third.memory_bound);
+}
+
+TEST(Roofline, Profile) {
+    eztimer::RooflineOptions opt;
+    opt.peak_flops = 1e10;
+    eztimer::MachineProfile profile;
+    profile.triad_bandwidth = 2e9;
+    opt.profile = profile;
+
+    auto roof = eztimer::roofline({ mean_timings(1) }, { eztimer::RooflineWork{ 1, 1 } }, opt);
+    EXPECT_EQ(roof.peak_bandwidth, 2e9);
+    EXPECT_DOUBLE_EQ(roof.ridge, 5);
+}
+
+TEST(Roofline, Measured) {
+    EXPECT_GT(eztimer::measure_peak_flops(1 << 20, 2), 0);
+
+    eztimer::RooflineOptions opt;
+    opt.operations = 1 << 20;
+    opt.repeats = 2;
+    opt.probe.bandwidth_size = 1 << 20;
+    opt.probe.repeats = 1;
+    auto roof = eztimer::roofline({ mean_timings(1) }, { eztimer::RooflineWork{ 1, 1 } }, opt);
+    EXPECT_GT(roof.peak_flops, 0);
+    EXPECT_GT(roof.peak_bandwidth, 0);
+    EXPECT_GT(roof.ridge, 0);
+}
+
+TEST(Roofline, Errors) {
+    eztimer::RooflineOptions opt;
+    opt.peak_flops = 1e10;
+    opt.peak_bandwidth = 1e9;
+    EXPECT_ANY_THROW(eztimer::roofline({ mean_timings(1) }, {}, opt));
+    EXPECT_ANY_THROW(eztimer::roofline({ mean_timings(1) }, { eztimer::RooflineWork{ -1, 1 } }, opt));
+
+    opt.peak_bandwidth = 0;
+    EXPECT_ANY_THROW(eztimer::roofline({ mean_timings(1) }, { eztimer::RooflineWork{ 1, 1 } }, opt));
+}
+
+TEST(Roofline, Export) {
+    eztimer::RooflineOptions opt;
+    opt.peak_flops = 1e10;
+    opt.peak_bandwidth = 1e9;
+    auto roof = eztimer::roofline(
+        { mean_timings(1e-3), mean_timings(1e-3) },
+        { eztimer::RooflineWork{ 1e6, 1e6 }, eztimer::RooflineWork{ 1e6, 0 } },
+        opt
+    );
+
+    {
+        std::stringstream csv;
+        eztimer::write_roofline_csv(csv, roof, { "axpy, blocked", "dot" });
+        std::string line;
+        std::getline(csv, line);
+        EXPECT_EQ(line, "name,flops,bytes,intensity,attained,bandwidth,attainable,efficiency,bound");
+        std::getline(csv, line);
+        EXPECT_EQ(line, "\"axpy, blocked\",1000000,1000000,1,1000000000,1000000000,1000000000,1,memory");
+        std::getline(csv, line);
+        EXPECT_EQ(line.rfind("dot,1000000,0,inf,", 0), 0);
+        EXPECT_EQ(line.substr(line.size() - 8), ",compute");
+    }
+
+    {
+        std::stringstream csv;
+        eztimer::write_roofline_csv(csv, roof);
+        std::string line;
+        std::getline(csv, line);
+        std::getline(csv, line);
+        EXPECT_EQ(line.rfind("0,", 0), 0);
+    }
+
+    {
+        std::stringstream svg;
+        eztimer::write_roofline_svg(svg, roof, { "a<b", "dot" });
+        auto contents = svg.str();
+        EXPECT_EQ(contents.rfind("<svg", 0), 0);
+        EXPECT_NE(contents.find("</svg>"), std::string::npos);
+        EXPECT_NE(contents.find("<polyline"), std::string::npos);
+        EXPECT_NE(contents.find("a&lt;b"), std::string::npos);
+        EXPECT_EQ(contents.find("a<b"), std::string::npos);
+
+        // Points without memory traffic are not drawn.
+        EXPECT_EQ(contents.find(">dot<"), std::string::npos);
+    }
+
+    std::stringstream dummy;
+    EXPECT_ANY_THROW(eztimer::write_roofline_csv(dummy, roof, { "only_one" }));
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/soak.hpp"
+
+#include <thread>
+#include <algorithm>
+
+TEST(Soak, PageHinkley) {
+    eztimer::internal::PageHinkley detector(0.01, 0.1);
+    eztimer::internal::PageHinkley::Change change;
+
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_FALSE(detector.add(i % 2 ? 0.005 : -0.005, i, change));
+    }
+
+    bool found = false;
+    for (int i = 0; i < 10 && !found; ++i) {
+        found = detector.add(0.2, 20 + i, change);
+    }
+    ASSERT_TRUE(found);
+    EXPECT_EQ(change.before_count, 20);
+    EXPECT_EQ(change.label, 19);
+    EXPECT_NEAR(change.before_total, 0, 1e-8);
+    EXPECT_GE(change.after_count, 1);
+    EXPECT_NEAR(change.after_total, 0.2 * change.after_count, 1e-8);
+    EXPECT_EQ(detector.count(), 0);
+
+    // Detects decreases after the reset.
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_FALSE(detector.add(0.2, 100 + i, change));
+    }
+    found = false;
+    for (int i = 0; i < 10 && !found; ++i) {
+        found = detector.add(-0.1, 200 + i, change);
+    }
+    ASSERT_TRUE(found);
+    EXPECT_EQ(change.before_count, 10);
+    EXPECT_EQ(change.label, 109);
+    EXPECT_NEAR(change.before_total, 2, 1e-8);
+    EXPECT_NEAR(change.after_total, -0.1 * change.after_count, 1e-8);
+}
+
+TEST(Soak, MergeWindows) {
+    std::vector<eztimer::SoakWindow> windows(5);
+    const std::vector<double> means { 1, 2, 3, 4, 5 };
+    for (std::size_t w = 0; w < windows.size(); ++w) {
+        auto& current = windows[w];
+        current.start = std::chrono::duration<double>(w);
+        current.end = std::chrono::duration<double>(w + 1);
+        current.count = 2;
+        current.mean = std::chrono::duration<double>(means[w]);
+        current.sd = std::chrono::duration<double>(std::sqrt(0.5)); // i.e., each window is {mean - 0.5, mean + 0.5}.
+        current.min = std::chrono::duration<double>(means[w] - 0.5);
+        current.max = std::chrono::duration<double>(means[w] + 0.5);
+    }
+
+    eztimer::internal::compact_windows(windows);
+    ASSERT_EQ(windows.size(), 3);
+    EXPECT_EQ(windows[0].start.count(), 0);
+    EXPECT_EQ(windows[0].end.count(), 2);
+    EXPECT_EQ(windows[0].count, 4);
+    EXPECT_DOUBLE_EQ(windows[0].mean.count(), 1.5);
+    EXPECT_DOUBLE_EQ(windows[0].sd.count(), std::sqrt(2.0 / 3)); // sd of {0.5, 1.5, 1.5, 2.5}.
+    EXPECT_EQ(windows[0].min.count(), 0.5);
+    EXPECT_EQ(windows[0].max.count(), 2.5);
+    EXPECT_EQ(windows[2].count, 2);
+    EXPECT_EQ(windows[2].mean.count(), 5);
+}
+
+TEST(Soak, Basic) {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::function<int()> > funs;
+    funs.emplace_back([&]() -> int {
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::this_thread::sleep_for(std::chrono::milliseconds(elapsed.count() < 0.4 ? 1 : 3));
+        return 1;
+    });
+
+    eztimer::SoakOptions opt;
+    opt.duration = std::chrono::duration<double>(0.8);
+    opt.window_iterations = 10;
+    opt.max_windows = 8;
+    opt.drift_tolerance = 0.05; // reducing false alarms from sleep jitter.
+    opt.drift_threshold = 0.5;
+    auto res = eztimer::soak<int>(funs, [](const int&, std::size_t) -> void {}, opt);
+
+    ASSERT_EQ(res.size(), 1);
+    const auto& curres = res[0];
+    EXPECT_LE(curres.windows.size(), 8);
+    EXPECT_GT(curres.windows.size(), 1);
+    EXPECT_GT(curres.count, 0);
+
+    std::size_t total = 0;
+    for (std::size_t w = 0; w < curres.windows.size(); ++w) {
+        total += curres.windows[w].count;
+        if (w) {
+            EXPECT_GE(curres.windows[w].start, curres.windows[w - 1].end);
+        }
+    }
+    EXPECT_EQ(total, curres.count);
+
+    ASSERT_FALSE(curres.drifts.empty());
+    auto it = std::max_element(curres.drifts.begin(), curres.drifts.end(), [](const eztimer::Drift& l, const eztimer::Drift& r) -> bool { return l.relative < r.relative; });
+    const auto& drift = *it;
+    EXPECT_GT(drift.relative, 1); // i.e., ~3 ms versus ~1 ms.
+    EXPECT_NEAR(drift.relative, drift.after / drift.before - 1, 1e-8);
+    EXPECT_GT(drift.when.count(), 0.2);
+    EXPECT_LT(drift.when.count(), 0.6);
+    EXPECT_GE(drift.detected, drift.when);
+    EXPECT_GT(drift.after, drift.before);
+}
+
+TEST(Soak, MeanLogTime) {
+    typedef std::chrono::duration<double> Duration;
+    auto res = eztimer::internal::mean_log_time({ Duration(0), Duration(std::exp(1.0)), Duration(-1), Duration(std::exp(3.0)) });
+    ASSERT_TRUE(res.has_value());
+    EXPECT_DOUBLE_EQ(*res, 2);
+    EXPECT_FALSE(eztimer::internal::mean_log_time({ Duration(0), Duration(0) }).has_value());
+    EXPECT_FALSE(eztimer::internal::mean_log_time({}).has_value());
+}
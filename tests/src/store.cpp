@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/store.hpp"
+#include "utils.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+class StoreTest : public ::testing::Test {
+protected:
+    std::filesystem::path dir;
+
+    void SetUp() {
+        dir = std::filesystem::temp_directory_path() / ("eztimer-store-" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::remove_all(dir);
+    }
+
+    void TearDown() {
+        std::filesystem::remove_all(dir);
+    }
+};
+
+TEST_F(StoreTest, Basic) {
+    {
+        eztimer::ResultsStore store(dir);
+        EXPECT_TRUE(store.runs().empty());
+        auto rec = store.append("foo", "abc", "machine1", mock_timings({ 1, 2, 3 }), 1000);
+        EXPECT_EQ(rec.count, 3);
+        EXPECT_EQ(rec.mean.count(), 2);
+        store.append(std::vector<std::string>{ "foo", "bar" }, "def", "machine1", std::vector<eztimer::Timings>{ mock_timings({ 4, 5 }), mock_timings({ 6 }) }, 2000);
+        EXPECT_EQ(store.runs().size(), 3);
+    }
+
+    // Reopening the store.
+    eztimer::ResultsStore store(dir);
+    const auto& runs = store.runs();
+    ASSERT_EQ(runs.size(), 3);
+    EXPECT_EQ(runs[0].benchmark, "foo");
+    EXPECT_EQ(runs[0].commit, "abc");
+    EXPECT_EQ(runs[0].fingerprint, "machine1");
+    EXPECT_EQ(runs[0].timestamp, 1000);
+    EXPECT_EQ(runs[1].timestamp, 2000);
+    EXPECT_EQ(runs[2].benchmark, "bar");
+    EXPECT_EQ(runs[2].mean.count(), 6);
+
+    auto loaded = store.load(runs[1]);
+    ASSERT_EQ(loaded.times.size(), 2);
+    EXPECT_EQ(loaded.times[0].count(), 4);
+    EXPECT_EQ(loaded.times[1].count(), 5);
+    EXPECT_EQ(loaded.iterations, std::vector<int>({ 0, 1 }));
+    EXPECT_EQ(loaded.mean.count(), 4.5);
+
+    EXPECT_EQ(store.benchmarks(), std::vector<std::string>({ "bar", "foo" }));
+
+    eztimer::StoreQuery query;
+    query.benchmark = "foo";
+    EXPECT_EQ(store.query(query).size(), 2);
+    query.commit = "def";
+    auto hits = store.query(query);
+    ASSERT_EQ(hits.size(), 1);
+    EXPECT_EQ(store.load(hits[0]).times.size(), 2);
+    query.fingerprint = "machine2";
+    EXPECT_TRUE(store.query(query).empty());
+
+    // Appends after reopening go to the end.
+    store.append("bar", "ghi", "machine2", mock_timings({ 7, 8, 9 }));
+    EXPECT_GT(store.runs().back().timestamp, 2000);
+    EXPECT_EQ(store.load(store.runs().back()).times.back().count(), 9);
+    EXPECT_EQ(store.load(store.runs()[0]).times.back().count(), 3);
+}
+
+TEST_F(StoreTest, Invalid) {
+    std::filesystem::create_directories(dir);
+    {
+        std::ofstream handle(dir / "index.bin");
+        handle << "foobar!!";
+    }
+    EXPECT_ANY_THROW(eztimer::ResultsStore store(dir));
+
+    eztimer::ResultsStore store(dir / "sub");
+    EXPECT_ANY_THROW(store.append(std::vector<std::string>{ "foo" }, "abc", "", std::vector<eztimer::Timings>{}));
+    EXPECT_ANY_THROW(eztimer::analyze_history(store, eztimer::StoreQuery()));
+}
+
+TEST_F(StoreTest, Truncated) {
+    {
+        eztimer::ResultsStore store(dir);
+        store.append("foo", "abc", "machine1", mock_timings({ 1, 2, 3 }), 1000);
+        store.append("bar", "abc", "machine1", mock_timings({ 4, 5 }), 1000);
+    }
+
+    // Mimicking an interrupted append of the index.
+    const auto index = dir / "index.bin";
+    const auto full = std::filesystem::file_size(index);
+    std::filesystem::resize_file(index, full - 5);
+
+    {
+        eztimer::ResultsStore store(dir);
+        ASSERT_EQ(store.runs().size(), 1);
+        EXPECT_EQ(store.runs()[0].benchmark, "foo");
+        store.append("baz", "def", "machine1", mock_timings({ 6 }), 2000);
+    }
+
+    eztimer::ResultsStore store(dir);
+    const auto& runs = store.runs();
+    ASSERT_EQ(runs.size(), 2);
+    EXPECT_EQ(runs[0].benchmark, "foo");
+    EXPECT_EQ(runs[1].benchmark, "baz");
+    EXPECT_EQ(store.load(runs[1]).times.back().count(), 6);
+}
+
+TEST_F(StoreTest, Corrupt) {
+    {
+        eztimer::ResultsStore store(dir);
+        store.append("foo", "abc", "machine1", mock_timings({ 1, 2, 3 }), 1000);
+    }
+
+    // Overwriting the data offset at the end of the record.
+    const auto index = dir / "index.bin";
+    const auto full = std::filesystem::file_size(index);
+    {
+        std::fstream handle(index, std::ios::binary | std::ios::in | std::ios::out);
+        handle.seekp(full - 8);
+        const std::uint64_t garbage = 1000000;
+        handle.write(reinterpret_cast<const char*>(&garbage), sizeof(garbage));
+    }
+    EXPECT_ANY_THROW(eztimer::ResultsStore store(dir));
+}
+
+TEST_F(StoreTest, CorruptData) {
+    eztimer::RunRecord record;
+    {
+        eztimer::ResultsStore store(dir);
+        record = store.append("foo", "abc", "machine1", mock_timings({ 1, 2, 3 }), 1000);
+    }
+
+    // Overwriting the number of timings or iterations at the start of the data for the record.
+    const auto data = dir / "data.bin";
+    auto overwrite = [&](std::uint64_t position, std::uint64_t value) -> void {
+        std::fstream handle(data, std::ios::binary | std::ios::in | std::ios::out);
+        handle.seekp(position);
+        handle.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    overwrite(record.offset, 1000000000000);
+    {
+        eztimer::ResultsStore store(dir);
+        EXPECT_THROW(store.load(store.runs().front()), std::runtime_error);
+    }
+
+    overwrite(record.offset, 3);
+    overwrite(record.offset + 8, 2);
+    {
+        eztimer::ResultsStore store(dir);
+        EXPECT_THROW(store.load(store.runs().front()), std::runtime_error);
+    }
+
+    overwrite(record.offset + 8, 3);
+    {
+        eztimer::ResultsStore store(dir);
+        EXPECT_EQ(store.load(store.runs().front()).times.size(), 3);
+    }
+}
+
+TEST_F(StoreTest, History) {
+    eztimer::ResultsStore store(dir);
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> noise(0, 0.005);
+    for (int r = 0; r < 30; ++r) {
+        double base = (r < 12 ? 1 : (r < 22 ? 1.1 : 0.95));
+        store.append("foo", "commit" + std::to_string(r), "machine1", mock_timings({ base * std::exp(noise(rng)) }), 1000 + r);
+        store.append("foo", "commit" + std::to_string(r), "machine2", mock_timings({ 2 * std::exp(noise(rng)) }), 1000 + r);
+    }
+
+    eztimer::StoreQuery query;
+    query.benchmark = "foo";
+    query.fingerprint = "machine1";
+    auto history = eztimer::analyze_history(store, query);
+    EXPECT_EQ(history.runs.size(), 30);
+    ASSERT_EQ(history.changes.size(), 2);
+    EXPECT_EQ(history.changes[0].run, 12);
+    EXPECT_NEAR(history.changes[0].relative, 0.1, 0.01);
+    EXPECT_NEAR(history.changes[0].before.count(), 1, 0.01);
+    EXPECT_EQ(history.changes[1].run, 22);
+    EXPECT_NEAR(history.changes[1].relative, 0.95 / 1.1 - 1, 0.01);
+    EXPECT_EQ(history.runs[history.changes[1].run].commit, "commit22");
+
+    // No changes on a stable machine.
+    query.fingerprint = "machine2";
+    auto stable = eztimer::analyze_history(store, query);
+    EXPECT_TRUE(stable.changes.empty());
+
+    // Small shifts are ignored.
+    eztimer::HistoryOptions hopt;
+    hopt.min_relative = 0.12;
+    query.fingerprint = "machine1";
+    auto filtered = eztimer::analyze_history(store, query, hopt);
+    ASSERT_EQ(filtered.changes.size(), 1);
+    EXPECT_EQ(filtered.changes[0].run, 22);
+}
+
+TEST_F(StoreTest, HistoryZeroMeans) {
+    eztimer::ResultsStore store(dir);
+    for (int r = 0; r < 10; ++r) {
+        store.append("foo", "commit" + std::to_string(r), "machine1", mock_timings({ r < 5 ? 0.0 : 1e-3 }), 1000 + r);
+    }
+
+    eztimer::StoreQuery query;
+    query.benchmark = "foo";
+    auto history = eztimer::analyze_history(store, query);
+    ASSERT_EQ(history.changes.size(), 1);
+    EXPECT_EQ(history.changes[0].run, 5);
+    EXPECT_GT(history.changes[0].before.count(), 0);
+    EXPECT_TRUE(std::isfinite(history.changes[0].relative));
+}
+
+TEST_F(StoreTest, Profile) {
+    eztimer::ResultsStore store(dir);
+    eztimer::MachineProfile profile;
+    profile.fingerprint.hostname = "foo";
+    profile.fingerprint.cpus = 8;
+    profile.copy_bandwidth = 1e10;
+    const auto id = eztimer::fingerprint_id(profile.fingerprint);
+    EXPECT_FALSE(store.profile(id).has_value());
+
+    store.save_profile(profile);
+    auto loaded = store.profile(id);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->fingerprint.hostname, "foo");
+    EXPECT_EQ(loaded->copy_bandwidth, 1e10);
+
+    // Still available after reopening.
+    eztimer::ResultsStore reopened(dir);
+    EXPECT_TRUE(reopened.profile(id).has_value());
+}
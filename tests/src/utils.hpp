@@ -0,0 +1,121 @@
+#ifndef EZTIMER_TEST_UTILS_HPP
+#define EZTIMER_TEST_UTILS_HPP
+
+#include "eztimer/eztimer.hpp"
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <random>
+
+// Shared factories for mock timings in the tests. All of them fill in the
+// summary statistics with compute_statistics().
+
+// Timings with the specified times. Iterations are numbered sequentially if
+// not supplied, which pairs runs by position in compare_paired().
+inline eztimer::Timings mock_timings(const std::vector<double>& times, std::vector<int> iterations = {}) {
+    eztimer::Timings output;
+    output.times.reserve(times.size());
+    for (auto t : times) {
+        output.times.emplace_back(t);
+    }
+    if (iterations.empty()) {
+        for (std::size_t i = 0; i < times.size(); ++i) {
+            iterations.push_back(i);
+        }
+    }
+    output.iterations = std::move(iterations);
+    eztimer::compute_statistics(output);
+    return output;
+}
+
+// Timings with only the mean set, for functions that only use the summary.
+inline eztimer::Timings mean_timings(double seconds) {
+    eztimer::Timings output;
+    output.mean = std::chrono::duration<double>(seconds);
+    return output;
+}
+
+// Log-normally distributed times around 'mean'.
+inline eztimer::Timings lognormal_timings(std::size_t n, double mean, double log_sd, unsigned long long seed) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> noise(0, log_sd);
+    eztimer::Timings output;
+    output.times.reserve(n);
+    output.iterations.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        output.times.emplace_back(mean * std::exp(noise(rng)));
+        output.iterations.push_back(i);
+    }
+    eztimer::compute_statistics(output);
+    return output;
+}
+
+// Normally distributed times around 1 second, where a proportion 'tail_prob'
+// of calls take 'tail_time' instead.
+inline eztimer::Timings tailed_timings(std::size_t n, double tail_prob, double tail_time, unsigned long long seed) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> body(1, 0.05);
+    std::uniform_real_distribution<double> unif;
+    eztimer::Timings output;
+    for (std::size_t i = 0; i < n; ++i) {
+        output.times.emplace_back(unif(rng) < tail_prob ? tail_time : body(rng));
+    }
+    eztimer::compute_statistics(output);
+    return output;
+}
+
+// Mixture of log-normal modes at 'locations' with the specified 'weights'.
+inline eztimer::Timings mixture_timings(const std::vector<double>& locations, const std::vector<double>& weights, std::size_t n, unsigned long long seed = 69) {
+    std::mt19937_64 rng(seed);
+    std::discrete_distribution<int> choose(weights.begin(), weights.end());
+    std::normal_distribution<double> noise(0, 0.02);
+    eztimer::Timings output;
+    for (std::size_t i = 0; i < n; ++i) {
+        output.times.emplace_back(locations[choose(rng)] * std::exp(noise(rng)));
+    }
+    eztimer::compute_statistics(output);
+    return output;
+}
+
+// Uniformly distributed times with sequential iterations, CPUs and large
+// random counts for 'ncounters' counters.
+inline eztimer::Timings random_timings(std::size_t n, unsigned long long seed, std::size_t ncounters) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> dist(1e-6, 1e-3);
+    eztimer::Timings output;
+    output.counters.resize(ncounters);
+    for (std::size_t i = 0; i < n; ++i) {
+        output.times.emplace_back(dist(rng));
+        output.iterations.push_back(i * 2);
+        output.cpus.push_back(i % 4);
+        for (std::size_t c = 0; c < ncounters; ++c) {
+            output.counters[c].push_back(static_cast<long long>(rng() % 1000000) + (1ll << 40));
+        }
+    }
+    eztimer::compute_statistics(output);
+    return output;
+}
+
+// Times that depend linearly on the first two of four counters, with the
+// third counter unavailable and the fourth constant.
+inline eztimer::Timings counter_driven_timings(std::size_t n, unsigned long long seed = 1000) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> misses(0, 1000);
+    std::uniform_int_distribution<int> faults(0, 10);
+    std::normal_distribution<double> noise(0, 1e-7);
+
+    eztimer::Timings output;
+    output.counters.resize(4);
+    for (std::size_t i = 0; i < n; ++i) {
+        const int m = misses(rng), f = faults(rng);
+        output.times.emplace_back(1e-5 + 5e-8 * m + 2e-6 * f + noise(rng));
+        output.counters[0].push_back(m);
+        output.counters[1].push_back(f);
+        output.counters[3].push_back(3); // constant.
+    }
+    eztimer::compute_statistics(output);
+    return output;
+}
+
+#endif
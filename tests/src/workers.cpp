@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/workers.hpp"
+
+#include <thread>
+
+TEST(WorkerRegions, Basic) {
+    eztimer::WorkerRegions regions(3);
+    EXPECT_EQ(regions.num_workers(), 3);
+
+    regions.begin(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    regions.end(1);
+    regions.begin(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    regions.end(1);
+
+    EXPECT_EQ(regions.busy(0).count(), 0);
+    EXPECT_GE(regions.busy(1).count(), 0.01);
+    EXPECT_EQ(regions.busy(2).count(), 0);
+
+    regions.reset();
+    EXPECT_EQ(regions.busy(1).count(), 0);
+}
+
+TEST(WorkerRegions, Imbalance) {
+    const int nworkers = 2;
+    auto create = [](int first, int second) {
+        return [first, second](eztimer::WorkerRegions& regions) -> int {
+            std::thread t([&]() -> void {
+                regions.begin(1);
+                std::this_thread::sleep_for(std::chrono::milliseconds(second));
+                regions.end(1);
+            });
+            regions.begin(0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(first));
+            regions.end(0);
+            t.join();
+            return first + second;
+        };
+    };
+
+    std::vector<std::function<int(eztimer::WorkerRegions&)> > funs;
+    funs.push_back(create(10, 10));
+    funs.push_back(create(2, 20));
+
+    int setups = 0;
+    eztimer::Options opt;
+    opt.iterations = 3;
+    opt.setup = [&]() -> void { ++setups; };
+    auto output = eztimer::time_imbalance<int>(
+        funs,
+        [](const int& res, std::size_t i) -> void {
+            EXPECT_EQ(res, (i == 0 ? 20 : 22));
+        },
+        nworkers,
+        opt
+    );
+    EXPECT_EQ(setups, opt.iterations + opt.burn_in);
+
+    ASSERT_EQ(output.size(), 2);
+    for (const auto& curout : output) {
+        EXPECT_EQ(curout.timings.times.size(), opt.iterations);
+        EXPECT_EQ(curout.imbalance.size(), opt.iterations);
+        EXPECT_EQ(curout.critical_worker.size(), opt.iterations);
+        EXPECT_EQ(curout.idle_fraction.size(), opt.iterations);
+        for (auto i : curout.imbalance) {
+            EXPECT_GE(i, 1);
+        }
+        for (auto i : curout.idle_fraction) {
+            EXPECT_GE(i, 0);
+            EXPECT_LE(i, 1);
+        }
+    }
+
+    // Second function is heavily imbalanced, with the second worker on the critical path.
+    EXPECT_LT(output[0].mean_imbalance, output[1].mean_imbalance);
+    EXPECT_GT(output[1].mean_imbalance, 1.3);
+    EXPECT_GT(output[1].mean_idle_fraction, 0.2);
+    for (auto c : output[1].critical_worker) {
+        EXPECT_EQ(c, 1);
+    }
+}
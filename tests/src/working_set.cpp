@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include "eztimer/working_set.hpp"
+
+#include <numeric>
+
+static eztimer::WorkingSetCurve synthetic_curve(const std::vector<double>& costs) {
+    eztimer::WorkingSetCurve curve;
+    for (std::size_t i = 0; i < costs.size(); ++i) {
+        curve.sizes.push_back(static_cast<std::size_t>(512) << i);
+        curve.per_element.emplace_back(costs[i] * 1e-9);
+    }
+    return curve;
+}
+
+TEST(WorkingSet, FindCliffs) {
+    auto curve = synthetic_curve({ 1, 1, 1, 1, 2, 2, 2, 2, 6, 6, 6 });
+
+    eztimer::WorkingSetOptions opt;
+    eztimer::internal::find_working_set_cliffs(curve, opt);
+    ASSERT_EQ(curve.cliffs.size(), 2);
+    EXPECT_EQ(curve.cliffs[0].size, 512 << 3);
+    EXPECT_EQ(curve.cliffs[0].bytes, 8 * (512 << 3));
+    EXPECT_DOUBLE_EQ(curve.cliffs[0].before.count(), 1e-9);
+    EXPECT_DOUBLE_EQ(curve.cliffs[0].after.count(), 2e-9);
+    EXPECT_EQ(curve.cliffs[1].size, 512 << 7);
+    EXPECT_DOUBLE_EQ(curve.cliffs[1].before.count(), 2e-9);
+    EXPECT_DOUBLE_EQ(curve.cliffs[1].after.count(), 6e-9);
+
+    // No annotations without a profile.
+    for (const auto& cliff : curve.cliffs) {
+        EXPECT_FALSE(cliff.cache_level.has_value());
+        EXPECT_TRUE(cliff.annotation.empty());
+    }
+
+    // Flat curves have no cliffs.
+    auto flat = synthetic_curve({ 1, 1.1, 1, 1.05, 1 });
+    eztimer::internal::find_working_set_cliffs(flat, opt);
+    EXPECT_TRUE(flat.cliffs.empty());
+}
+
+TEST(WorkingSet, Annotation) {
+    auto curve = synthetic_curve({ 1, 1, 1, 1, 2, 2, 2, 2, 6, 6, 6 });
+
+    eztimer::WorkingSetOptions opt;
+    eztimer::MachineProfile profile;
+    profile.cache_sizes = { 32 << 10, 768 << 10 };
+    opt.profile = profile;
+
+    // First cliff is at 32 kB, matching L1; the second is at 512 kB, closest to L2.
+    eztimer::internal::find_working_set_cliffs(curve, opt);
+    ASSERT_EQ(curve.cliffs.size(), 2);
+    ASSERT_TRUE(curve.cliffs[0].cache_level.has_value());
+    EXPECT_EQ(*(curve.cliffs[0].cache_level), 0);
+    EXPECT_EQ(curve.cliffs[0].annotation, "L1");
+    ASSERT_TRUE(curve.cliffs[1].cache_level.has_value());
+    EXPECT_EQ(*(curve.cliffs[1].cache_level), 1);
+    EXPECT_EQ(curve.cliffs[1].annotation, "L2");
+
+    // Cliffs that are too far from any cache level are left unmatched.
+    opt.profile->cache_sizes = { 1 << 10, 16 << 20 };
+    eztimer::internal::find_working_set_cliffs(curve, opt);
+    ASSERT_EQ(curve.cliffs.size(), 2);
+    EXPECT_FALSE(curve.cliffs[0].cache_level.has_value());
+    EXPECT_TRUE(curve.cliffs[0].annotation.empty());
+    EXPECT_FALSE(curve.cliffs[1].cache_level.has_value());
+}
+
+TEST(WorkingSet, Basic) {
+    std::vector<std::size_t> created;
+    std::vector<std::function<std::function<double()>(std::size_t)> > factories;
+    for (int f = 0; f < 2; ++f) {
+        factories.push_back([&created, f](std::size_t n) -> std::function<double()> {
+            created.push_back(n);
+            auto buffer = std::make_shared<std::vector<double> >(n, f + 1);
+            return [buffer]() -> double { return std::accumulate(buffer->begin(), buffer->end(), 0.0); };
+        });
+    }
+
+    eztimer::WorkingSetOptions opt;
+    opt.min_size = 100;
+    opt.max_size = 1000;
+    opt.step = 3;
+    opt.timing.iterations = 3;
+
+    std::size_t checked = 0;
+    auto curves = eztimer::sweep_working_set<double>(
+        factories,
+        [&](const double& res, std::size_t i) -> void {
+            EXPECT_GT(res, 0);
+            EXPECT_EQ(static_cast<std::size_t>(res) % (i + 1), 0);
+            ++checked;
+        },
+        opt
+    );
+
+    const std::vector<std::size_t> expected { 100, 300, 900 };
+    EXPECT_EQ(created, std::vector<std::size_t>({ 100, 100, 300, 300, 900, 900 }));
+    EXPECT_GT(checked, 0);
+
+    ASSERT_EQ(curves.size(), 2);
+    for (const auto& curve : curves) {
+        EXPECT_EQ(curve.sizes, expected);
+        ASSERT_EQ(curve.timings.size(), 3);
+        ASSERT_EQ(curve.per_element.size(), 3);
+        for (std::size_t s = 0; s < expected.size(); ++s) {
+            EXPECT_EQ(curve.timings[s].times.size(), 3);
+            EXPECT_DOUBLE_EQ(curve.per_element[s].count(), curve.timings[s].mean.count() / expected[s]);
+        }
+    }
+}
+
+TEST(WorkingSet, SmallStep) {
+    std::vector<std::function<std::function<int()>(std::size_t)> > factories;
+    factories.push_back([](std::size_t n) -> std::function<int()> { return [n]() -> int { return n; }; });
+
+    eztimer::WorkingSetOptions opt;
+    opt.min_size = 1;
+    opt.max_size = 4;
+    opt.step = 1.1;
+    opt.timing.iterations = 1;
+
+    auto curves = eztimer::sweep_working_set<int>(factories, [](const int&, std::size_t) -> void {}, opt);
+    ASSERT_EQ(curves.size(), 1);
+    EXPECT_EQ(curves[0].sizes, std::vector<std::size_t>({ 1, 2, 3 }));
+}
@@ -0,0 +1,147 @@
+#include "eztimer/store.hpp"
+#include "eztimer/fingerprint.hpp"
+#include "eztimer/format.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <ctime>
+#include <sstream>
+#include <stdexcept>
+
+static void usage(std::ostream& out) {
+    out << "Usage: eztimer-history <store> <command> [options]\n"
+        << "       eztimer-history fingerprint\n"
+        << "\n"
+        << "Commands:\n"
+        << "  list                 List all benchmarks with their number of runs.\n"
+        << "  trend <benchmark>    Show the runs of a benchmark and any shifts in runtime.\n"
+        << "  changes              Show shifts in runtime for all benchmarks.\n"
+        << "  fingerprint          Print the identifier for the current machine, without a store.\n"
+        << "\n"
+        << "Options:\n"
+        << "  --fingerprint <id>   Only consider runs from this machine.\n"
+        << "  --commit <id>        Only consider runs from this commit.\n"
+        << "  --min-relative <x>   Ignore shifts smaller than this relative change (default 0.01).\n"
+        << "  --penalty <x>        Penalty for each change point (default 3 * log(runs)).\n";
+}
+
+static std::string format_time(long long timestamp) {
+    std::time_t raw = timestamp;
+    char buffer[32];
+    if (std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", std::gmtime(&raw)) == 0) {
+        return std::to_string(timestamp);
+    }
+    return buffer;
+}
+
+static void print_changes(const std::string& benchmark, const eztimer::History& history) {
+    for (const auto& change : history.changes) {
+        const auto& run = history.runs[change.run];
+        std::cout << benchmark << ": " << (change.relative > 0 ? "slowdown" : "speedup") << " of "
+            << std::fixed << std::setprecision(1) << std::abs(change.relative) * 100 << std::defaultfloat << "% at "
+            << format_time(run.timestamp) << " (commit " << run.commit << "), "
+            << eztimer::internal::format_duration(change.before.count(), 4) << " -> " << eztimer::internal::format_duration(change.after.count(), 4) << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> positional;
+    eztimer::StoreQuery filter;
+    eztimer::HistoryOptions hopt;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "-h" || arg == "--help") {
+                usage(std::cout);
+                return 0;
+            }
+
+            if (arg.rfind("--", 0) == 0) {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error("no value supplied for '" + arg + "'");
+                }
+                std::string value = argv[++i];
+                if (arg == "--fingerprint") {
+                    filter.fingerprint = value;
+                } else if (arg == "--commit") {
+                    filter.commit = value;
+                } else if (arg == "--min-relative") {
+                    hopt.min_relative = std::stod(value);
+                } else if (arg == "--penalty") {
+                    hopt.penalty = std::stod(value);
+                } else {
+                    throw std::runtime_error("unknown option '" + arg + "'");
+                }
+            } else {
+                positional.push_back(std::move(arg));
+            }
+        }
+
+        if (positional.size() == 1 && positional[0] == "fingerprint") {
+            std::cout << eztimer::fingerprint_id(eztimer::machine_fingerprint()) << std::endl;
+            return 0;
+        }
+        if (positional.size() < 2) {
+            usage(std::cerr);
+            return 1;
+        }
+
+        eztimer::ResultsStore store(positional[0]);
+        const auto& command = positional[1];
+
+        if (command == "list") {
+            std::map<std::string, std::size_t> counts;
+            for (const auto& run : store.query(filter)) {
+                ++counts[run.benchmark];
+            }
+            for (const auto& entry : counts) {
+                std::cout << entry.first << "\t" << entry.second << "\n";
+            }
+
+        } else if (command == "trend") {
+            if (positional.size() < 3) {
+                throw std::runtime_error("no benchmark supplied for 'trend'");
+            }
+            filter.benchmark = positional[2];
+            auto history = eztimer::analyze_history(store, filter, hopt);
+
+            std::size_t next_change = 0;
+            for (std::size_t r = 0; r < history.runs.size(); ++r) {
+                const auto& run = history.runs[r];
+                bool shifted = (next_change < history.changes.size() && history.changes[next_change].run == r);
+                if (shifted) {
+                    ++next_change;
+                }
+                std::cout << (shifted ? "* " : "  ") << format_time(run.timestamp) << "\t" << run.commit << "\t" << run.fingerprint << "\t"
+                    << eztimer::internal::format_duration(run.mean.count(), 4);
+                if (run.count > 1) {
+                    std::cout << " +/- " << eztimer::internal::format_duration(run.sd.count(), 4);
+                }
+                std::cout << "\t(n = " << run.count << ")\n";
+            }
+            if (!history.changes.empty()) {
+                std::cout << "\n";
+                print_changes(filter.benchmark, history);
+            }
+
+        } else if (command == "changes") {
+            for (const auto& benchmark : store.benchmarks()) {
+                filter.benchmark = benchmark;
+                print_changes(benchmark, eztimer::analyze_history(store, filter, hopt));
+            }
+
+        } else {
+            throw std::runtime_error("unknown command '" + command + "'");
+        }
+
+    } catch (std::exception& e) {
+        std::cerr << "eztimer-history: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}